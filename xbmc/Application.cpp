@@ -30,6 +30,7 @@
 #include "utils/Splash.h"
 #include "LangInfo.h"
 #include "utils/Screenshot.h"
+#include "utils/TraceProfiler.h"
 #include "Util.h"
 #include "URL.h"
 #include "guilib/TextureManager.h"
@@ -43,6 +44,7 @@
 #include "Autorun.h"
 #include "video/Bookmark.h"
 #include "video/VideoLibraryQueue.h"
+#include "dbwrappers/DatabaseQueryQueue.h"
 #include "guilib/GUIControlProfiler.h"
 #include "utils/LangCodeExpander.h"
 #include "GUIInfoManager.h"
@@ -1888,6 +1890,8 @@ float CApplication::GetDimScreenSaverLevel() const
 
 void CApplication::Render()
 {
+  TRACE_SCOPE("CApplication::Render");
+
   // do not render if we are stopped or in background
   if (m_bStop)
     return;
@@ -1941,7 +1945,10 @@ void CApplication::Render()
   // reset our info cache - we do this at the end of Render so that it is
   // fresh for the next process(), or after a windowclose animation (where process()
   // isn't called)
-  g_infoManager.ResetCache();
+  g_infoManager.ResetFrameCache();
+
+  if (CTraceProfiler::IsRunning())
+    CTraceProfiler::Instance().EndFrame();
 
   if (hasRendered)
   {
@@ -2384,6 +2391,12 @@ bool CApplication::OnAction(const CAction &action)
     CGUIControlProfiler::Instance().Start();
     return true;
   }
+  if (action.GetID() == ACTION_TRACEPROFILE_BEGIN)
+  {
+    CTraceProfiler::Instance().SetOutputFile(CSpecialProtocol::TranslatePath("special://home/traceprofile.json"));
+    CTraceProfiler::Instance().Start();
+    return true;
+  }
   if (action.GetID() == ACTION_SHOW_PLAYLIST)
   {
     int iPlaylist = g_playlistPlayer.GetCurrentPlaylist();
@@ -2704,6 +2717,7 @@ void CApplication::UnlockFrameMoveGuard()
 void CApplication::FrameMove(bool processEvents, bool processGUI)
 {
   MEASURE_FUNCTION;
+  TRACE_SCOPE("CApplication::FrameMove");
 
   if (processEvents)
   {
@@ -2920,6 +2934,9 @@ void CApplication::Stop(int exitCode)
     if (CVideoLibraryQueue::GetInstance().IsRunning())
       CVideoLibraryQueue::GetInstance().CancelAllJobs();
 
+    // interrupt library queries so that nobody keeps waiting on them
+    CDatabaseQueryQueue::GetInstance().CancelAllQueries();
+
     CServiceBroker::GetADSP().Deactivate();
     CApplicationMessenger::GetInstance().Cleanup();
 
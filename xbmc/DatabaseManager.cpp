@@ -19,6 +19,7 @@
  */
 
 #include "DatabaseManager.h"
+#include "dbwrappers/sqlitedataset.h"
 #include "utils/log.h"
 #include "addons/AddonDatabase.h"
 #include "view/ViewDatabase.h"
@@ -74,6 +75,9 @@ void CDatabaseManager::Deinitialize()
 {
   CSingleLock lock(m_section);
   m_dbStatus.clear();
+
+  // don't keep the previous profile's database files open
+  dbiplus::SqliteDatabase::closeIdleConnections();
 }
 
 bool CDatabaseManager::CanOpen(const std::string &name)
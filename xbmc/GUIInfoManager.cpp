@@ -6860,6 +6860,23 @@ bool CGUIInfoManager::EvaluateBool(const std::string &expression, int contextWin
   return result;
 }
 
+// checks whether the condition may change without the cache being reset
+bool CGUIInfoManager::IsVolatileCondition(int condition) const
+{
+  condition = abs(condition);
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    // skin settings are only changed through CSkinSettings, which resets the cache
+    int info = abs(m_multiInfo[condition - MULTI_INFO_START].m_info);
+    return info != SKIN_BOOL && info != SKIN_STRING;
+  }
+  if (condition == SYSTEM_ALWAYS_TRUE || condition == SYSTEM_ALWAYS_FALSE)
+    return false;
+  if (condition >= SYSTEM_PLATFORM_LINUX && condition <= SYSTEM_PLATFORM_LINUX_RASPBERRY_PI)
+    return false;
+  return true;
+}
+
 // checks the condition and returns it as necessary.  Currently used
 // for toggle button controls and visibility of images.
 bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListItem *item)
@@ -10763,6 +10780,18 @@ void CGUIInfoManager::ResetCache()
     (*i)->SetDirty();
 }
 
+void CGUIInfoManager::ResetFrameCache()
+{
+  m_containerMoves.clear();
+  // infobools depending on skin settings only are reset by ResetCache()
+  CSingleLock lock(m_critInfo);
+  for (std::vector<InfoPtr>::iterator i = m_bools.begin(); i != m_bools.end(); ++i)
+  {
+    if ((*i)->IsVolatile())
+      (*i)->SetDirty();
+  }
+}
+
 std::string CGUIInfoManager::GetPictureLabel(int info)
 {
   if (info == SLIDE_FILE_NAME)
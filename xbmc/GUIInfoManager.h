@@ -205,7 +205,16 @@ public:
   void SetNextWindow(int windowID) { m_nextWindowID = windowID; };
   void SetPreviousWindow(int windowID) { m_prevWindowID = windowID; };
 
+  /*! \brief Mark all info bools dirty, including the ones that only depend on skin settings.
+   Call whenever a skin setting, the profile or the context of a window changed.
+   */
   void ResetCache();
+
+  /*! \brief Mark the volatile info bools dirty, called once a frame.
+   \sa INFO::InfoBool::IsVolatile
+   */
+  void ResetFrameCache();
+
   bool GetItemInt(int &value, const CGUIListItem *item, int info) const;
   std::string GetItemLabel(const CFileItem *item, int info, std::string *fallback = NULL);
   std::string GetItemImage(const CFileItem *item, int info, std::string *fallback = NULL);
@@ -240,6 +249,11 @@ protected:
   bool GetBool(int condition, int contextWindow = 0, const CGUIListItem *item=NULL);
   int TranslateSingleString(const std::string &strCondition, bool &listItemDependent);
 
+  /*! \brief Whether the value of a translated condition may change without ResetCache() being called.
+   Conditions on skin settings and the platform are stable, everything else is volatile.
+   */
+  bool IsVolatileCondition(int condition) const;
+
   // routines for window retrieval
   bool CheckWindowCondition(CGUIWindow *window, int condition) const;
   CGUIWindow *GetWindowWithCondition(int contextWindow, int condition) const;
@@ -25,12 +25,21 @@
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 extern "C" {
 #include "libavutil/channel_layout.h"
 }
 
+#if defined(HAVE_SSE) && defined(__SSE__)
+  #define AE_SIMD_SSE
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+  #define AE_SIMD_NEON
+  #include <arm_neon.h>
+#endif
+
 /* declare the rng seed and initialize it */
 unsigned int CAEUtil::m_seed = (unsigned int)(CurrentHostCounter() / 1000.0f);
 #if defined(HAVE_SSE2) && defined(__SSE2__)
@@ -231,104 +240,103 @@ const char* CAEUtil::DataFormatToStr(const enum AEDataFormat dataFormat)
   return formats[dataFormat];
 }
 
-#if defined(HAVE_SSE) && defined(__SSE__)
-void CAEUtil::SSEMulArray(float *data, const float mul, uint32_t count)
+/*
+ * The mixing kernels below are on the hot path of the engine: every sample of
+ * every stream and gui sound goes through them once per period. They use
+ * unaligned loads, so callers can pass any offset into a plane, and work on
+ * two vectors per iteration to hide the latency of the multiply.
+ */
+void CAEUtil::MulArray(float *data, const float mul, uint32_t count)
 {
-  const __m128 m = _mm_set_ps1(mul);
+  uint32_t i = 0;
 
-  /* work around invalid alignment */
-  while (((uintptr_t)data & 0xF) && count > 0)
+#if defined(AE_SIMD_SSE)
+  const __m128 m = _mm_set_ps1(mul);
+  for (; i + 8 <= count; i += 8)
   {
-    data[0] *= mul;
-    ++data;
-    --count;
+    __m128 d0 = _mm_loadu_ps(data + i);
+    __m128 d1 = _mm_loadu_ps(data + i + 4);
+    _mm_storeu_ps(data + i,     _mm_mul_ps(d0, m));
+    _mm_storeu_ps(data + i + 4, _mm_mul_ps(d1, m));
   }
-
-  uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i+=4, data+=4)
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), m));
+#elif defined(AE_SIMD_NEON)
+  const float32x4_t m = vdupq_n_f32(mul);
+  for (; i + 8 <= count; i += 8)
   {
-    __m128 to      = _mm_load_ps(data);
-    *(__m128*)data = _mm_mul_ps (to, m);
+    float32x4_t d0 = vld1q_f32(data + i);
+    float32x4_t d1 = vld1q_f32(data + i + 4);
+    vst1q_f32(data + i,     vmulq_f32(d0, m));
+    vst1q_f32(data + i + 4, vmulq_f32(d1, m));
   }
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), m));
+#endif
 
-  if (even != count)
-  {
-    uint32_t odd = count - even;
-    if (odd == 1)
-      data[0] *= mul;
-    else
-    {
-      __m128 to;
-      if (odd == 2)
-      {
-        to = _mm_setr_ps(data[0], data[1], 0, 0);
-        __m128 ou = _mm_mul_ps(to, m);
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-      }
-      else
-      {
-        to = _mm_setr_ps(data[0], data[1], data[2], 0);
-        __m128 ou = _mm_mul_ps(to, m);
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-        data[2] = ((float*)&ou)[2];
-      }
-    }
-  }
+  for (; i < count; ++i)
+    data[i] *= mul;
 }
 
-void CAEUtil::SSEMulAddArray(float *data, float *add, const float mul, uint32_t count)
+bool CAEUtil::MulAddArray(float *data, const float *add, const float mul, uint32_t count)
 {
-  const __m128 m = _mm_set_ps1(mul);
+  uint32_t i = 0;
+  float peak = 0.0f;
 
-  /* work around invalid alignment */
-  while ((((uintptr_t)data & 0xF) || ((uintptr_t)add & 0xF)) && count > 0)
+#if defined(AE_SIMD_SSE)
+  const __m128 m = _mm_set_ps1(mul);
+  const __m128 sign = _mm_set_ps1(-0.0f);
+  __m128 peak0 = _mm_setzero_ps();
+  __m128 peak1 = _mm_setzero_ps();
+  for (; i + 8 <= count; i += 8)
   {
-    data[0] += add[0] * mul;
-    ++add;
-    ++data;
-    --count;
+    __m128 d0 = _mm_add_ps(_mm_loadu_ps(data + i),     _mm_mul_ps(_mm_loadu_ps(add + i),     m));
+    __m128 d1 = _mm_add_ps(_mm_loadu_ps(data + i + 4), _mm_mul_ps(_mm_loadu_ps(add + i + 4), m));
+    _mm_storeu_ps(data + i,     d0);
+    _mm_storeu_ps(data + i + 4, d1);
+    peak0 = _mm_max_ps(peak0, _mm_andnot_ps(sign, d0));
+    peak1 = _mm_max_ps(peak1, _mm_andnot_ps(sign, d1));
   }
-
-  uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i+=4, data+=4, add+=4)
+  for (; i + 4 <= count; i += 4)
   {
-    __m128 ad      = _mm_load_ps(add );
-    __m128 to      = _mm_load_ps(data);
-    *(__m128*)data = _mm_add_ps (to, _mm_mul_ps(ad, m));
+    __m128 d0 = _mm_add_ps(_mm_loadu_ps(data + i), _mm_mul_ps(_mm_loadu_ps(add + i), m));
+    _mm_storeu_ps(data + i, d0);
+    peak0 = _mm_max_ps(peak0, _mm_andnot_ps(sign, d0));
   }
+  if (_mm_movemask_ps(_mm_cmpgt_ps(_mm_max_ps(peak0, peak1), _mm_set_ps1(1.0f))))
+    peak = 2.0f;
+#elif defined(AE_SIMD_NEON)
+  const float32x4_t m = vdupq_n_f32(mul);
+  float32x4_t peak0 = vdupq_n_f32(0.0f);
+  float32x4_t peak1 = vdupq_n_f32(0.0f);
+  for (; i + 8 <= count; i += 8)
+  {
+    float32x4_t d0 = vmlaq_f32(vld1q_f32(data + i),     vld1q_f32(add + i),     m);
+    float32x4_t d1 = vmlaq_f32(vld1q_f32(data + i + 4), vld1q_f32(add + i + 4), m);
+    vst1q_f32(data + i,     d0);
+    vst1q_f32(data + i + 4, d1);
+    peak0 = vmaxq_f32(peak0, vabsq_f32(d0));
+    peak1 = vmaxq_f32(peak1, vabsq_f32(d1));
+  }
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t d0 = vmlaq_f32(vld1q_f32(data + i), vld1q_f32(add + i), m);
+    vst1q_f32(data + i, d0);
+    peak0 = vmaxq_f32(peak0, vabsq_f32(d0));
+  }
+  float32x4_t p = vmaxq_f32(peak0, peak1);
+  float32x2_t p2 = vpmax_f32(vget_low_f32(p), vget_high_f32(p));
+  peak = vget_lane_f32(vpmax_f32(p2, p2), 0);
+#endif
 
-  if (even != count)
+  for (; i < count; ++i)
   {
-    uint32_t odd = count - even;
-    if (odd == 1)
-      data[0] += add[0] * mul;
-    else
-    {
-      __m128 ad;
-      __m128 to;
-      if (odd == 2)
-      {
-        ad = _mm_setr_ps(add [0], add [1], 0, 0);
-        to = _mm_setr_ps(data[0], data[1], 0, 0);
-        __m128 ou = _mm_add_ps(to, _mm_mul_ps(ad, m));
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-      }
-      else
-      {
-        ad = _mm_setr_ps(add [0], add [1], add [2], 0);
-        to = _mm_setr_ps(data[0], data[1], data[2], 0);
-        __m128 ou = _mm_add_ps(to, _mm_mul_ps(ad, m));
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-        data[2] = ((float*)&ou)[2];
-      }
-    }
+    data[i] += add[i] * mul;
+    peak = std::max(peak, std::fabs(data[i]));
   }
+
+  return peak > 1.0f;
 }
-#endif
 
 inline float CAEUtil::SoftClamp(const float x)
 {
@@ -367,83 +375,44 @@ inline float CAEUtil::SoftClamp(const float x)
 
 void CAEUtil::ClampArray(float *data, uint32_t count)
 {
-#if !defined(HAVE_SSE) || !defined(__SSE__)
-  for (uint32_t i = 0; i < count; ++i)
-    data[i] = SoftClamp(data[i]);
-
-#else
-  const __m128 c1 = _mm_set_ps1(27.0f);
-  const __m128 c2 = _mm_set_ps1(27.0f + 9.0f);
-
-  /* work around invalid alignment */
-  while (((uintptr_t)data & 0xF) && count > 0)
+  uint32_t i = 0;
+
+  /* vector versions of SoftClamp, limiting the input to +-3 gives the same
+   * result as the branches of the scalar version */
+#if defined(AE_SIMD_SSE)
+  const __m128 c27  = _mm_set_ps1(27.0f);
+  const __m128 c9   = _mm_set_ps1(9.0f);
+  const __m128 cmax = _mm_set_ps1(3.0f);
+  const __m128 cmin = _mm_set_ps1(-3.0f);
+  for (; i + 4 <= count; i += 4)
   {
-    data[0] = SoftClamp(data[0]);
-    ++data;
-    --count;
+    __m128 x = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(data + i), cmax), cmin);
+    __m128 y = _mm_mul_ps(x, x);
+    __m128 n = _mm_mul_ps(x, _mm_add_ps(c27, y));
+    __m128 d = _mm_add_ps(c27, _mm_mul_ps(c9, y));
+    _mm_storeu_ps(data + i, _mm_div_ps(n, d));
   }
-
-  uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i+=4, data+=4)
-  {
-    /* tanh approx clamp */
-    __m128 dt = _mm_load_ps(data);
-    __m128 tmp     = _mm_mul_ps(dt, dt);
-    *(__m128*)data = _mm_div_ps(
-      _mm_mul_ps(
-        dt,
-        _mm_add_ps(c1, tmp)
-      ),
-      _mm_add_ps(c2, tmp)
-    );
-  }
-
-  if (even != count)
+#elif defined(AE_SIMD_NEON)
+  const float32x4_t c27  = vdupq_n_f32(27.0f);
+  const float32x4_t c9   = vdupq_n_f32(9.0f);
+  const float32x4_t cmax = vdupq_n_f32(3.0f);
+  const float32x4_t cmin = vdupq_n_f32(-3.0f);
+  for (; i + 4 <= count; i += 4)
   {
-    uint32_t odd = count - even;
-    if (odd == 1)
-      data[0] = SoftClamp(data[0]);
-    else
-    {
-      __m128 dt;
-      __m128 tmp;
-      __m128 out;
-      if (odd == 2)
-      {
-        /* tanh approx clamp */
-        dt  = _mm_setr_ps(data[0], data[1], 0, 0);
-        tmp = _mm_mul_ps(dt, dt);
-        out = _mm_div_ps(
-          _mm_mul_ps(
-            dt,
-            _mm_add_ps(c1, tmp)
-          ),
-          _mm_add_ps(c2, tmp)
-        );
-
-        data[0] = ((float*)&out)[0];
-        data[1] = ((float*)&out)[1];
-      }
-      else
-      {
-        /* tanh approx clamp */
-        dt  = _mm_setr_ps(data[0], data[1], data[2], 0);
-        tmp = _mm_mul_ps(dt, dt);
-        out = _mm_div_ps(
-          _mm_mul_ps(
-            dt,
-            _mm_add_ps(c1, tmp)
-          ),
-          _mm_add_ps(c2, tmp)
-        );
-
-        data[0] = ((float*)&out)[0];
-        data[1] = ((float*)&out)[1];
-        data[2] = ((float*)&out)[2];
-      }
-    }
+    float32x4_t x = vmaxq_f32(vminq_f32(vld1q_f32(data + i), cmax), cmin);
+    float32x4_t y = vmulq_f32(x, x);
+    float32x4_t n = vmulq_f32(x, vaddq_f32(c27, y));
+    float32x4_t d = vmlaq_f32(c27, c9, y);
+    /* armv7 has no vector divide, refine the reciprocal estimate instead */
+    float32x4_t r = vrecpeq_f32(d);
+    r = vmulq_f32(vrecpsq_f32(d, r), r);
+    r = vmulq_f32(vrecpsq_f32(d, r), r);
+    vst1q_f32(data + i, vmulq_f32(n, r));
   }
 #endif
+
+  for (; i < count; ++i)
+    data[i] = SoftClamp(data[i]);
 }
 
 bool CAEUtil::S16NeedsByteSwap(AEDataFormat in, AEDataFormat out)
@@ -202,10 +202,29 @@ public:
     return 20*log10(scale);
   }
 
-  #if defined(HAVE_SSE) && defined(__SSE__)
-  static void SSEMulArray     (float *data, const float mul, uint32_t count);
-  static void SSEMulAddArray  (float *data, float *add, const float mul, uint32_t count);
-  #endif
+  /*! \brief scale samples by a constant gain
+   Uses SSE or NEON when available, data does not need to be aligned.
+   \param data the samples to scale in place
+   \param mul the gain
+   \param count the number of samples
+   */
+  static void MulArray(float *data, const float mul, uint32_t count);
+
+  /*! \brief mix samples into a buffer with a constant gain: data += add * mul
+   Uses SSE or NEON when available, data does not need to be aligned.
+   \param data the samples to mix into
+   \param add the samples to mix
+   \param mul the gain applied to add
+   \param count the number of samples
+   \return true if a mixed sample exceeds unity and the buffer needs clamping
+   \sa ClampArray
+   */
+  static bool MulAddArray(float *data, const float *add, const float mul, uint32_t count);
+
+  /*! \brief soft clamp samples to -1..1
+   \param data the samples to clamp in place
+   \param count the number of samples
+   */
   static void ClampArray(float *data, uint32_t count);
 
   static bool S16NeedsByteSwap(AEDataFormat in, AEDataFormat out);
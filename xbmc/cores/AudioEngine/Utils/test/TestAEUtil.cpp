@@ -0,0 +1,142 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "threads/SystemClock.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+// reference versions of the kernels, the vector versions must match them for
+// any length and alignment
+float SoftClamp(float x)
+{
+  if (x < -3.0f)
+    return -1.0f;
+  if (x > 3.0f)
+    return 1.0f;
+  float y = x * x;
+  return x * (27.0f + y) / (27.0f + 9.0f * y);
+}
+
+std::vector<float> Samples(size_t count, float scale)
+{
+  std::vector<float> samples(count);
+  for (size_t i = 0; i < count; i++)
+    samples[i] = scale * std::sin(i * 0.37f);
+  return samples;
+}
+}
+
+TEST(TestAEUtil, MulArray)
+{
+  for (uint32_t offset = 0; offset < 4; offset++)
+  {
+    for (uint32_t count = 0; count < 40; count++)
+    {
+      std::vector<float> data = Samples(64, 1.0f);
+      std::vector<float> expected = data;
+      for (uint32_t i = 0; i < count; i++)
+        expected[offset + i] *= 0.3f;
+
+      CAEUtil::MulArray(data.data() + offset, 0.3f, count);
+      for (size_t i = 0; i < data.size(); i++)
+        EXPECT_FLOAT_EQ(expected[i], data[i]);
+    }
+  }
+}
+
+TEST(TestAEUtil, MulAddArray)
+{
+  for (uint32_t offset = 0; offset < 4; offset++)
+  {
+    for (uint32_t count = 0; count < 40; count++)
+    {
+      std::vector<float> data = Samples(64, 0.8f);
+      std::vector<float> add = Samples(64, 0.9f);
+      std::vector<float> expected = data;
+      bool needClamp = false;
+      for (uint32_t i = 0; i < count; i++)
+      {
+        expected[offset + i] += add[offset + i] * 0.5f;
+        if (std::fabs(expected[offset + i]) > 1.0f)
+          needClamp = true;
+      }
+
+      EXPECT_EQ(needClamp, CAEUtil::MulAddArray(data.data() + offset, add.data() + offset, 0.5f, count));
+      for (size_t i = 0; i < data.size(); i++)
+        EXPECT_NEAR(expected[i], data[i], 1e-6f);
+    }
+  }
+}
+
+TEST(TestAEUtil, ClampArray)
+{
+  for (uint32_t offset = 0; offset < 4; offset++)
+  {
+    for (uint32_t count = 0; count < 40; count++)
+    {
+      std::vector<float> data = Samples(64, 5.0f);
+      std::vector<float> expected = data;
+      for (uint32_t i = 0; i < count; i++)
+        expected[offset + i] = SoftClamp(expected[offset + i]);
+
+      CAEUtil::ClampArray(data.data() + offset, count);
+      for (size_t i = 0; i < data.size(); i++)
+        EXPECT_NEAR(expected[i], data[i], 1e-5f);
+    }
+  }
+}
+
+TEST(TestAEUtil, MixThroughput)
+{
+  // one second of 7.1 at 192kHz mixed from a stream and three gui sounds,
+  // followed by the master volume and the final clamp
+  const uint32_t frames = 192000;
+  const uint32_t period = 1024 * 8;
+  std::vector<float> out(period);
+  std::vector<float> stream = Samples(period, 0.5f);
+  std::vector<float> sound = Samples(period, 0.4f);
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  for (uint32_t i = 0; i < frames * 8 / period; i++)
+  {
+    std::fill(out.begin(), out.end(), 0.0f);
+    bool needClamp = CAEUtil::MulAddArray(out.data(), stream.data(), 0.9f, period);
+    for (int j = 0; j < 3; j++)
+      needClamp |= CAEUtil::MulAddArray(out.data(), sound.data(), 0.5f, period);
+    CAEUtil::MulArray(out.data(), 0.8f, period);
+    if (needClamp)
+      CAEUtil::ClampArray(out.data(), period);
+  }
+  unsigned int elapsed = XbmcThreads::SystemClockMillis() - start;
+
+  for (float sample : out)
+    EXPECT_LE(std::fabs(sample), 1.0f);
+
+  // mixing has to keep up with playback, by far
+  RecordProperty("elapsed_ms", elapsed);
+  EXPECT_LT(elapsed, 1000U);
+}
@@ -20,9 +20,13 @@
 
 #include "DVDDemuxUtils.h"
 #include "DVDClock.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "system.h"
 
+#include <vector>
+
 #ifdef TARGET_POSIX
 #include "linux/XMemUtils.h"
 #endif
@@ -31,6 +35,135 @@ extern "C" {
 #include "libavcodec/avcodec.h"
 }
 
+namespace
+{
+
+/*!
+ \brief Pool of packet data buffers in power of two size classes.
+
+ Demuxers that copy their data (add-on inputstreams, PVR clients, CC, SSIF/MVC merging) allocate
+ a buffer per packet, which at high bitrates causes a lot of allocator churn and fragments the
+ heap on low memory devices. Freed buffers are kept for reuse, up to a total size limit.
+
+ Each buffer starts with a header holding its size class, the packet data follows at an offset
+ that keeps it 16 byte aligned.
+ */
+class CPacketDataPool
+{
+public:
+  static CPacketDataPool& GetInstance()
+  {
+    static CPacketDataPool pool;
+    return pool;
+  }
+
+  uint8_t* Allocate(int size)
+  {
+    size_t required = (size_t)size + FF_INPUT_BUFFER_PADDING_SIZE;
+    int sizeClass = GetSizeClass(required);
+
+    uint8_t* block = nullptr;
+    if (sizeClass >= 0)
+    {
+      CSingleLock lock(m_section);
+      std::vector<uint8_t*>& buffers = m_free[sizeClass];
+      if (!buffers.empty())
+      {
+        block = buffers.back();
+        buffers.pop_back();
+        m_pooled -= GetClassSize(sizeClass);
+      }
+    }
+
+    if (!block)
+    {
+      size_t capacity = sizeClass >= 0 ? GetClassSize(sizeClass) : required;
+      block = (uint8_t*)_aligned_malloc(capacity + HEADER_SIZE, 16);
+      if (!block)
+        return nullptr;
+      *(int*)block = sizeClass;
+    }
+    return block + HEADER_SIZE;
+  }
+
+  void Free(uint8_t* data)
+  {
+    uint8_t* block = data - HEADER_SIZE;
+    int sizeClass = *(int*)block;
+    if (sizeClass >= 0)
+    {
+      CSingleLock lock(m_section);
+      if (m_pooled + GetClassSize(sizeClass) <= MAX_POOLED)
+      {
+        m_free[sizeClass].push_back(block);
+        m_pooled += GetClassSize(sizeClass);
+        return;
+      }
+    }
+    _aligned_free(block);
+  }
+
+private:
+  CPacketDataPool() : m_pooled(0) {}
+  ~CPacketDataPool()
+  {
+    for (auto& buffers : m_free)
+    {
+      for (auto block : buffers)
+        _aligned_free(block);
+    }
+  }
+
+  static const size_t HEADER_SIZE = 16;
+  static const int MIN_CLASS_SHIFT = 10; // 1 KiB
+  static const int NUM_CLASSES = 13;     // up to 4 MiB
+  static const size_t MAX_POOLED = 16 * 1024 * 1024;
+
+  static size_t GetClassSize(int sizeClass) { return (size_t)1 << (sizeClass + MIN_CLASS_SHIFT); }
+
+  static int GetSizeClass(size_t size)
+  {
+    for (int sizeClass = 0; sizeClass < NUM_CLASSES; sizeClass++)
+    {
+      if (size <= GetClassSize(sizeClass))
+        return sizeClass;
+    }
+    return -1; // too large to pool
+  }
+
+  CCriticalSection m_section;
+  std::vector<uint8_t*> m_free[NUM_CLASSES];
+  size_t m_pooled;
+};
+
+}
+
+uint8_t* CDVDDemuxUtils::AllocatePacketData(int iDataSize)
+{
+  // need to allocate a few bytes more.
+  // From avcodec.h (ffmpeg)
+  /**
+    * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
+    * this is mainly needed because some optimized bitstream readers read
+    * 32 or 64 bit at once and could read over the end<br>
+    * Note, if the first 23 bits of the additional bytes are not 0 then damaged
+    * MPEG bitstreams could cause overread and segfault
+    */
+  uint8_t* pData = CPacketDataPool::GetInstance().Allocate(iDataSize);
+  if (pData)
+  {
+    // reset the padding bytes to 0;
+    memset(pData + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
+  }
+  return pData;
+}
+
+void CDVDDemuxUtils::FreePacketData(uint8_t* pData)
+{
+  if (pData)
+    CPacketDataPool::GetInstance().Free(pData);
+}
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
@@ -41,7 +174,8 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
         av_free_packet(pPacket->pkt);
         delete pPacket->pkt;
       }
-      else if (pPacket->pData) _aligned_free(pPacket->pData);
+      else if (pPacket->pData)
+        FreePacketData(pPacket->pData);
       delete pPacket;
     }
     catch(...) {
@@ -61,24 +195,12 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 
     if (iDataSize > 0)
     {
-      // need to allocate a few bytes more.
-      // From avcodec.h (ffmpeg)
-      /**
-        * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
-        * this is mainly needed because some optimized bitstream readers read
-        * 32 or 64 bit at once and could read over the end<br>
-        * Note, if the first 23 bits of the additional bytes are not 0 then damaged
-        * MPEG bitstreams could cause overread and segfault
-        */
-      pPacket->pData =(uint8_t*)_aligned_malloc(iDataSize + FF_INPUT_BUFFER_PADDING_SIZE, 16);
+      pPacket->pData = AllocatePacketData(iDataSize);
       if (!pPacket->pData)
       {
         FreeDemuxPacket(pPacket);
         return NULL;
       }
-
-      // reset the last 8 bytes to 0;
-      memset(pPacket->pData + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
     }
 
     // setup defaults
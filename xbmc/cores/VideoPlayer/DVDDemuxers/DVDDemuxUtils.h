@@ -27,5 +27,13 @@ class CDVDDemuxUtils
 public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
+
+  /*!
+   \brief Allocate a buffer for iDataSize bytes of packet data, followed by the zeroed padding
+   required by ffmpeg. Buffers are recycled through a pool of size classes, so they must only be
+   released with FreePacketData (or FreeDemuxPacket).
+   */
+  static uint8_t* AllocatePacketData(int iDataSize);
+  static void FreePacketData(uint8_t* pData);
 };
 
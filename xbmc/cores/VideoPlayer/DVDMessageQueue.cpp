@@ -25,9 +25,43 @@
 #include "DVDClock.h"
 #include "math.h"
 
+void CDVDMessageRing::Grow()
+{
+  std::vector<DVDMessageListItem> items(std::max((size_t)64, m_items.size() * 2));
+  for (size_t i = 0; i < m_size; ++i)
+    items[i] = std::move(At(i));
+  m_items.swap(items);
+  m_head = 0;
+}
+
+void CDVDMessageRing::PopOldest()
+{
+  m_items[m_head] = DVDMessageListItem();
+  m_head = (m_head + 1) % m_items.size();
+  m_size--;
+}
+
+void CDVDMessageRing::PushOldest(CDVDMsg* msg, int priority)
+{
+  if (m_size == m_items.size())
+    Grow();
+  m_head = (m_head + m_items.size() - 1) % m_items.size();
+  m_items[m_head] = DVDMessageListItem(msg, priority);
+  m_size++;
+}
+
+void CDVDMessageRing::PushNewest(CDVDMsg* msg, int priority)
+{
+  if (m_size == m_items.size())
+    Grow();
+  m_items[(m_head + m_size) % m_items.size()] = DVDMessageListItem(msg, priority);
+  m_size++;
+}
+
 CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner)
 {
   m_iDataSize     = 0;
+  m_packetCount   = 0;
   m_bAbortRequest = false;
   m_bInitialized = false;
 
@@ -57,13 +91,15 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
   CSingleLock lock(m_section);
 
-  m_messages.remove_if([type](const DVDMessageListItem &item){
-    return type == CDVDMsg::NONE || item.message->IsType(type);
-  });
-
-  m_prioMessages.remove_if([type](const DVDMessageListItem &item){
-    return type == CDVDMsg::NONE || item.message->IsType(type);
-  });
+  auto remove = [this, type](const DVDMessageListItem &item){
+    if (type != CDVDMsg::NONE && !item.message->IsType(type))
+      return false;
+    if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
+      m_packetCount--;
+    return true;
+  };
+  m_messages.RemoveIf(remove);
+  m_prioMessages.remove_if(remove);
 
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
@@ -125,11 +161,14 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
   else
   {
     if (front)
-      m_messages.emplace_front(pMsg, priority);
+      m_messages.PushNewest(pMsg, priority);
     else
-      m_messages.emplace_back(pMsg, priority);
+      m_messages.PushOldest(pMsg, priority);
   }
 
+  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+    m_packetCount++;
+
   if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
   {
     DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)pMsg)->GetPacket();
@@ -170,28 +209,43 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
 
   while (!m_bAbortRequest)
   {
-    std::list<DVDMessageListItem> &msgs = (priority > 0 || !m_prioMessages.empty()) ? m_prioMessages : m_messages;
+    bool prio = priority > 0 || !m_prioMessages.empty();
+    bool available = prio ? !m_prioMessages.empty() : !m_messages.Empty();
+
+    if (available)
+    {
+      DVDMessageListItem& item(prio ? m_prioMessages.back() : m_messages.Oldest());
+      if (item.priority < priority && !m_drain)
+        available = false;
+    }
 
-    if (!msgs.empty() && (msgs.back().priority >= priority || m_drain))
+    if (available)
     {
-      DVDMessageListItem& item(msgs.back());
+      DVDMessageListItem& item(prio ? m_prioMessages.back() : m_messages.Oldest());
       priority = item.priority;
 
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
+      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
       {
-        DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)item.message)->GetPacket();
-        if (packet)
+        m_packetCount--;
+        if (item.priority == 0)
         {
-          m_iDataSize -= packet->iSize;
-          if (packet->dts != DVD_NOPTS_VALUE)
-            m_TimeBack = packet->dts;
-          else if (packet->pts != DVD_NOPTS_VALUE)
-            m_TimeBack = packet->pts;
+          DemuxPacket* packet = ((CDVDMsgDemuxerPacket*)item.message)->GetPacket();
+          if (packet)
+          {
+            m_iDataSize -= packet->iSize;
+            if (packet->dts != DVD_NOPTS_VALUE)
+              m_TimeBack = packet->dts;
+            else if (packet->pts != DVD_NOPTS_VALUE)
+              m_TimeBack = packet->pts;
+          }
         }
       }
 
       *pMsg = item.message->Acquire();
-      msgs.pop_back();
+      if (prio)
+        m_prioMessages.pop_back();
+      else
+        m_messages.PopOldest();
 
       ret = MSGQ_OK;
       break;
@@ -227,17 +281,17 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
   if (!m_bInitialized)
     return 0;
 
+  // demux packets are counted on the way in and out, as players poll this often
+  if (type == CDVDMsg::DEMUXER_PACKET)
+    return m_packetCount;
+
   unsigned count = 0;
-  for (const auto &item : m_messages)
-  {
-    if(item.message->IsType(type))
-      count++;
-  }
-  for (const auto &item : m_prioMessages)
-  {
+  auto counter = [type, &count](const DVDMessageListItem &item){
     if(item.message->IsType(type))
       count++;
-  }
+  };
+  m_messages.ForEach(counter);
+  std::for_each(m_prioMessages.begin(), m_prioMessages.end(), counter);
 
   return count;
 }
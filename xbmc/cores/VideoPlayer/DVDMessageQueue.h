@@ -24,6 +24,7 @@
 #include <atomic>
 #include <string>
 #include <list>
+#include <vector>
 #include <algorithm>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
@@ -41,6 +42,12 @@ struct DVDMessageListItem
     priority = 0;
   }
   DVDMessageListItem(const DVDMessageListItem&) = delete;
+  DVDMessageListItem(DVDMessageListItem&& other)
+  {
+    message = other.message;
+    priority = other.priority;
+    other.message = NULL;
+  }
  ~DVDMessageListItem()
   {
     if(message)
@@ -48,11 +55,74 @@ struct DVDMessageListItem
   }
 
   DVDMessageListItem& operator=(const DVDMessageListItem&) = delete;
+  DVDMessageListItem& operator=(DVDMessageListItem&& other)
+  {
+    if (this != &other)
+    {
+      if(message)
+        message->Release();
+      message = other.message;
+      priority = other.priority;
+      other.message = NULL;
+    }
+    return *this;
+  }
 
   CDVDMsg* message;
   int priority;
 };
 
+/**
+ * Ring buffer of messages, ordered from oldest (next to be returned) to newest.
+ * Slots are reused, so no allocation happens per message once the buffer has
+ * grown to the working size of the queue.
+ */
+class CDVDMessageRing
+{
+public:
+  bool Empty() const { return m_size == 0; }
+  size_t Size() const { return m_size; }
+
+  DVDMessageListItem& Oldest() { return m_items[m_head]; }
+  void PopOldest();
+  void PushOldest(CDVDMsg* msg, int priority);
+  void PushNewest(CDVDMsg* msg, int priority);
+
+  template<typename F>
+  void RemoveIf(F predicate)
+  {
+    size_t kept = 0;
+    for (size_t i = 0; i < m_size; ++i)
+    {
+      DVDMessageListItem& item = At(i);
+      if (predicate(item))
+        item = DVDMessageListItem();
+      else
+      {
+        if (kept != i)
+          At(kept) = std::move(item);
+        kept++;
+      }
+    }
+    m_size = kept;
+  }
+
+  template<typename F>
+  void ForEach(F function) const
+  {
+    for (size_t i = 0; i < m_size; ++i)
+      function(m_items[(m_head + i) % m_items.size()]);
+  }
+
+private:
+  DVDMessageListItem& At(size_t i) { return m_items[(m_head + i) % m_items.size()]; }
+  void Grow();
+
+  std::vector<DVDMessageListItem> m_items;
+  size_t m_head = 0;
+  size_t m_size = 0;
+};
+
 enum MsgQueueReturnCode
 {
   MSGQ_OK = 1,
@@ -124,7 +194,9 @@ private:
   int m_iMaxDataSize;
   std::string m_owner;
 
-  std::list<DVDMessageListItem> m_messages;
+  unsigned m_packetCount; // number of DEMUXER_PACKET messages in both queues
+
+  CDVDMessageRing m_messages;
   std::list<DVDMessageListItem> m_prioMessages;
 };
 
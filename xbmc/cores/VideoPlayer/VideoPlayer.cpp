@@ -135,8 +135,8 @@ static void dump_packet(DemuxPacket *packet, bool video, bool audio)
       packet->iSize = p.iSize;
       packet->dts = p.dts;
       packet->pts = p.pts;
-      _aligned_free(packet->pData);
-      packet->pData = (uint8_t*)_aligned_malloc(packet->iSize + FF_INPUT_BUFFER_PADDING_SIZE, 16);
+      CDVDDemuxUtils::FreePacketData(packet->pData);
+      packet->pData = CDVDDemuxUtils::AllocatePacketData(packet->iSize);
       fread(packet->pData, packet->iSize, 1, fp);
     }
 #else
@@ -892,6 +892,12 @@ RESOLUTION CRenderManager::GetResolution()
 
 void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
 {
+#if HAS_GLES == 2
+  // the video layer is drawn with its own GL state, so GUI quads queued
+  // behind it have to reach the GPU first
+  g_Windowing.FlushGUIQuads();
+#endif
+
   CSingleExit exitLock(g_graphicsContext);
 
   {
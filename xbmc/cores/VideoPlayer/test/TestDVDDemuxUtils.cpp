@@ -0,0 +1,59 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+}
+
+TEST(TestDVDDemuxUtils, AllocateDemuxPacket)
+{
+  for (int size : { 1, 1000, 5000, 300000, 8 * 1024 * 1024 })
+  {
+    DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(size);
+    ASSERT_NE(nullptr, packet);
+    ASSERT_NE(nullptr, packet->pData);
+    EXPECT_EQ(0U, (uintptr_t)packet->pData % 16);
+
+    // scribble over data and padding, so a recycled buffer would show it
+    memset(packet->pData, 0xff, size + FF_INPUT_BUFFER_PADDING_SIZE);
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+
+    packet = CDVDDemuxUtils::AllocateDemuxPacket(size);
+    ASSERT_NE(nullptr, packet);
+    for (int i = 0; i < FF_INPUT_BUFFER_PADDING_SIZE; i++)
+      EXPECT_EQ(0, packet->pData[size + i]);
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+  }
+}
+
+TEST(TestDVDDemuxUtils, AllocateEmptyDemuxPacket)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(0);
+  ASSERT_NE(nullptr, packet);
+  EXPECT_EQ(nullptr, packet->pData);
+  EXPECT_EQ(-1, packet->iStreamId);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+}
@@ -18,7 +18,11 @@
  *
  */
 
+#include <algorithm>
+#include <inttypes.h>
+
 #include "Database.h"
+#include "FileItem.h"
 #include "settings/AdvancedSettings.h"
 #include "filesystem/SpecialProtocol.h"
 #include "filesystem/File.h"
@@ -155,6 +159,7 @@ CDatabase::CDatabase(void)
   m_sqlite = true;
   m_bMultiWrite = false;
   m_multipleExecute = false;
+  m_itemsBatchSize = 0;
 }
 
 CDatabase::~CDatabase(void)
@@ -284,6 +289,85 @@ bool CDatabase::ExecuteQuery(const std::string &strQuery)
   return bReturn;
 }
 
+bool CDatabase::ExecuteInsertRows(const std::string &strInsert, const std::vector<std::string> &rows)
+{
+  // SQLite before 3.8.8 treats multi-row VALUES as a compound select,
+  // which is limited to 500 terms
+  static const size_t maxRowsPerStatement = 500;
+
+  bool bReturn = true;
+  for (size_t first = 0; first < rows.size(); first += maxRowsPerStatement)
+  {
+    std::string strSQL = strInsert + " VALUES ";
+    size_t last = std::min(rows.size(), first + maxRowsPerStatement);
+    for (size_t i = first; i < last; ++i)
+    {
+      if (i > first)
+        strSQL += ",";
+      strSQL += "(" + rows[i] + ")";
+    }
+    bReturn &= ExecuteQuery(strSQL);
+  }
+
+  return bReturn;
+}
+
+std::string CDatabase::GetSearchCondition(const std::string &table, const std::string &idField, const std::string &search,
+                                          const std::vector<std::string> &columns, const std::string &fallback)
+{
+  // only whole words are indexed, so split the search the way the tokenizer
+  // does and match every word as a prefix
+  std::vector<std::string> words(1);
+  for (char c : search)
+  {
+    unsigned char uc = static_cast<unsigned char>(c);
+    // bytes of multi-byte UTF-8 characters are kept as they are
+    if (uc >= 0x80)
+      words.back() += c;
+    else if (isalnum(uc))
+      words.back() += static_cast<char>(tolower(uc));
+    else if (!words.back().empty())
+      words.emplace_back();
+  }
+  if (words.back().empty())
+    words.pop_back();
+
+  if (words.empty() || !HasSearchIndex(table))
+    return fallback;
+
+  // fts4 and fts5 differ in operator precedence and in how several columns
+  // are filtered, so words that may match one of several columns are looked
+  // up one by one
+  std::vector<std::string> matches;
+  for (const auto &word : words)
+  {
+    std::vector<std::string> terms;
+    for (const auto &column : columns)
+      terms.push_back(column + ":" + word + "*");
+    if (terms.empty())
+      terms.push_back(word + "*");
+
+    if (columns.size() > 1 || matches.empty())
+      matches.push_back(StringUtils::Join(terms, " OR "));
+    else
+      matches.back() += " " + terms.front();
+  }
+
+  std::string index = table + "_search";
+  std::vector<std::string> queries;
+  for (const auto &match : matches)
+    queries.push_back(PrepareSQL("SELECT rowid FROM %s WHERE %s MATCH '%s'", index.c_str(), index.c_str(), match.c_str()));
+
+  std::string ids = StringUtils::Join(queries, " INTERSECT ");
+
+  // the index only finds words by their start, so if nothing starts with
+  // the search, look for it within words as searches used to
+  if (GetSingleValue("SELECT EXISTS (" + ids + ")", m_pDS2) != "1")
+    return fallback;
+
+  return idField + " IN (" + ids + ")";
+}
+
 bool CDatabase::ResultQuery(const std::string &strQuery)
 {
   bool bReturn = false;
@@ -419,7 +503,9 @@ bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSet
   // create the appropriate database structure
   if (dbSettings.type == "sqlite3")
   {
-    m_pDB.reset( new SqliteDatabase() ) ;
+    SqliteDatabase *sqlite = new SqliteDatabase();
+    sqlite->setPoolSize(g_advancedSettings.m_sqlitePoolSize);
+    m_pDB.reset(sqlite);
   }
 #ifdef HAS_MYSQL
   else if (dbSettings.type == "mysql")
@@ -486,9 +572,27 @@ bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSet
     // sqlite3 post connection operations
     if (dbSettings.type == "sqlite3")
     {
-      m_pDS->exec("PRAGMA cache_size=4096\n");
+      // a negative cache size is given in KiB rather than pages
+      if (g_advancedSettings.m_sqliteCacheSize > 0)
+        m_pDS->exec(StringUtils::Format("PRAGMA cache_size=-%i\n", g_advancedSettings.m_sqliteCacheSize));
+      else
+        m_pDS->exec("PRAGMA cache_size=4096\n");
+      m_pDS->exec(StringUtils::Format("PRAGMA mmap_size=%" PRId64 "\n", static_cast<int64_t>(g_advancedSettings.m_sqliteMmapSize) * 1024));
       m_pDS->exec("PRAGMA synchronous='NORMAL'\n");
       m_pDS->exec("PRAGMA count_changes='OFF'\n");
+
+      // with write-ahead logging readers carry on while a scan holds the
+      // write lock, instead of waiting on the busy handler. It relies on
+      // shared memory, which breaks with userdata on a network share, so
+      // it's opt-in.
+      try
+      {
+        m_pDS->exec(g_advancedSettings.m_sqliteWAL ? "PRAGMA journal_mode=WAL\n" : "PRAGMA journal_mode=DELETE\n");
+      }
+      catch (DbErrors &error)
+      {
+        CLog::Log(LOGWARNING, "%s unable to change the journal mode of %s: '%s'", __FUNCTION__, dbName.c_str(), error.getMsg());
+      }
     }
   }
   catch (DbErrors &error)
@@ -532,6 +636,7 @@ void CDatabase::Close()
 
   if (NULL == m_pDB.get() ) return ;
   if (NULL != m_pDS.get()) m_pDS->close();
+  if (NULL != m_pDS2.get()) m_pDS2->close();
   m_pDB->disconnect();
   m_pDB.reset();
   m_pDS.reset();
@@ -574,11 +679,87 @@ bool CDatabase::Compress(bool bForce /* =true */)
   return true;
 }
 
+std::string CDatabase::GetFullTextModule()
+{
+  if (!m_sqlite)
+    return "";
+
+  if (GetSingleValue("SELECT sqlite_compileoption_used('ENABLE_FTS5')", m_pDS2) == "1")
+    return "fts5";
+  if (GetSingleValue("SELECT sqlite_compileoption_used('ENABLE_FTS4') OR sqlite_compileoption_used('ENABLE_FTS3')", m_pDS2) == "1")
+    return "fts4";
+  return "";
+}
+
+bool CDatabase::HasSearchIndex(const std::string &table)
+{
+  if (!m_sqlite)
+    return false;
+
+  return !GetSingleValue(PrepareSQL("SELECT name FROM sqlite_master WHERE type='table' AND name='%s_search'", table.c_str()), m_pDS2).empty();
+}
+
+bool CDatabase::CreateSearchIndex(const std::string &table, const std::string &idField, const std::vector<std::string> &columns)
+{
+  if (!m_sqlite)
+    return false;
+
+  std::string index = table + "_search";
+  m_pDS->exec("DROP TABLE IF EXISTS " + index);
+
+  std::string module = GetFullTextModule();
+  if (module.empty())
+  {
+    CLog::Log(LOGINFO, "%s - full-text search isn't supported, not indexing %s", __FUNCTION__, table.c_str());
+    return false;
+  }
+
+  CLog::Log(LOGINFO, "%s - creating %s index %s", __FUNCTION__, module.c_str(), index.c_str());
+  std::string fields = StringUtils::Join(columns, ", ");
+  // fts5 tokenizes with unicode61 by default, fts4 only folds ASCII unless told otherwise
+  m_pDS->exec(StringUtils::Format("CREATE VIRTUAL TABLE %s USING %s(%s%s)", index.c_str(), module.c_str(),
+                                  fields.c_str(), module == "fts4" ? ", tokenize=unicode61" : ""));
+
+  std::string insert = StringUtils::Format("INSERT OR REPLACE INTO %s (rowid, %s) SELECT %s, %s FROM %s",
+                                           index.c_str(), fields.c_str(), idField.c_str(), fields.c_str(), table.c_str());
+  m_pDS->exec(insert);
+
+  // REPLACE INTO on the table doesn't fire the delete trigger, hence OR REPLACE above
+  m_pDS->exec(StringUtils::Format("CREATE TRIGGER %s_insert AFTER INSERT ON %s FOR EACH ROW BEGIN "
+                                  "%s WHERE %s=new.%s; "
+                                  "END", index.c_str(), table.c_str(), insert.c_str(), idField.c_str(), idField.c_str()));
+  m_pDS->exec(StringUtils::Format("CREATE TRIGGER %s_update AFTER UPDATE OF %s ON %s FOR EACH ROW BEGIN "
+                                  "DELETE FROM %s WHERE rowid=old.%s; "
+                                  "%s WHERE %s=new.%s; "
+                                  "END", index.c_str(), fields.c_str(), table.c_str(), index.c_str(), idField.c_str(),
+                                  insert.c_str(), idField.c_str(), idField.c_str()));
+  m_pDS->exec(StringUtils::Format("CREATE TRIGGER %s_delete AFTER DELETE ON %s FOR EACH ROW BEGIN "
+                                  "DELETE FROM %s WHERE rowid=old.%s; "
+                                  "END", index.c_str(), table.c_str(), index.c_str(), idField.c_str()));
+  return true;
+}
+
 void CDatabase::Interrupt()
 {
   m_pDS->interrupt();
 }
 
+void CDatabase::SetItemsCallback(const ItemsCallback &callback, unsigned int batchSize /* = 100 */)
+{
+  m_itemsCallback = callback;
+  m_itemsBatchSize = std::max(batchSize, 1u);
+}
+
+bool CDatabase::StreamItems(CFileItemList &items)
+{
+  if (!m_itemsCallback || items.Size() < static_cast<int>(m_itemsBatchSize))
+    return true;
+
+  bool carryOn = m_itemsCallback(items);
+  items.ClearItems();
+  return carryOn;
+}
+
 void CDatabase::BeginTransaction()
 {
   try
@@ -25,12 +25,14 @@ namespace dbiplus {
   class Dataset;
 }
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
 class DatabaseSettings; // forward
 class CDbUrl;
+class CFileItemList;
 struct SortDescription;
 
 class CDatabase
@@ -128,6 +130,34 @@ public:
    */
   bool ExecuteQuery(const std::string &strQuery);
 
+  /*!
+   * @brief Insert a set of rows using multi-row INSERT statements.
+   *        Rows are sent in chunks so that every statement stays within
+   *        the limits of both SQLite and MySQL.
+   * @param strInsert The statement up to the VALUES keyword, e.g.
+   *        "INSERT INTO genre_link (genre_id, media_id, media_type)".
+   * @param rows The values of each row, PrepareSQL'ed, without brackets.
+   * @return True if all rows were inserted successfully, false otherwise.
+   * @sa ExecuteQuery
+   */
+  bool ExecuteInsertRows(const std::string &strInsert, const std::vector<std::string> &rows);
+
+  /*!
+   * @brief Build the condition selecting the rows of a table that match a search.
+   *        Every word of the search has to match the start of a word in the
+   *        indexed columns. Without a full-text index for the table, or if
+   *        no row matches that way, the given fallback condition is used
+   *        instead, which usually matches the search anywhere in the text.
+   * @param table The searched table, see CreateSearchIndex().
+   * @param idField The field holding the id of the rows in the query, e.g. "movie.idMovie".
+   * @param search The text to search for.
+   * @param columns The indexed columns to match, all of them if empty.
+   * @param fallback The condition to use without an index, PrepareSQL'ed.
+   * @return The condition to use in the WHERE clause.
+   */
+  std::string GetSearchCondition(const std::string &table, const std::string &idField, const std::string &search,
+                                 const std::vector<std::string> &columns, const std::string &fallback);
+
   /*!
    * @brief Execute a query that returns a result.
    * @remarks Call m_pDS->close(); to clean up the dataset when done.
@@ -169,6 +199,26 @@ public:
    */
   bool CommitInsertQueries();
 
+  /*!
+   * @brief Callback receiving the items of a library query while the query is still running.
+   * @param items The items read since the previous call, in their final order.
+   *        The list is cleared once the callback returns.
+   * @return true to carry on with the query, false to cancel it.
+   */
+  typedef std::function<bool(CFileItemList &items)> ItemsCallback;
+
+  /*!
+   * @brief Hand out the items of the library queries that support it in batches.
+   *        Every batchSize items the callback is called with the items read so far,
+   *        so the list passed to the query only holds the items of the last,
+   *        incomplete batch when it returns. Only set this around a query whose
+   *        result isn't processed any further by the caller.
+   * @param callback The callback to use, or an empty function to stop streaming.
+   * @param batchSize The number of items per batch.
+   * @sa CDatabaseQueryQueue
+   */
+  void SetItemsCallback(const ItemsCallback &callback, unsigned int batchSize = 100);
+
   virtual bool GetFilter(CDbUrl &dbUrl, Filter &filter, SortDescription &sorting) { return true; }
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl);
   virtual bool BuildSQL(const std::string &strBaseDir, const std::string &strQuery, Filter &filter, std::string &strSQL, CDbUrl &dbUrl, SortDescription &sorting);
@@ -216,6 +266,28 @@ protected:
 
   bool BuildSQL(const std::string &strQuery, const Filter &filter, std::string &strSQL);
 
+  /*!
+   * @brief Create a full-text search index over some columns of a table.
+   *        The index is filled from the table and kept up to date by triggers,
+   *        so it has to be (re)created from CreateAnalytics(). Only SQLite
+   *        databases built with FTS5 or FTS4 support full-text search.
+   * @param table The table to index.
+   * @param idField The INTEGER PRIMARY KEY of the table.
+   * @param columns The columns to index.
+   * @return true if the index was created, false if full-text search isn't supported.
+   * @sa GetSearchCondition
+   */
+  bool CreateSearchIndex(const std::string &table, const std::string &idField, const std::vector<std::string> &columns);
+
+  /*!
+   * @brief Pass the items built so far to the items callback once a batch is full.
+   *        Library queries call this after adding each item.
+   * @param items The items built so far. Cleared if they were handed out.
+   * @return false if the query has been cancelled, true otherwise.
+   * @sa SetItemsCallback
+   */
+  bool StreamItems(CFileItemList &items);
+
   bool m_sqlite; ///< \brief whether we use sqlite (defaults to true)
 
   std::unique_ptr<dbiplus::Database> m_pDB;
@@ -225,10 +297,15 @@ protected:
 private:
   void InitSettings(DatabaseSettings &dbSettings);
   void UpdateVersionNumber();
+  std::string GetFullTextModule();
+  bool HasSearchIndex(const std::string &table);
 
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
   unsigned int m_openCount;
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
+
+  ItemsCallback m_itemsCallback;
+  unsigned int m_itemsBatchSize;
 };
@@ -0,0 +1,234 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DatabaseQueryQueue.h"
+
+#include <string.h>
+#include <vector>
+
+#include "Database.h"
+#include "utils/log.h"
+
+CDatabaseQueryJob::CState::CState(unsigned int queryId, IDatabaseQueryCallback *callback)
+  : m_queryId(queryId),
+    m_callback(callback),
+    m_database(nullptr),
+    m_cancelled(false),
+    m_finished(false)
+{ }
+
+bool CDatabaseQueryJob::CState::IsCallback(const IDatabaseQueryCallback *callback) const
+{
+  CSingleLock lock(m_critical);
+  return m_callback == callback;
+}
+
+bool CDatabaseQueryJob::CState::IsCancelled() const
+{
+  CSingleLock lock(m_critical);
+  return m_cancelled;
+}
+
+bool CDatabaseQueryJob::CState::IsFinished() const
+{
+  CSingleLock lock(m_critical);
+  return m_finished;
+}
+
+void CDatabaseQueryJob::CState::Cancel(bool detach)
+{
+  {
+    CSingleLock lock(m_critical);
+    m_cancelled = true;
+    if (m_database != nullptr)
+      m_database->Interrupt();
+  }
+
+  if (detach)
+  {
+    // wait for a callback running on another thread before dropping it
+    CSingleLock callbackLock(m_callbackSection);
+    CSingleLock lock(m_critical);
+    m_callback = nullptr;
+  }
+}
+
+bool CDatabaseQueryJob::CState::SetDatabase(CDatabase *database)
+{
+  CSingleLock lock(m_critical);
+  m_database = database;
+  return !m_cancelled;
+}
+
+bool CDatabaseQueryJob::CState::OnItems(CFileItemList &items)
+{
+  // the callback runs without m_critical so that it can't hold up Cancel()
+  CSingleLock callbackLock(m_callbackSection);
+  IDatabaseQueryCallback *callback;
+  {
+    CSingleLock lock(m_critical);
+    if (m_cancelled)
+      return false;
+    callback = m_callback;
+  }
+
+  return callback != nullptr && callback->OnQueryItems(m_queryId, items);
+}
+
+void CDatabaseQueryJob::CState::Finish(bool success, CFileItemList &items)
+{
+  CSingleLock callbackLock(m_callbackSection);
+  IDatabaseQueryCallback *callback;
+  {
+    CSingleLock lock(m_critical);
+    if (m_finished)
+      return;
+    m_finished = true;
+    m_database = nullptr;
+    success = success && !m_cancelled;
+    callback = m_callback;
+  }
+
+  if (callback == nullptr)
+    return;
+
+  // the last batch is handed out even if it's empty as it carries the
+  // properties of the whole result (e.g. the total number of items)
+  if (success)
+    success = callback->OnQueryItems(m_queryId, items);
+  callback->OnQueryDone(m_queryId, success);
+}
+
+CDatabaseQueryJob::CDatabaseQueryJob(unsigned int queryId, IDatabaseQueryCallback *callback, unsigned int batchSize)
+  : m_state(std::make_shared<CState>(queryId, callback)),
+    m_batchSize(batchSize)
+{ }
+
+CDatabaseQueryJob::~CDatabaseQueryJob()
+{
+  // the job manager deletes jobs it cancels before they have run
+  CFileItemList items;
+  m_state->Finish(false, items);
+}
+
+bool CDatabaseQueryJob::operator==(const CJob* job) const
+{
+  // CJobQueue finds its running jobs through this
+  if (strcmp(job->GetType(), GetType()) != 0)
+    return false;
+
+  const CDatabaseQueryJob* queryJob = static_cast<const CDatabaseQueryJob*>(job);
+  return queryJob->m_state->GetQueryId() == m_state->GetQueryId();
+}
+
+bool CDatabaseQueryJob::DoWork()
+{
+  CFileItemList items;
+  if (m_state->IsCancelled())
+  {
+    m_state->Finish(false, items);
+    return false;
+  }
+
+  std::unique_ptr<CDatabase> db(OpenDatabase());
+  if (db == nullptr)
+  {
+    CLog::Log(LOGERROR, "%s - unable to open the database for query %u", __FUNCTION__, m_state->GetQueryId());
+    m_state->Finish(false, items);
+    return false;
+  }
+
+  bool success = false;
+  if (m_state->SetDatabase(db.get()))
+  {
+    db->SetItemsCallback(std::bind(&CState::OnItems, m_state, std::placeholders::_1), m_batchSize);
+    success = RunQuery(*db, items);
+    db->SetItemsCallback(CDatabase::ItemsCallback());
+  }
+  m_state->SetDatabase(nullptr);
+
+  m_state->Finish(success, items);
+  return success;
+}
+
+CDatabaseQueryQueue::CDatabaseQueryQueue()
+  // run two queries side by side so that a long listing doesn't hold up every other one
+  : CJobQueue(false, 2, CJob::PRIORITY_HIGH),
+    m_queryCounter(0)
+{ }
+
+CDatabaseQueryQueue::~CDatabaseQueryQueue()
+{
+  // the callbacks may be gone already, so don't call them for the jobs deleted by CJobQueue
+  CancelMatching([](const CDatabaseQueryJob::CState &query) { return true; }, true);
+}
+
+CDatabaseQueryQueue& CDatabaseQueryQueue::GetInstance()
+{
+  static CDatabaseQueryQueue s_instance;
+  return s_instance;
+}
+
+void CDatabaseQueryQueue::AddQueryJob(CDatabaseQueryJob *job)
+{
+  CSingleLock lock(m_critical);
+  for (auto it = m_queries.begin(); it != m_queries.end();)
+  {
+    if (it->second->IsFinished())
+      it = m_queries.erase(it);
+    else
+      ++it;
+  }
+
+  m_queries.insert(std::make_pair(job->GetState()->GetQueryId(), job->GetState()));
+  AddJob(job);
+}
+
+void CDatabaseQueryQueue::CancelQuery(unsigned int queryId)
+{
+  CancelMatching([queryId](const CDatabaseQueryJob::CState &query) { return query.GetQueryId() == queryId; }, true);
+}
+
+void CDatabaseQueryQueue::CancelQueries(IDatabaseQueryCallback *callback)
+{
+  CancelMatching([callback](const CDatabaseQueryJob::CState &query) { return query.IsCallback(callback); }, true);
+}
+
+void CDatabaseQueryQueue::CancelAllQueries()
+{
+  CancelMatching([](const CDatabaseQueryJob::CState &query) { return true; }, false);
+}
+
+void CDatabaseQueryQueue::CancelMatching(const std::function<bool(const CDatabaseQueryJob::CState &query)> &match, bool detach)
+{
+  std::vector<CDatabaseQueryJob::StatePtr> queries;
+  {
+    CSingleLock lock(m_critical);
+    for (const auto &query : m_queries)
+    {
+      if (match(*query.second))
+        queries.push_back(query.second);
+    }
+  }
+
+  // cancelling may wait for a callback, which in turn may add a query
+  for (const auto &query : queries)
+    query->Cancel(detach);
+}
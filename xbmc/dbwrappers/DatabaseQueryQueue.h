@@ -0,0 +1,252 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <functional>
+#include <map>
+#include <memory>
+
+#include "FileItem.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
+
+class CDatabase;
+
+/*!
+ \brief Receives the results of a query run by CDatabaseQueryQueue.
+
+ Both functions are called from the thread running the query, so they
+ should hand the items over to the caller's thread rather than touch the
+ GUI directly. No lock of the queue is held while they run, so they may add
+ or cancel queries, but they must not wait on a thread that is cancelling
+ their own query through CDatabaseQueryQueue::CancelQuery() or CancelQueries().
+ */
+class IDatabaseQueryCallback
+{
+public:
+  virtual ~IDatabaseQueryCallback() = default;
+
+  /*!
+   \brief Called with the next batch of items of a query.
+
+   \param[in] queryId Id of the query as returned by CDatabaseQueryQueue::AddQuery()
+   \param[in] items The items of the batch, in their final order. The list of
+              the last batch also carries the properties set by the query.
+   \return True to carry on with the query, false to cancel it
+   */
+  virtual bool OnQueryItems(unsigned int queryId, CFileItemList &items) = 0;
+
+  /*!
+   \brief Called exactly once when the query has finished, failed or was
+          cancelled through CDatabaseQueryQueue::CancelAllQueries() or the
+          job manager, unless it was cancelled through
+          CDatabaseQueryQueue::CancelQuery() or CancelQueries().
+
+   \param[in] queryId Id of the query as returned by CDatabaseQueryQueue::AddQuery()
+   \param[in] success Whether the query ran to completion
+   */
+  virtual void OnQueryDone(unsigned int queryId, bool success) = 0;
+};
+
+/*!
+ \brief Job running a single library query for CDatabaseQueryQueue.
+ */
+class CDatabaseQueryJob : public CJob
+{
+public:
+  /*!
+   \brief State of a query, shared between its job and the queue so that
+          it stays valid after the job manager has deleted the job.
+   */
+  class CState
+  {
+  public:
+    CState(unsigned int queryId, IDatabaseQueryCallback *callback);
+
+    unsigned int GetQueryId() const { return m_queryId; }
+    bool IsCallback(const IDatabaseQueryCallback *callback) const;
+    bool IsCancelled() const;
+    bool IsFinished() const;
+
+    /*!
+     \brief Cancel the query, interrupting the statement currently executed.
+     \param[in] detach Whether to drop the callback. If true, this waits for a
+                callback running on another thread, and no callback is called
+                for the query once this returns.
+     */
+    void Cancel(bool detach);
+
+    /*!
+     \brief Set the database the query runs on, or nullptr once it's done with it.
+     \return False if the query has been cancelled
+     */
+    bool SetDatabase(CDatabase *database);
+
+    bool OnItems(CFileItemList &items);
+    void Finish(bool success, CFileItemList &items);
+
+  private:
+    const unsigned int m_queryId;
+
+    mutable CCriticalSection m_critical;  ///< guards the members below
+    CCriticalSection m_callbackSection;   ///< held while calling m_callback
+    IDatabaseQueryCallback *m_callback;
+    CDatabase *m_database;
+    bool m_cancelled;
+    bool m_finished;
+  };
+  typedef std::shared_ptr<CState> StatePtr;
+
+  CDatabaseQueryJob(unsigned int queryId, IDatabaseQueryCallback *callback, unsigned int batchSize);
+  ~CDatabaseQueryJob() override;
+
+  const char *GetType() const override { return "databasequery"; }
+  bool operator==(const CJob* job) const override;
+  bool DoWork() override;
+
+  const StatePtr& GetState() const { return m_state; }
+
+protected:
+  /*!
+   \brief Create and open the database the query runs on.
+   \return The opened database or nullptr on failure
+   */
+  virtual CDatabase* OpenDatabase() = 0;
+
+  /*!
+   \brief Run the query on the given database, which was returned by OpenDatabase().
+   */
+  virtual bool RunQuery(CDatabase &db, CFileItemList &items) = 0;
+
+private:
+  StatePtr m_state;
+  unsigned int m_batchSize;
+};
+
+template<class TDatabase>
+class CDatabaseQueryJobT : public CDatabaseQueryJob
+{
+public:
+  typedef std::function<bool(TDatabase &db, CFileItemList &items)> Query;
+
+  CDatabaseQueryJobT(unsigned int queryId, const Query &query, IDatabaseQueryCallback *callback, unsigned int batchSize)
+    : CDatabaseQueryJob(queryId, callback, batchSize),
+      m_query(query)
+  { }
+
+protected:
+  CDatabase* OpenDatabase() override
+  {
+    TDatabase *db = new TDatabase();
+    if (!db->Open())
+    {
+      delete db;
+      return nullptr;
+    }
+    return db;
+  }
+
+  bool RunQuery(CDatabase &db, CFileItemList &items) override
+  {
+    return m_query(static_cast<TDatabase&>(db), items);
+  }
+
+private:
+  Query m_query;
+};
+
+/*!
+ \brief Queue running library queries off the calling thread.
+
+ Every query gets its own database connection and hands its results out in
+ batches through an IDatabaseQueryCallback, so the caller can use the first
+ items before the whole result has been read and doesn't have to hold all of
+ them at once. A query can be cancelled at any point, which interrupts the
+ statement running on its connection.
+
+ Example:
+ \code
+ m_queryId = CDatabaseQueryQueue::GetInstance().AddQuery<CVideoDatabase>(
+   [](CVideoDatabase &db, CFileItemList &items) { return db.GetMoviesNav("videodb://movies/titles/", items); },
+   this);
+ \endcode
+ */
+class CDatabaseQueryQueue : protected CJobQueue
+{
+public:
+  ~CDatabaseQueryQueue() override;
+
+  /*!
+   \brief Gets the singleton instance of the database query queue.
+   */
+  static CDatabaseQueryQueue& GetInstance();
+
+  /*!
+   \brief Enqueue a query.
+
+   \param[in] query Function running the query on an opened database of type TDatabase
+   \param[in] callback Callback receiving the results of the query
+   \param[in] batchSize Number of items to pass to the callback at once
+   \return Id of the query, used to cancel it
+   */
+  template<class TDatabase>
+  unsigned int AddQuery(const typename CDatabaseQueryJobT<TDatabase>::Query &query, IDatabaseQueryCallback *callback, unsigned int batchSize = 100)
+  {
+    CSingleLock lock(m_critical);
+    unsigned int queryId = ++m_queryCounter;
+    AddQueryJob(new CDatabaseQueryJobT<TDatabase>(queryId, query, callback, batchSize));
+    return queryId;
+  }
+
+  /*!
+   \brief Cancel the query with the given id if it hasn't finished yet.
+          No callback is called for the query once this returns.
+   */
+  void CancelQuery(unsigned int queryId);
+
+  /*!
+   \brief Cancel all queries reporting to the given callback.
+          No callback is called for them once this returns, so this
+          must be called before the callback is destroyed.
+   */
+  void CancelQueries(IDatabaseQueryCallback *callback);
+
+  /*!
+   \brief Cancel all queries. Their callbacks are still told through
+          IDatabaseQueryCallback::OnQueryDone() so that no caller keeps
+          waiting for a result.
+   */
+  void CancelAllQueries();
+
+private:
+  CDatabaseQueryQueue();
+  CDatabaseQueryQueue(const CDatabaseQueryQueue&) = delete;
+  CDatabaseQueryQueue const& operator=(CDatabaseQueryQueue const&) = delete;
+
+  void AddQueryJob(CDatabaseQueryJob *job);
+  void CancelMatching(const std::function<bool(const CDatabaseQueryJob::CState &query)> &match, bool detach);
+
+  std::map<unsigned int, CDatabaseQueryJob::StatePtr> m_queries;
+  unsigned int m_queryCounter;
+  CCriticalSection m_critical;
+};
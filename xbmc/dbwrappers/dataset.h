@@ -308,6 +308,11 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exec Sql */
   virtual bool query(const std::string &sql) = 0;
+/* as query, but rows are fetched one at a time while walking forward with
+   next(). Only the current row is held, so num_rows(), first(), prev(),
+   last() and seek() don't apply. Backends without a streaming cursor
+   materialise the whole result like query() does. */
+  virtual bool query_forward(const std::string &sql) { return query(sql); }
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
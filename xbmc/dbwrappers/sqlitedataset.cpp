@@ -26,10 +26,15 @@
  *
  **********************************************************************/
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <string>
 
 #include "sqlitedataset.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 #include "system.h" // for Sleep(), OutputDebugString() and GetLastError()
 #include "utils/URIUtils.h"
@@ -77,6 +82,137 @@ int callback(void* res_ptr,int ncol, char** result,char** cols)
   return 0;  
 }
 
+static void read_columns(sqlite3_stmt *stmt, sql_record &rec)
+{
+  const unsigned int numColumns = rec.size();
+  for (unsigned int i = 0; i < numColumns; i++)
+  {
+    field_value &v = rec.at(i);
+    switch (sqlite3_column_type(stmt, i))
+    {
+    case SQLITE_INTEGER:
+      v.set_asInt64(sqlite3_column_int64(stmt, i));
+      break;
+    case SQLITE_FLOAT:
+      v.set_asDouble(sqlite3_column_double(stmt, i));
+      break;
+    case SQLITE_TEXT:
+      v.set_asString((const char *)sqlite3_column_text(stmt, i));
+      break;
+    case SQLITE_BLOB:
+      v.set_asString((const char *)sqlite3_column_text(stmt, i));
+      break;
+    case SQLITE_NULL:
+    default:
+      v.set_asString("");
+      v.set_isNull();
+      break;
+    }
+  }
+}
+
+//************* Idle connection pool ***************************
+
+struct idle_connection
+{
+  std::string path;
+  sqlite3 *conn;
+  SqliteDatabase::StatementCache statements;
+  unsigned int since; // when the connection was handed to the pool
+};
+
+class idle_connections
+{
+public:
+  idle_connections() : timeout(30000) {}
+  ~idle_connections() { close(""); }
+
+  bool take(const std::string &path, sqlite3 *&conn, SqliteDatabase::StatementCache &statements)
+  {
+    CSingleLock lock(section);
+    expire();
+    for (std::list<idle_connection>::iterator i = pool.begin(); i != pool.end(); ++i)
+    {
+      if (i->path == path)
+      {
+        conn = i->conn;
+        statements.swap(i->statements);
+        pool.erase(i);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool give(const std::string &path, sqlite3 *conn, SqliteDatabase::StatementCache &statements, unsigned int max_idle)
+  {
+    CSingleLock lock(section);
+    expire();
+    unsigned int idle = 0;
+    for (std::list<idle_connection>::const_iterator i = pool.begin(); i != pool.end(); ++i)
+    {
+      if (i->path == path && ++idle >= max_idle)
+        return false;
+    }
+    pool.push_front(idle_connection());
+    pool.front().path = path;
+    pool.front().conn = conn;
+    pool.front().statements.swap(statements);
+    pool.front().since = XbmcThreads::SystemClockMillis();
+    return true;
+  }
+
+  void close(const std::string &path)
+  {
+    CSingleLock lock(section);
+    for (std::list<idle_connection>::iterator i = pool.begin(); i != pool.end();)
+    {
+      if (path.empty() || i->path == path)
+        i = close(i);
+      else
+        ++i;
+    }
+  }
+
+  void set_timeout(unsigned int ms)
+  {
+    CSingleLock lock(section);
+    timeout = ms;
+  }
+
+private:
+  std::list<idle_connection>::iterator close(std::list<idle_connection>::iterator i)
+  {
+    for (SqliteDatabase::StatementCache::iterator j = i->statements.begin(); j != i->statements.end(); ++j)
+      sqlite3_finalize(j->second);
+    sqlite3_close_v2(i->conn);
+    return pool.erase(i);
+  }
+
+  // connections nobody asked for in a while don't keep their file open
+  void expire()
+  {
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    for (std::list<idle_connection>::iterator i = pool.begin(); i != pool.end();)
+    {
+      if (now - i->since >= timeout)
+        i = close(i);
+      else
+        ++i;
+    }
+  }
+
+  CCriticalSection section;
+  std::list<idle_connection> pool;
+  unsigned int timeout;
+};
+
+static idle_connections& get_idle_connections()
+{
+  static idle_connections s_idle;
+  return s_idle;
+}
+
 static int busy_callback(void*, int busyCount)
 {
   Sleep(100);
@@ -89,6 +225,10 @@ SqliteDatabase::SqliteDatabase() {
 
   active = false;  
   _in_transaction = false;    // for transaction
+  conn = NULL;
+  pool_size = 0;
+  stmt_hits = 0;
+  stmt_misses = 0;
 
   error = "Unknown database error";//S_NO_CONNECTION;
   host = "localhost";
@@ -214,6 +354,13 @@ int SqliteDatabase::connect(bool create) {
   try
   {
     disconnect();
+    fullpath = db_fullpath;
+    if (pool_size > 0 && get_idle_connections().take(fullpath, conn, stmt_cache))
+    {
+      active = true;
+      return DB_CONNECTION_OK;
+    }
+
     int flags = SQLITE_OPEN_READWRITE;
     if (create)
       flags |= SQLITE_OPEN_CREATE;
@@ -257,10 +404,123 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
-  sqlite3_close(conn);
+  if (!pool_connection())
+  {
+    clear_statements();
+    // a dataset may still hold an open cursor, in which case the connection
+    // is closed once that statement has been finalized
+    sqlite3_close_v2(conn);
+  }
+  conn = NULL;
   active = false;
 }
 
+bool SqliteDatabase::pool_connection() {
+  if (pool_size == 0 || _in_transaction || !sqlite3_get_autocommit(conn))
+    return false;
+
+  // only statements sitting in our cache may be left on the connection,
+  // anything else still belongs to a dataset
+  for (sqlite3_stmt *stmt = sqlite3_next_stmt(conn, NULL); stmt; stmt = sqlite3_next_stmt(conn, stmt))
+  {
+    bool cached = false;
+    for (StatementCache::const_iterator i = stmt_cache.begin(); i != stmt_cache.end() && !cached; ++i)
+      cached = i->second == stmt;
+    if (!cached)
+      return false;
+  }
+
+  // temporary tables, views and triggers live as long as the connection, don't hand them on
+  sqlite3_stmt *stmt = NULL;
+  if (sqlite3_prepare_v2(conn, "SELECT count(*) FROM sqlite_temp_master", -1, &stmt, NULL) != SQLITE_OK)
+    return false;
+  bool clean = sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_int(stmt, 0) == 0;
+  sqlite3_finalize(stmt);
+  if (!clean)
+    return false;
+
+  return get_idle_connections().give(fullpath, conn, stmt_cache, pool_size);
+}
+
+void SqliteDatabase::closeIdleConnections(const std::string &path) {
+  get_idle_connections().close(path);
+}
+
+void SqliteDatabase::setIdleTimeout(unsigned int ms) {
+  get_idle_connections().set_timeout(ms);
+}
+
+sqlite3_stmt *SqliteDatabase::acquire_statement(const std::string &sql) {
+  for (StatementCache::iterator i = stmt_cache.begin(); i != stmt_cache.end(); ++i)
+  {
+    if (i->first == sql)
+    {
+      sqlite3_stmt *stmt = i->second;
+      stmt_cache.erase(i);
+      stmt_hits++;
+      return stmt;
+    }
+  }
+
+  stmt_misses++;
+  sqlite3_stmt *stmt = NULL;
+  if (setErr(sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, NULL), sql.c_str()) != SQLITE_OK)
+  {
+    sqlite3_finalize(stmt);
+    throw DbErrors(getErrorMsg());
+  }
+  return stmt;
+}
+
+void SqliteDatabase::release_statement(const std::string &sql, sqlite3_stmt *stmt) {
+  if (stmt == NULL)
+    return;
+
+  // an idle statement must not keep its read transaction open
+  sqlite3_reset(stmt);
+
+  if (!active)
+  {
+    sqlite3_finalize(stmt);
+    return;
+  }
+
+  for (StatementCache::const_iterator i = stmt_cache.begin(); i != stmt_cache.end(); ++i)
+  {
+    if (i->first == sql)
+    { // another dataset ran the same query at the same time
+      sqlite3_finalize(stmt);
+      return;
+    }
+  }
+
+  // don't let one-off queries push out the statements that do run again
+  const size_t hash = std::hash<std::string>()(sql);
+  std::list<size_t>::iterator seen = std::find(stmt_seen.begin(), stmt_seen.end(), hash);
+  if (seen == stmt_seen.end())
+  {
+    stmt_seen.push_front(hash);
+    if (stmt_seen.size() > max_seen_statements)
+      stmt_seen.pop_back();
+    sqlite3_finalize(stmt);
+    return;
+  }
+  stmt_seen.erase(seen);
+
+  stmt_cache.push_front(std::make_pair(sql, stmt));
+  if (stmt_cache.size() > max_cached_statements)
+  {
+    sqlite3_finalize(stmt_cache.back().second);
+    stmt_cache.pop_back();
+  }
+}
+
+void SqliteDatabase::clear_statements() {
+  for (StatementCache::iterator i = stmt_cache.begin(); i != stmt_cache.end(); ++i)
+    sqlite3_finalize(i->second);
+  stmt_cache.clear();
+}
+
 int SqliteDatabase::create() {
   return connect(true);
 }
@@ -356,6 +616,7 @@ int SqliteDatabase::drop_analytics(void) {
 int SqliteDatabase::drop() {
   if (active == false) throw DbErrors("Can't drop database: no active connection...");
   disconnect();
+  closeIdleConnections(fullpath);
   if (!unlink(db.c_str())) {
      throw DbErrors("Can't drop database: can't unlink the file %s,\nError: %s",db.c_str(),strerror(errno));
      }
@@ -451,6 +712,7 @@ SqliteDataset::SqliteDataset():Dataset() {
   db = NULL;
   errmsg = NULL;
   autorefresh = false;
+  cursor_stmt = NULL;
 }
 
 
@@ -459,9 +721,12 @@ SqliteDataset::SqliteDataset(SqliteDatabase *newDb):Dataset(newDb) {
   db = newDb;
   errmsg = NULL;
   autorefresh = false;
+  cursor_stmt = NULL;
 }
 
  SqliteDataset::~SqliteDataset(){
+   // the database may already be gone, so don't hand the cursor back to it
+   if (cursor_stmt) sqlite3_finalize(cursor_stmt);
    if (errmsg) sqlite3_free(errmsg);
  }
 
@@ -481,6 +746,35 @@ sqlite3* SqliteDataset::handle(){
   else return NULL;
 }
 
+bool SqliteDataset::step_cursor() {
+  const int rc = sqlite3_step(cursor_stmt);
+  if (rc == SQLITE_ROW)
+  {
+    read_columns(cursor_stmt, *result.records[0]);
+    return true;
+  }
+  if (rc == SQLITE_DONE)
+  {
+    release_cursor();
+    return false;
+  }
+
+  db->setErr(rc, cursor_sql.c_str());
+  sqlite3_finalize(cursor_stmt);
+  cursor_stmt = NULL;
+  cursor_sql.clear();
+  throw DbErrors(db->getErrorMsg());
+}
+
+void SqliteDataset::release_cursor() {
+  if (cursor_stmt == NULL)
+    return;
+
+  static_cast<SqliteDatabase*>(db)->release_statement(cursor_sql, cursor_stmt);
+  cursor_stmt = NULL;
+  cursor_sql.clear();
+}
+
 void SqliteDataset::make_query(StringList &_sql) {
   std::string query;
   if (db == NULL) throw DbErrors("No Database Connection");
@@ -646,9 +940,8 @@ bool SqliteDataset::query(const std::string &query) {
 
   close();
 
-  sqlite3_stmt *stmt = NULL;
-  if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
-    throw DbErrors(db->getErrorMsg());
+  SqliteDatabase *sqlite = static_cast<SqliteDatabase*>(db);
+  sqlite3_stmt *stmt = sqlite->acquire_statement(query);
 
   // column headers
   const unsigned int numColumns = sqlite3_column_count(stmt);
@@ -657,47 +950,59 @@ bool SqliteDataset::query(const std::string &query) {
     result.record_header[i].name = sqlite3_column_name(stmt, i);
 
   // returned rows
-  while (sqlite3_step(stmt) == SQLITE_ROW)
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
   { // have a row of data
     sql_record *res = new sql_record;
     res->resize(numColumns);
-    for (unsigned int i = 0; i < numColumns; i++)
-    {
-      field_value &v = res->at(i);
-      switch (sqlite3_column_type(stmt, i))
-      {
-      case SQLITE_INTEGER:
-        v.set_asInt64(sqlite3_column_int64(stmt, i));
-        break;
-      case SQLITE_FLOAT:
-        v.set_asDouble(sqlite3_column_double(stmt, i));
-        break;
-      case SQLITE_TEXT:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_BLOB:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_NULL:
-      default:
-        v.set_asString("");
-        v.set_isNull();
-        break;
-      }
-    }
+    read_columns(stmt, *res);
     result.records.push_back(res);
   }
-  if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
+  if (rc != SQLITE_DONE)
   {
-    active = true;
-    ds_state = dsSelect;
-    this->first();
-    return true;
+    db->setErr(rc, query.c_str());
+    sqlite3_finalize(stmt);
+    throw DbErrors(db->getErrorMsg());
+  }
+
+  sqlite->release_statement(query, stmt);
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
+bool SqliteDataset::query_forward(const std::string &query) {
+  if(!handle()) throw DbErrors("No Database Connection");
+  if (query.find("select") == std::string::npos && query.find("SELECT") == std::string::npos)
+    throw DbErrors("MUST be select SQL!");
+
+  close();
+
+  cursor_stmt = static_cast<SqliteDatabase*>(db)->acquire_statement(query);
+  cursor_sql = query;
+
+  // column headers
+  const unsigned int numColumns = sqlite3_column_count(cursor_stmt);
+  result.record_header.resize(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+    result.record_header[i].name = sqlite3_column_name(cursor_stmt, i);
+
+  // a single record is refilled for every row the cursor steps onto
+  result.records.push_back(new sql_record(numColumns));
+
+  active = true;
+  ds_state = dsSelect;
+  frecno = 0;
+  fbof = feof = !step_cursor();
+  if (feof)
+  { // keep the column headers, but report an empty result
+    delete result.records[0];
+    result.records.clear();
   }
   else
-  {
-    throw DbErrors(db->getErrorMsg());
-  }  
+    fill_fields();
+  return true;
 }
 
 void SqliteDataset::open(const std::string &sql) {
@@ -716,6 +1021,7 @@ void SqliteDataset::open() {
 
 
 void SqliteDataset::close() {
+  release_cursor();
   Dataset::close();
   result.clear();
   edit_object->clear();
@@ -766,6 +1072,16 @@ void SqliteDataset::prev(void) {
 }
 
 void SqliteDataset::next(void) {
+  if (cursor_stmt)
+  {
+    if (ds_state != dsSelect)
+      return;
+    fbof = false;
+    feof = !step_cursor();
+    if (!feof)
+      fill_fields();
+    return;
+  }
   Dataset::next();
   if (!eof()) 
       fill_fields();
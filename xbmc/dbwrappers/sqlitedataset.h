@@ -29,6 +29,9 @@
  **********************************************************************/
 
 #include <stdio.h>
+#include <list>
+#include <string>
+#include <utility>
 #include "dataset.h"
 #include <sqlite3.h>
 
@@ -39,12 +42,34 @@ namespace dbiplus {
 
 ******************************************************************/
 class SqliteDatabase: public Database {
+public:
+/* prepared statements kept for reuse, most recently released first */
+  typedef std::list<std::pair<std::string, sqlite3_stmt*> > StatementCache;
+
 protected:
 /* connect descriptor */
   sqlite3 *conn;
   bool _in_transaction;
   int last_err;
 
+  StatementCache stmt_cache;
+  static const size_t max_cached_statements = 32;
+/* hashes of recently released statements that weren't cached. Most queries
+   have their values inlined and never run again, so a statement is only
+   cached the second time its sql text is released. */
+  std::list<size_t> stmt_seen;
+  static const size_t max_seen_statements = 64;
+  unsigned int stmt_hits;
+  unsigned int stmt_misses;
+
+/* full path of the connected database file */
+  std::string fullpath;
+/* idle connections to the same file that disconnect() may leave open */
+  unsigned int pool_size;
+/* hands the connection (and its statement cache) to the idle pool,
+   returns false if it can't be reused and has to be closed */
+  bool pool_connection();
+
 public:
 /* default constructor */
   SqliteDatabase();
@@ -70,6 +95,14 @@ public:
   virtual int connect(bool create);
 /* func. disconnects from database-server */
   virtual void disconnect();
+/* number of idle connections per database file kept open after disconnect()
+   so the next connect() to that file can reuse them, 0 disables pooling */
+  void setPoolSize(unsigned int size) { pool_size = size; }
+/* closes the pooled idle connections to the given file, or all of them */
+  static void closeIdleConnections(const std::string &path = "");
+/* pooled connections idle for longer are closed on the next connect() or
+   disconnect() to any file, 30 seconds by default */
+  static void setIdleTimeout(unsigned int ms);
 /* func. creates new database */
   virtual int create();
 /* func. deletes database */
@@ -96,6 +129,18 @@ public:
 
   bool in_transaction() {return _in_transaction;}; 	
 
+/* statement cache: acquire returns a ready to step statement for the sql
+   text, preparing it if it isn't cached. Release resets the statement and
+   hands it back for reuse, finalizing the least recently used one if the
+   cache is full. */
+  sqlite3_stmt *acquire_statement(const std::string &sql);
+  void release_statement(const std::string &sql, sqlite3_stmt *stmt);
+  void clear_statements();
+/* number of acquired statements that were cached and that had to be prepared */
+  unsigned int statement_hits() const { return stmt_hits; }
+  unsigned int statement_misses() const { return stmt_misses; }
+  size_t cached_statements() const { return stmt_cache.size(); }
+
 };
 
 
@@ -127,6 +172,12 @@ protected:
 /* Changing field values during dataset navigation */
   virtual void free_row();  // free the memory allocated for the current row
 
+/* streaming cursor opened by query_forward() */
+  sqlite3_stmt *cursor_stmt;
+  std::string cursor_sql;
+  bool step_cursor();
+  void release_cursor();
+
 public:
 /* constructor */
   SqliteDataset();
@@ -148,6 +199,7 @@ or insert() operations default = false) */
   virtual const void* getExecRes();
 /* as open, but with our query exec Sql */
   virtual bool query(const std::string &query);
+  virtual bool query_forward(const std::string &query);
 /* func. closes a query */
   virtual void close(void);
 /* Cancel changes, made in insert or edit states of dataset */
@@ -0,0 +1,278 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "dbwrappers/Database.h"
+#include "dbwrappers/DatabaseQueryQueue.h"
+#include "dbwrappers/dataset.h"
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/Variant.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+const int NUMBERS = 250;
+
+class CTestQueryDatabase : public CDatabase
+{
+public:
+  bool Open() override
+  {
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    settings.name = GetBaseDBName();
+    return Connect(settings.name, settings, true);
+  }
+
+  static std::string GetPath()
+  {
+    return URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "TestDatabaseQueryQueue.db");
+  }
+
+  bool GetNumbers(CFileItemList &items)
+  {
+    if (!m_pDS->query("SELECT n FROM numbers ORDER BY n"))
+      return false;
+
+    while (!m_pDS->eof())
+    {
+      int n = m_pDS->fv(0).get_asInt();
+      CFileItemPtr item(new CFileItem(StringUtils::Format("%i", n)));
+      item->SetProperty("n", n);
+      items.Add(item);
+      if (!StreamItems(items))
+      {
+        m_pDS->close();
+        return false;
+      }
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    items.SetProperty("total", NUMBERS);
+    return true;
+  }
+
+protected:
+  void CreateTables() override
+  {
+    m_pDS->exec("CREATE TABLE numbers (n INTEGER)");
+    for (int n = 0; n < NUMBERS; n++)
+      m_pDS->exec(PrepareSQL("INSERT INTO numbers (n) VALUES (%i)", n));
+  }
+
+  void CreateAnalytics() override { }
+  int GetSchemaVersion() const override { return 1; }
+  const char *GetBaseDBName() const override { return "TestDatabaseQueryQueue"; }
+};
+
+class CTestQueryCallback : public IDatabaseQueryCallback
+{
+public:
+  bool OnQueryItems(unsigned int queryId, CFileItemList &items) override
+  {
+    std::vector<int> batch;
+    for (int i = 0; i < items.Size(); i++)
+      batch.push_back(static_cast<int>(items[i]->GetProperty("n").asInteger()));
+
+    bool first;
+    {
+      CSingleLock lock(m_critical);
+      m_batches.push_back(batch);
+      if (items.HasProperty("total"))
+        m_total = static_cast<int>(items.GetProperty("total").asInteger());
+      first = m_batches.size() == 1;
+    }
+
+    if (first)
+    {
+      m_firstBatch.Set();
+      m_proceed.WaitMSec(m_blockFirstBatch ? 5000 : 0);
+    }
+    return true;
+  }
+
+  void OnQueryDone(unsigned int queryId, bool success) override
+  {
+    CSingleLock lock(m_critical);
+    m_success = success;
+    m_doneCount++;
+    m_done.Set();
+  }
+
+  std::vector<std::vector<int>> GetBatches()
+  {
+    CSingleLock lock(m_critical);
+    return m_batches;
+  }
+
+  CCriticalSection m_critical;
+  std::vector<std::vector<int>> m_batches;
+  int m_total = -1;
+  bool m_success = false;
+  int m_doneCount = 0;
+
+  bool m_blockFirstBatch = false;
+  CEvent m_firstBatch;
+  CEvent m_proceed;
+  CEvent m_done;
+};
+
+unsigned int AddNumbersQuery(IDatabaseQueryCallback *callback, unsigned int batchSize)
+{
+  return CDatabaseQueryQueue::GetInstance().AddQuery<CTestQueryDatabase>(
+    [](CTestQueryDatabase &db, CFileItemList &items) { return db.GetNumbers(items); },
+    callback, batchSize);
+}
+}
+
+class TestDatabaseQueryQueue : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    XFILE::CFile::Delete(CTestQueryDatabase::GetPath());
+    CTestQueryDatabase db;
+    ASSERT_TRUE(db.Open());
+    db.Close();
+  }
+
+  void TearDown() override
+  {
+    dbiplus::SqliteDatabase::closeIdleConnections(CTestQueryDatabase::GetPath());
+    XFILE::CFile::Delete(CTestQueryDatabase::GetPath());
+  }
+};
+
+TEST_F(TestDatabaseQueryQueue, DeliversItemsInBatches)
+{
+  CTestQueryCallback callback;
+  AddNumbersQuery(&callback, 100);
+  ASSERT_TRUE(callback.m_done.WaitMSec(5000));
+
+  std::vector<std::vector<int>> batches = callback.GetBatches();
+  ASSERT_EQ(3U, batches.size());
+  EXPECT_EQ(100U, batches[0].size());
+  EXPECT_EQ(100U, batches[1].size());
+  EXPECT_EQ(50U, batches[2].size());
+
+  // every item arrives exactly once and in the order of the query
+  int expected = 0;
+  for (const auto &batch : batches)
+  {
+    for (int n : batch)
+      EXPECT_EQ(expected++, n);
+  }
+  EXPECT_EQ(NUMBERS, expected);
+
+  // the properties of the whole result come with the last batch
+  EXPECT_EQ(NUMBERS, callback.m_total);
+  EXPECT_TRUE(callback.m_success);
+  EXPECT_EQ(1, callback.m_doneCount);
+}
+
+TEST_F(TestDatabaseQueryQueue, HandsOutFullLastBatch)
+{
+  CTestQueryCallback callback;
+  AddNumbersQuery(&callback, NUMBERS);
+  ASSERT_TRUE(callback.m_done.WaitMSec(5000));
+
+  // the final, empty batch still carries the total
+  std::vector<std::vector<int>> batches = callback.GetBatches();
+  ASSERT_EQ(2U, batches.size());
+  EXPECT_EQ(static_cast<size_t>(NUMBERS), batches[0].size());
+  EXPECT_TRUE(batches[1].empty());
+  EXPECT_EQ(NUMBERS, callback.m_total);
+  EXPECT_TRUE(callback.m_success);
+}
+
+TEST_F(TestDatabaseQueryQueue, CancelAllQueriesStopsQueryAndReportsFailure)
+{
+  CTestQueryCallback callback;
+  callback.m_blockFirstBatch = true;
+  AddNumbersQuery(&callback, 10);
+  ASSERT_TRUE(callback.m_firstBatch.WaitMSec(5000));
+
+  // the callback is still running, so this must not wait for it
+  CDatabaseQueryQueue::GetInstance().CancelAllQueries();
+  callback.m_proceed.Set();
+
+  ASSERT_TRUE(callback.m_done.WaitMSec(5000));
+  EXPECT_EQ(1U, callback.GetBatches().size());
+  EXPECT_FALSE(callback.m_success);
+  EXPECT_EQ(1, callback.m_doneCount);
+}
+
+TEST_F(TestDatabaseQueryQueue, CancelQueryWaitsForRunningCallback)
+{
+  CTestQueryCallback callback;
+  callback.m_blockFirstBatch = true;
+  unsigned int queryId = AddNumbersQuery(&callback, 10);
+  ASSERT_TRUE(callback.m_firstBatch.WaitMSec(5000));
+
+  std::atomic<bool> cancelled(false);
+  std::thread canceller([&]() {
+    CDatabaseQueryQueue::GetInstance().CancelQuery(queryId);
+    cancelled = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(cancelled);
+
+  callback.m_proceed.Set();
+  canceller.join();
+
+  // no callback at all once CancelQuery() has returned
+  EXPECT_FALSE(callback.m_done.WaitMSec(500));
+  EXPECT_EQ(1U, callback.GetBatches().size());
+  EXPECT_EQ(0, callback.m_doneCount);
+}
+
+TEST_F(TestDatabaseQueryQueue, CallbackCanStopQuery)
+{
+  class CStopCallback : public CTestQueryCallback
+  {
+  public:
+    bool OnQueryItems(unsigned int queryId, CFileItemList &items) override
+    {
+      CTestQueryCallback::OnQueryItems(queryId, items);
+      return false;
+    }
+  } callback;
+
+  AddNumbersQuery(&callback, 10);
+  ASSERT_TRUE(callback.m_done.WaitMSec(5000));
+  EXPECT_EQ(1U, callback.GetBatches().size());
+  EXPECT_FALSE(callback.m_success);
+}
@@ -0,0 +1,285 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/URIUtils.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+using namespace dbiplus;
+
+namespace
+{
+int CountTempObjects(sqlite3 *conn)
+{
+  int count = -1;
+  sqlite3_stmt *stmt = NULL;
+  if (sqlite3_prepare_v2(conn, "SELECT count(*) FROM sqlite_temp_master", -1, &stmt, NULL) == SQLITE_OK &&
+      sqlite3_step(stmt) == SQLITE_ROW)
+    count = sqlite3_column_int(stmt, 0);
+  sqlite3_finalize(stmt);
+  return count;
+}
+
+void Marker(sqlite3_context *context, int, sqlite3_value**)
+{
+  sqlite3_result_int(context, 1);
+}
+
+bool HasMarker(sqlite3 *conn)
+{
+  sqlite3_stmt *stmt = NULL;
+  bool marked = sqlite3_prepare_v2(conn, "SELECT marker()", -1, &stmt, NULL) == SQLITE_OK;
+  sqlite3_finalize(stmt);
+  return marked;
+}
+
+void FailOnFive(sqlite3_context *context, int argc, sqlite3_value **argv)
+{
+  if (sqlite3_value_int(argv[0]) == 5)
+    sqlite3_result_error(context, "five", -1);
+  else
+    sqlite3_result_int(context, sqlite3_value_int(argv[0]));
+}
+}
+
+class TestSqliteDataset : public testing::Test
+{
+protected:
+  TestSqliteDataset()
+  {
+    m_host = CSpecialProtocol::TranslatePath("special://temp/");
+    m_path = URIUtils::AddFileToFolder(m_host, "TestSqliteDataset.db");
+  }
+
+  ~TestSqliteDataset()
+  {
+    SqliteDatabase::setIdleTimeout(30000);
+    SqliteDatabase::closeIdleConnections(m_path);
+    XFILE::CFile::Delete(m_path);
+  }
+
+  void Setup(SqliteDatabase &db)
+  {
+    db.setHostName(m_host.c_str());
+    db.setDatabase("TestSqliteDataset");
+    db.setPoolSize(1);
+  }
+
+  void CreateTable(SqliteDatabase &db, int rows)
+  {
+    std::unique_ptr<Dataset> ds(db.CreateDataset());
+    ds->exec("CREATE TABLE t (id integer primary key, name text)");
+    for (int i = 0; i < rows; i++)
+      ds->exec(db.prepare("INSERT INTO t (id, name) VALUES (%i, 'row %i')", i, i));
+  }
+
+  std::string m_host;
+  std::string m_path;
+};
+
+TEST_F(TestSqliteDataset, ReusesPooledConnection)
+{
+  SqliteDatabase db;
+  Setup(db);
+  ASSERT_EQ(DB_CONNECTION_OK, db.connect(true));
+  sqlite3 *conn = db.getHandle();
+  db.disconnect();
+
+  SqliteDatabase other;
+  Setup(other);
+  ASSERT_EQ(DB_CONNECTION_OK, other.connect(false));
+  EXPECT_EQ(conn, other.getHandle());
+  other.disconnect();
+}
+
+TEST_F(TestSqliteDataset, ClosesExpiredIdleConnections)
+{
+  SqliteDatabase db;
+  Setup(db);
+  ASSERT_EQ(DB_CONNECTION_OK, db.connect(true));
+  ASSERT_EQ(SQLITE_OK, sqlite3_create_function(db.getHandle(), "marker", 0, SQLITE_UTF8, NULL, Marker, NULL, NULL));
+  db.disconnect();
+
+  // the idle connection was closed rather than handed on
+  SqliteDatabase::setIdleTimeout(0);
+  SqliteDatabase other;
+  Setup(other);
+  ASSERT_EQ(DB_CONNECTION_OK, other.connect(false));
+  EXPECT_FALSE(HasMarker(other.getHandle()));
+  other.disconnect();
+}
+
+TEST_F(TestSqliteDataset, TempTablesDontLeakIntoPool)
+{
+  SqliteDatabase db;
+  Setup(db);
+  ASSERT_EQ(DB_CONNECTION_OK, db.connect(true));
+  ASSERT_EQ(SQLITE_OK, sqlite3_exec(db.getHandle(), "CREATE TEMPORARY TABLE songpaths (idPath integer, strPath varchar(512))", NULL, NULL, NULL));
+  EXPECT_EQ(1, CountTempObjects(db.getHandle()));
+  db.disconnect();
+
+  SqliteDatabase other;
+  Setup(other);
+  ASSERT_EQ(DB_CONNECTION_OK, other.connect(false));
+  EXPECT_EQ(0, CountTempObjects(other.getHandle()));
+  EXPECT_EQ(SQLITE_OK, sqlite3_exec(other.getHandle(), "CREATE TEMPORARY TABLE songpaths (idPath integer, strPath varchar(512))", NULL, NULL, NULL));
+  other.disconnect();
+}
+
+TEST_F(TestSqliteDataset, CachesRepeatedStatements)
+{
+  SqliteDatabase db;
+  Setup(db);
+  ASSERT_EQ(DB_CONNECTION_OK, db.connect(true));
+  CreateTable(db, 10);
+  std::unique_ptr<Dataset> ds(db.CreateDataset());
+  unsigned int hits = db.statement_hits();
+  unsigned int misses = db.statement_misses();
+
+  // a query that runs once isn't cached
+  ASSERT_TRUE(ds->query("SELECT name FROM t WHERE id=1"));
+  ds->close();
+  EXPECT_EQ(0U, db.cached_statements());
+
+  // the second time it is, and the third time it's reused
+  ASSERT_TRUE(ds->query("SELECT name FROM t WHERE id=1"));
+  ds->close();
+  EXPECT_EQ(1U, db.cached_statements());
+  ASSERT_TRUE(ds->query("SELECT name FROM t WHERE id=1"));
+  EXPECT_EQ("row 1", ds->fv(0).get_asString());
+  ds->close();
+
+  EXPECT_EQ(hits + 1, db.statement_hits());
+  EXPECT_EQ(misses + 2, db.statement_misses());
+  db.disconnect();
+}
+
+TEST_F(TestSqliteDataset, EvictsLeastRecentlyUsedStatement)
+{
+  SqliteDatabase db;
+  Setup(db);
+  ASSERT_EQ(DB_CONNECTION_OK, db.connect(true));
+  CreateTable(db, 50);
+  std::unique_ptr<Dataset> ds(db.CreateDataset());
+
+  for (int pass = 0; pass < 2; pass++)
+  {
+    for (int i = 0; i < 40; i++)
+    {
+      ASSERT_TRUE(ds->query(db.prepare("SELECT name FROM t WHERE id=%i", i)));
+      ds->close();
+    }
+  }
+  EXPECT_EQ(32U, db.cached_statements());
+
+  // the most recent statements are kept, the oldest ones were finalized
+  unsigned int hits = db.statement_hits();
+  ASSERT_TRUE(ds->query("SELECT name FROM t WHERE id=39"));
+  ds->close();
+  EXPECT_EQ(hits + 1, db.statement_hits());
+
+  unsigned int misses = db.statement_misses();
+  ASSERT_TRUE(ds->query("SELECT name FROM t WHERE id=0"));
+  ds->close();
+  EXPECT_EQ(misses + 1, db.statement_misses());
+  db.disconnect();
+}
+
+TEST_F(TestSqliteDataset, ForwardCursor)
+{
+  SqliteDatabase db;
+  Setup(db);
+  ASSERT_EQ(DB_CONNECTION_OK, db.connect(true));
+  CreateTable(db, 100);
+  std::unique_ptr<Dataset> ds(db.CreateDataset());
+
+  ASSERT_TRUE(ds->query_forward("SELECT id, name FROM t ORDER BY id"));
+  int rows = 0;
+  while (!ds->eof())
+  {
+    EXPECT_EQ(rows, ds->fv("id").get_asInt());
+    EXPECT_EQ(db.prepare("row %i", rows), ds->fv(1).get_asString());
+    rows++;
+    ds->next();
+  }
+  EXPECT_EQ(100, rows);
+  ds->close();
+
+  // an empty result is at its end right away
+  ASSERT_TRUE(ds->query_forward("SELECT id, name FROM t WHERE id < 0"));
+  EXPECT_TRUE(ds->eof());
+  EXPECT_EQ(0, ds->num_rows());
+  ds->close();
+
+  // closing in the middle hands the statement back
+  for (int i = 0; i < 2; i++)
+  {
+    ASSERT_TRUE(ds->query_forward("SELECT id FROM t ORDER BY id"));
+    ds->next();
+    EXPECT_EQ(1, ds->fv(0).get_asInt());
+    ds->close();
+  }
+  EXPECT_EQ(1U, db.cached_statements());
+  db.disconnect();
+}
+
+TEST_F(TestSqliteDataset, ForwardCursorErrorMidIteration)
+{
+  SqliteDatabase db;
+  Setup(db);
+  ASSERT_EQ(DB_CONNECTION_OK, db.connect(true));
+  CreateTable(db, 10);
+  ASSERT_EQ(SQLITE_OK, sqlite3_create_function(db.getHandle(), "failonfive", 1, SQLITE_UTF8, NULL, FailOnFive, NULL, NULL));
+  std::unique_ptr<Dataset> ds(db.CreateDataset());
+
+  const std::string sql = "SELECT failonfive(id) FROM t ORDER BY id";
+  ASSERT_TRUE(ds->query_forward(sql));
+  int rows = 0;
+  bool failed = false;
+  try
+  {
+    while (!ds->eof())
+    {
+      EXPECT_EQ(rows, ds->fv(0).get_asInt());
+      rows++;
+      ds->next();
+    }
+  }
+  catch (const DbErrors&)
+  {
+    failed = true;
+  }
+  EXPECT_TRUE(failed);
+  EXPECT_EQ(5, rows);
+
+  // the failed statement is finalized rather than cached, and the dataset can be used again
+  ds->close();
+  EXPECT_EQ(0U, db.cached_statements());
+  EXPECT_EQ(nullptr, sqlite3_next_stmt(db.getHandle(), NULL));
+  ASSERT_TRUE(ds->query("SELECT count(*) FROM t"));
+  EXPECT_EQ(10, ds->fv(0).get_asInt());
+  ds->close();
+  db.disconnect();
+}
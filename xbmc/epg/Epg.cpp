@@ -20,6 +20,7 @@
 
 #include "Epg.h"
 
+#include <unordered_map>
 #include <utility>
 
 #include "addons/kodi-addon-dev-kit/include/kodi/xbmc_epg_types.h"
@@ -34,6 +35,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 
 
@@ -262,9 +264,10 @@ CEpgInfoTagPtr CEpg::GetTagByBroadcastId(unsigned int iUniqueBroadcastId) const
 CEpgInfoTagPtr CEpg::GetTagBetween(const CDateTime &beginTime, const CDateTime &endTime) const
 {
   CSingleLock lock(m_critSection);
-  for (std::map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); ++it)
+  // tags are sorted by start time, skip all tags starting before beginTime
+  for (auto it = m_tags.lower_bound(beginTime); it != m_tags.end() && it->first <= endTime; ++it)
   {
-    if (it->second->StartAsUTC() >= beginTime && it->second->EndAsUTC() <= endTime)
+    if (it->second->EndAsUTC() <= endTime)
       return it->second;
   }
 
@@ -276,15 +279,12 @@ std::vector<CEpgInfoTagPtr> CEpg::GetTagsBetween(const CDateTime &beginTime, con
   std::vector<CEpgInfoTagPtr> epgTags;
 
   CSingleLock lock(m_critSection);
-  for (const auto &infoTag : m_tags)
+  for (auto it = m_tags.lower_bound(beginTime); it != m_tags.end(); ++it)
   {
-    if (infoTag.second->StartAsUTC() >= beginTime)
-    {
-      if (infoTag.second->EndAsUTC() <= endTime)
-        epgTags.emplace_back(infoTag.second);
-      else
-        break; // done.
-    }
+    if (it->second->EndAsUTC() <= endTime)
+      epgTags.emplace_back(it->second);
+    else
+      break; // done.
   }
 
   return epgTags;
@@ -355,9 +355,36 @@ bool CEpg::UpdateEntries(const CEpg &epg, bool bStoreInDb /* = true */)
 #if EPG_DEBUGGING
   CLog::Log(LOGDEBUG, "EPG - %s - %" PRIuS" entries in memory before merging", __FUNCTION__, m_tags.size());
 #endif
-  /* copy over tags */
-  for (std::map<CDateTime, CEpgInfoTagPtr>::const_iterator it = epg.m_tags.begin(); it != epg.m_tags.end(); ++it)
-    UpdateEntry(it->second, bStoreInDb);
+  /* index the tags by their unique broadcast id, to find the events the client moved */
+  std::unordered_map<unsigned int, CEpgInfoTagPtr> tagsByUid;
+  for (const auto &tag : m_tags)
+  {
+    if (tag.second->UniqueBroadcastID() != EPG_TAG_INVALID_UID)
+      tagsByUid.insert(std::make_pair(tag.second->UniqueBroadcastID(), tag.second));
+  }
+
+  /* copy over tags. only the tags that actually changed are marked for persisting */
+#if EPG_DEBUGGING
+  const size_t iChangedBefore = m_changedTags.size();
+#endif
+  for (const auto &tag : epg.m_tags)
+  {
+    if (m_tags.find(tag.first) == m_tags.end())
+    {
+      const auto it = tagsByUid.find(tag.second->UniqueBroadcastID());
+      if (it != tagsByUid.end())
+      {
+        MoveEntry(it->second, tag.first);
+        tagsByUid.erase(it);
+      }
+    }
+
+    UpdateEntry(tag.second, bStoreInDb);
+  }
+
+#if EPG_DEBUGGING
+  CLog::Log(LOGDEBUG, "EPG - %s - %" PRIuS" of %" PRIuS" entries changed", __FUNCTION__, m_changedTags.size() - iChangedBefore, epg.m_tags.size());
+#endif
 
 #if EPG_DEBUGGING
   CLog::Log(LOGDEBUG, "EPG - %s - %" PRIuS" entries in memory after merging and before fixing", __FUNCTION__, m_tags.size());
@@ -437,20 +464,39 @@ bool CEpg::UpdateEntry(const CEpgInfoTagPtr &tag, bool bUpdateDatabase /* = fals
       bNewTag = true;
     }
 
-    infoTag->Update(*tag, bNewTag);
+    const bool bChanged = infoTag->Update(*tag, bNewTag);
     infoTag->SetEpg(this);
     infoTag->SetPVRChannel(m_pvrChannel);
 
-    if (bUpdateDatabase)
+    if (bUpdateDatabase && (bChanged || bNewTag))
       m_changedTags.insert(std::make_pair(infoTag->UniqueBroadcastID(), infoTag));
   }
 
-  infoTag->SetTimer(g_PVRTimers->GetTimerForEpgTag(infoTag));
-  infoTag->SetRecording(g_PVRRecordings->GetRecordingForEpgTag(infoTag));
+  /* timers and recordings are only available while the pvr manager is started */
+  const CPVRTimersPtr timers(g_PVRTimers);
+  if (timers)
+    infoTag->SetTimer(timers->GetTimerForEpgTag(infoTag));
+
+  const CPVRRecordingsPtr recordings(g_PVRRecordings);
+  if (recordings)
+    infoTag->SetRecording(recordings->GetRecordingForEpgTag(infoTag));
 
   return true;
 }
 
+void CEpg::MoveEntry(const CEpgInfoTagPtr &tag, const CDateTime &newStart)
+{
+  const auto it = m_tags.find(tag->StartAsUTC());
+  if (it == m_tags.end() || it->second != tag)
+    return;
+
+  if (m_nowActiveStart == it->first)
+    m_nowActiveStart.SetValid(false);
+
+  m_tags.erase(it);
+  m_tags.insert(std::make_pair(newStart, tag));
+}
+
 bool CEpg::UpdateEntry(const CEpgInfoTagPtr &tag, EPG_EVENT_STATE newState, bool bUpdateDatabase /* = false */)
 {
   bool bRet(true);
@@ -607,6 +653,9 @@ bool CEpg::Persist(void)
     return false;
   }
 
+  unsigned int iStartTime = XbmcThreads::SystemClockMillis();
+  size_t iDeleted(0), iChanged(0);
+
   {
     CSingleLock lock(m_critSection);
     if (m_iEpgID <= 0 || m_bChanged)
@@ -616,11 +665,23 @@ bool CEpg::Persist(void)
         m_iEpgID = iId;
     }
 
+    /* all changes are queued and written in a single transaction */
     for (std::map<int, CEpgInfoTagPtr>::iterator it = m_deletedTags.begin(); it != m_deletedTags.end(); ++it)
-      database->Delete(*it->second);
+    {
+      if (database->Delete(*it->second, true))
+        iDeleted++;
+    }
 
     for (std::map<int, CEpgInfoTagPtr>::iterator it = m_changedTags.begin(); it != m_changedTags.end(); ++it)
+    {
+      /* don't write back tags that were removed after they changed */
+      std::map<int, CEpgInfoTagPtr>::const_iterator deleted = m_deletedTags.find(it->first);
+      if (deleted != m_deletedTags.end() && deleted->second == it->second)
+        continue;
+
       it->second->Persist(false);
+      iChanged++;
+    }
 
     if (m_bUpdateLastScanTime)
       database->PersistLastEpgScanTime(m_iEpgID, true);
@@ -632,7 +693,13 @@ bool CEpg::Persist(void)
     m_bUpdateLastScanTime = false;
   }
 
-  return database->CommitInsertQueries();
+  bool bReturn = database->CommitInsertQueries();
+
+  if (iChanged > 0 || iDeleted > 0)
+    CLog::Log(LOGDEBUG, "EPG - %s - %" PRIuS" entries written and %" PRIuS" entries deleted for table '%s' in %u ms", __FUNCTION__,
+              iChanged, iDeleted, Name().c_str(), XbmcThreads::SystemClockMillis() - iStartTime);
+
+  return bReturn;
 }
 
 CDateTime CEpg::GetFirstDate(void) const
@@ -301,6 +301,13 @@ namespace EPG
      */
     bool FixOverlappingEvents(bool bUpdateDb = false);
 
+    /*!
+     * @brief Move a tag to another start time in the table, keeping its database entry.
+     * @param tag The tag to move.
+     * @param newStart The new start time of the tag.
+     */
+    void MoveEntry(const CEpgInfoTagPtr &tag, const CDateTime &newStart);
+
     /*!
      * @brief Add an infotag to this container.
      * @param tag The tag to add.
@@ -317,6 +324,8 @@ namespace EPG
 
     /*!
      * @brief Update the contents of this table with the contents provided in "epg"
+     *        Events are matched by start time or, if the client moved them, by unique
+     *        broadcast id. Only the events that changed are persisted.
      * @param epg The updated contents.
      * @param bStoreInDb True to store the updated contents in the db, false otherwise.
      * @return True if the update was successful, false otherwise.
@@ -37,6 +37,7 @@
 #include "settings/lib/Setting.h"
 #include "settings/Settings.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 
 
@@ -663,6 +664,7 @@ bool CEpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
   }
 
   std::vector<CEpgPtr> invalidTables;
+  unsigned int iStartTime = XbmcThreads::SystemClockMillis();
 
   /* load or update all EPG tables */
   unsigned int iCounter(0);
@@ -718,6 +720,9 @@ bool CEpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
       m_pendingUpdates = 0;
   }
 
+  CLog::Log(LOGDEBUG, "EpgContainer - %s - %u of %" PRIuS" tables updated in %u ms%s", __FUNCTION__,
+            iUpdatedTables, m_epgs.size(), XbmcThreads::SystemClockMillis() - iStartTime, bInterrupted ? " (interrupted)" : "");
+
   if (bShowProgress && !bOnlyPending)
     CloseProgressDialog();
 
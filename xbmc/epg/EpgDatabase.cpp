@@ -160,12 +160,15 @@ bool CEpgDatabase::DeleteEpgEntries(const CDateTime &maxEndTime)
   return DeleteValues("epgtags", filter);
 }
 
-bool CEpgDatabase::Delete(const CEpgInfoTag &tag)
+bool CEpgDatabase::Delete(const CEpgInfoTag &tag, bool bQueueWrite /* = false */)
 {
   /* tag without a database ID was not persisted */
   if (tag.BroadcastId() <= 0)
     return false;
 
+  if (bQueueWrite)
+    return QueueInsertQuery(PrepareSQL("DELETE FROM epgtags WHERE idBroadcast = %u", tag.BroadcastId()));
+
   Filter filter;
   filter.AppendWhere(PrepareSQL("idBroadcast = %u", tag.BroadcastId()));
 
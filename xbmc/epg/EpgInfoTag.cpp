@@ -189,13 +189,13 @@ void CEpgInfoTag::Serialize(CVariant &value) const
   value["broadcastid"] = m_iUniqueBroadcastID;
   value["parentalrating"] = m_iParentalRating;
   value["rating"] = m_iStarRating;
-  value["title"] = m_strTitle;
-  value["plotoutline"] = m_strPlotOutline;
-  value["plot"] = m_strPlot;
-  value["originaltitle"] = m_strOriginalTitle;
-  value["cast"] = m_strCast;
-  value["director"] = m_strDirector;
-  value["writer"] = m_strWriter;
+  value["title"] = m_strTitle.str();
+  value["plotoutline"] = m_strPlotOutline.str();
+  value["plot"] = m_strPlot.str();
+  value["originaltitle"] = m_strOriginalTitle.str();
+  value["cast"] = m_strCast.str();
+  value["director"] = m_strDirector.str();
+  value["writer"] = m_strWriter.str();
   value["year"] = m_iYear;
   value["imdbnumber"] = m_strIMDBNumber;
   value["genre"] = m_genre;
@@ -206,7 +206,7 @@ void CEpgInfoTag::Serialize(CVariant &value) const
   value["firstaired"] = m_firstAired.IsValid() ? m_firstAired.GetAsDBDate() : StringUtils::Empty;
   value["progress"] = Progress();
   value["progresspercentage"] = ProgressPercentage();
-  value["episodename"] = m_strEpisodeName;
+  value["episodename"] = m_strEpisodeName.str();
   value["episodenum"] = m_iEpisodeNumber;
   value["episodepart"] = m_iEpisodePart;
   value["hastimer"] = HasTimer();
@@ -575,6 +575,7 @@ bool CEpgInfoTag::Update(const CEpgInfoTag &tag, bool bUpdateBroadcastId /* = tr
   }
 
   {
+    /* the genre description is only compared if it's not derived from the genre type and sub type */
     bChanged |= (
         m_strTitle           != tag.m_strTitle ||
         m_strPlotOutline     != tag.m_strPlotOutline ||
@@ -599,7 +600,7 @@ bool CEpgInfoTag::Update(const CEpgInfoTag &tag, bool bUpdateBroadcastId /* = tr
         m_strEpisodeName     != tag.m_strEpisodeName ||
         m_iUniqueBroadcastID != tag.m_iUniqueBroadcastID ||
         EpgID()              != tag.EpgID() ||
-        m_genre              != tag.m_genre ||
+        (tag.m_iGenreType == EPG_GENRE_USE_STRING && m_genre != tag.m_genre) ||
         m_strIconPath        != tag.m_strIconPath ||
         m_iFlags             != tag.m_iFlags
     );
@@ -27,6 +27,7 @@
 #include "pvr/timers/PVRTimerInfoTag.h"
 #include "utils/ISerializable.h"
 
+#include "epg/EpgString.h"
 #include "epg/EpgTypes.h"
 
 #include <string>
@@ -439,18 +440,18 @@ namespace EPG
     int                      m_iEpisodeNumber;     /*!< episode number */
     int                      m_iEpisodePart;       /*!< episode part number */
     unsigned int             m_iUniqueBroadcastID; /*!< unique broadcast ID */
-    std::string              m_strTitle;           /*!< title */
-    std::string              m_strPlotOutline;     /*!< plot outline */
-    std::string              m_strPlot;            /*!< plot */
-    std::string              m_strOriginalTitle;   /*!< original title */
-    std::string              m_strCast;            /*!< cast */
-    std::string              m_strDirector;        /*!< director */
-    std::string              m_strWriter;          /*!< writer */
+    CEpgString               m_strTitle;           /*!< title */
+    CEpgString               m_strPlotOutline;     /*!< plot outline */
+    CEpgString               m_strPlot;            /*!< plot */
+    CEpgString               m_strOriginalTitle;   /*!< original title */
+    CEpgString               m_strCast;            /*!< cast */
+    CEpgString               m_strDirector;        /*!< director */
+    CEpgString               m_strWriter;          /*!< writer */
     int                      m_iYear;              /*!< year */
     std::string              m_strIMDBNumber;      /*!< imdb number */
     std::vector<std::string> m_genre;              /*!< genre */
-    std::string              m_strEpisodeName;     /*!< episode name */
-    std::string              m_strIconPath;        /*!< the path to the icon */
+    CEpgString               m_strEpisodeName;     /*!< episode name */
+    CEpgString               m_strIconPath;        /*!< the path to the icon */
     std::string              m_strFileNameAndPath; /*!< the filename and path */
     CDateTime                m_startTime;          /*!< event start time */
     CDateTime                m_endTime;            /*!< event end time */
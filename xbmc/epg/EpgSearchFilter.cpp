@@ -48,8 +48,10 @@ void CEpgSearchFilter::Reset()
   m_iGenreSubType            = EPG_SEARCH_UNSET;
   m_iMinimumDuration         = EPG_SEARCH_UNSET;
   m_iMaximumDuration         = EPG_SEARCH_UNSET;
-  m_startDateTime.SetFromUTCDateTime(g_EpgContainer.GetFirstEPGDate());
-  m_endDateTime.SetFromUTCDateTime(g_EpgContainer.GetLastEPGDate());
+  m_startDateTimeUTC = g_EpgContainer.GetFirstEPGDate();
+  m_endDateTimeUTC = g_EpgContainer.GetLastEPGDate();
+  m_startDateTime.SetFromUTCDateTime(m_startDateTimeUTC);
+  m_endDateTime.SetFromUTCDateTime(m_endDateTimeUTC);
   m_bIncludeUnknownGenres    = false;
   m_bRemoveDuplicates        = false;
 
@@ -61,6 +63,8 @@ void CEpgSearchFilter::Reset()
   m_bIgnorePresentTimers     = true;
   m_bIgnorePresentRecordings = true;
   m_iUniqueBroadcastId       = EPG_TAG_INVALID_UID;
+
+  m_textSearch.reset();
 }
 
 bool CEpgSearchFilter::MatchGenre(const CEpgInfoTagPtr &tag) const
@@ -92,7 +96,26 @@ bool CEpgSearchFilter::MatchDuration(const CEpgInfoTagPtr &tag) const
 
 bool CEpgSearchFilter::MatchStartAndEndTimes(const CEpgInfoTagPtr &tag) const
 {
-  return (tag->StartAsLocalTime() >= m_startDateTime && tag->EndAsLocalTime() <= m_endDateTime);
+  // compare in UTC rather than converting the times of every tag to local time
+  return (tag->StartAsUTC() >= m_startDateTimeUTC && tag->EndAsUTC() <= m_endDateTimeUTC);
+}
+
+void CEpgSearchFilter::SetStartDateTime(const CDateTime &startDateTime)
+{
+  m_startDateTime = startDateTime;
+  m_startDateTimeUTC = startDateTime.GetAsUTCDateTime();
+}
+
+void CEpgSearchFilter::SetEndDateTime(const CDateTime &endDateTime)
+{
+  m_endDateTime = endDateTime;
+  m_endDateTimeUTC = endDateTime.GetAsUTCDateTime();
+}
+
+void CEpgSearchFilter::SetSearchTerm(const std::string &strSearchTerm)
+{
+  m_strSearchTerm = strSearchTerm;
+  UpdateTextSearch();
 }
 
 void CEpgSearchFilter::SetSearchPhrase(const std::string &strSearchPhrase)
@@ -101,18 +124,33 @@ void CEpgSearchFilter::SetSearchPhrase(const std::string &strSearchPhrase)
   m_strSearchTerm = "\"";
   m_strSearchTerm.append(strSearchPhrase);
   m_strSearchTerm.append("\"");
+  UpdateTextSearch();
+}
+
+void CEpgSearchFilter::SetCaseSensitive(bool bIsCaseSensitive)
+{
+  m_bIsCaseSensitive = bIsCaseSensitive;
+  UpdateTextSearch();
+}
+
+void CEpgSearchFilter::UpdateTextSearch()
+{
+  // parse the search term once instead of for every tag that is checked
+  if (m_strSearchTerm.empty())
+    m_textSearch.reset();
+  else
+    m_textSearch = std::make_shared<const CTextSearch>(m_strSearchTerm, m_bIsCaseSensitive, SEARCH_DEFAULT_OR);
 }
 
 bool CEpgSearchFilter::MatchSearchTerm(const CEpgInfoTagPtr &tag) const
 {
   bool bReturn(true);
 
-  if (!m_strSearchTerm.empty())
+  if (m_textSearch)
   {
-    CTextSearch search(m_strSearchTerm, m_bIsCaseSensitive, SEARCH_DEFAULT_OR);
-    bReturn = search.Search(tag->Title()) ||
-              search.Search(tag->PlotOutline()) ||
-              (m_bSearchInDescription && search.Search(tag->Plot()));
+    bReturn = m_textSearch->Search(tag->Title()) ||
+              m_textSearch->Search(tag->PlotOutline()) ||
+              (m_bSearchInDescription && m_textSearch->Search(tag->Plot()));
   }
 
   return bReturn;
@@ -19,10 +19,13 @@
  *
  */
 
+#include <memory>
+
 #include "XBDateTime.h"
 #include "EpgTypes.h"
 
 class CFileItemList;
+class CTextSearch;
 
 namespace EPG
 {
@@ -55,11 +58,11 @@ namespace EPG
     static int RemoveDuplicates(CFileItemList &results);
 
     const std::string &GetSearchTerm() const { return m_strSearchTerm; }
-    void SetSearchTerm(const std::string &strSearchTerm) { m_strSearchTerm = strSearchTerm; }
+    void SetSearchTerm(const std::string &strSearchTerm);
     void SetSearchPhrase(const std::string &strSearchPhrase);
 
     bool IsCaseSensitive() const { return m_bIsCaseSensitive; }
-    void SetCaseSensitive(bool bIsCaseSensitive) { m_bIsCaseSensitive = bIsCaseSensitive; }
+    void SetCaseSensitive(bool bIsCaseSensitive);
 
     bool ShouldSearchInDescription() const { return m_bSearchInDescription; }
     void SetSearchInDescription(bool bSearchInDescription) {m_bSearchInDescription = bSearchInDescription; }
@@ -77,10 +80,10 @@ namespace EPG
     void SetMaximumDuration(int iMaximumDuration) { m_iMaximumDuration = iMaximumDuration; }
 
     const CDateTime &GetStartDateTime() const { return m_startDateTime; }
-    void SetStartDateTime(const CDateTime &startDateTime) { m_startDateTime = startDateTime; }
+    void SetStartDateTime(const CDateTime &startDateTime);
 
     const CDateTime &GetEndDateTime() const { return m_endDateTime; }
-    void SetEndDateTime(const CDateTime &endDateTime) { m_endDateTime = endDateTime; }
+    void SetEndDateTime(const CDateTime &endDateTime);
 
     bool ShouldIncludeUnknownGenres() const { return m_bIncludeUnknownGenres; }
     void SetIncludeUnknownGenres(bool bIncludeUnknownGenres) { m_bIncludeUnknownGenres = bIncludeUnknownGenres; }
@@ -121,6 +124,7 @@ namespace EPG
     bool MatchFreeToAir(const CEpgInfoTagPtr &tag) const;
     bool MatchTimers(const CEpgInfoTagPtr &tag) const;
     bool MatchRecordings(const CEpgInfoTagPtr &tag) const;
+    void UpdateTextSearch();
 
     std::string   m_strSearchTerm;            /*!< The term to search for */
     bool          m_bIsCaseSensitive;         /*!< Do a case sensitive search */
@@ -131,6 +135,9 @@ namespace EPG
     int           m_iMaximumDuration;         /*!< The maximum duration for an entry */
     CDateTime     m_startDateTime;            /*!< The minimum start time for an entry */
     CDateTime     m_endDateTime;              /*!< The maximum end time for an entry */
+    CDateTime     m_startDateTimeUTC;         /*!< m_startDateTime in UTC, as the tags store their times */
+    CDateTime     m_endDateTimeUTC;           /*!< m_endDateTime in UTC, as the tags store their times */
+    std::shared_ptr<const CTextSearch> m_textSearch; /*!< The parsed search term, empty if there's none */
     bool          m_bIncludeUnknownGenres;    /*!< Include unknown genres or not */
     bool          m_bRemoveDuplicates;        /*!< True to remove duplicate events, false if not */
     bool          m_bIsRadio;                 /*!< True to filter radio channels only, false to tv only */
@@ -0,0 +1,104 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "EpgString.h"
+
+#include <unordered_map>
+
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+
+using namespace EPG;
+
+namespace
+{
+
+struct StringPtrHash
+{
+  size_t operator()(const std::string *str) const { return std::hash<std::string>()(*str); }
+};
+
+struct StringPtrEqual
+{
+  bool operator()(const std::string *left, const std::string *right) const { return *left == *right; }
+};
+
+class CEpgStringPool
+{
+public:
+  static CEpgStringPool &GetInstance()
+  {
+    // never destroyed, tags may still release their strings during shutdown
+    static CEpgStringPool *pool = new CEpgStringPool;
+    return *pool;
+  }
+
+  std::shared_ptr<const std::string> Get(const std::string &str)
+  {
+    CSingleLock lock(m_critSection);
+
+    auto it = m_strings.find(&str);
+    if (it != m_strings.end())
+    {
+      std::shared_ptr<const std::string> shared = it->second.lock();
+      if (shared)
+        return shared;
+
+      // last user is just gone, its deleter won't remove the new entry
+      m_strings.erase(it);
+    }
+
+    const std::string *data = new std::string(str);
+    std::shared_ptr<const std::string> shared(data, [this](const std::string *data) { Release(data); });
+    m_strings.insert(std::make_pair(data, std::weak_ptr<const std::string>(shared)));
+    return shared;
+  }
+
+private:
+  void Release(const std::string *data)
+  {
+    {
+      CSingleLock lock(m_critSection);
+      auto it = m_strings.find(data);
+      if (it != m_strings.end() && it->first == data)
+        m_strings.erase(it);
+    }
+    delete data;
+  }
+
+  CCriticalSection m_critSection;
+  std::unordered_map<const std::string*, std::weak_ptr<const std::string>, StringPtrHash, StringPtrEqual> m_strings;
+};
+
+} // unnamed namespace
+
+const std::string &CEpgString::str() const
+{
+  static const std::string empty;
+  return m_str ? *m_str : empty;
+}
+
+void CEpgString::Assign(const std::string &str)
+{
+  if (str.empty())
+    m_str.reset();
+  else
+    m_str = CEpgStringPool::GetInstance().Get(str);
+}
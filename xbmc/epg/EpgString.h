@@ -0,0 +1,54 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <string>
+
+namespace EPG
+{
+  /** A shared, immutable string for the text of EPG tags.
+      Titles, plots, cast and icons repeat a lot within a guide, so equal
+      strings are stored only once, for as long as any tag still uses them. */
+
+  class CEpgString
+  {
+  public:
+    CEpgString() = default;
+    CEpgString(const std::string &str) { Assign(str); }
+    CEpgString &operator =(const std::string &str) { Assign(str); return *this; }
+
+    /*!
+     * @brief Two strings with the same content always share the same data.
+     */
+    bool operator ==(const CEpgString &right) const { return m_str == right.m_str; }
+    bool operator !=(const CEpgString &right) const { return m_str != right.m_str; }
+
+    operator const std::string &() const { return str(); }
+    const std::string &str() const;
+    const char *c_str() const { return str().c_str(); }
+    bool empty() const { return !m_str; }
+
+  private:
+    void Assign(const std::string &str);
+
+    std::shared_ptr<const std::string> m_str; //! NULL for the empty string
+  };
+}
@@ -0,0 +1,184 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "addons/kodi-addon-dev-kit/include/kodi/xbmc_epg_types.h"
+#include "epg/Epg.h"
+#include "epg/EpgInfoTag.h"
+
+#include <ctime>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using namespace EPG;
+
+namespace
+{
+
+const time_t START = 1496347200; // 2017-06-01 20:00 UTC
+
+class CTestEpg : public CEpg
+{
+public:
+  CTestEpg() : CEpg(1, "Test Channel", "client") {}
+
+  using CEpg::UpdateEntries;
+  using CEpg::MoveEntry;
+
+  bool IsChanged(unsigned int iUniqueBroadcastId) const { return m_changedTags.find(iUniqueBroadcastId) != m_changedTags.end(); }
+  size_t ChangedCount() const { return m_changedTags.size(); }
+  size_t DeletedCount() const { return m_deletedTags.size(); }
+  void ClearChanges() { m_changedTags.clear(); m_deletedTags.clear(); }
+};
+
+//! Adds an event like a client does, 'start' and 'duration' are in minutes
+void AddEvent(CEpg &epg, unsigned int iUniqueBroadcastId, const std::string &title, int start, int duration)
+{
+  EPG_TAG data = {};
+  data.iUniqueBroadcastId = iUniqueBroadcastId;
+  data.strTitle = title.c_str();
+  data.startTime = START + start * 60;
+  data.endTime = data.startTime + duration * 60;
+  epg.UpdateEntry(&data);
+}
+
+//! The guide of the client, three events of half an hour
+void AddGuide(CEpg &epg)
+{
+  AddEvent(epg, 1, "News", 0, 30);
+  AddEvent(epg, 2, "Weather", 30, 30);
+  AddEvent(epg, 3, "Movie", 60, 30);
+}
+
+} // unnamed namespace
+
+TEST(TestEpg, UpdateEntriesPersistsNewTags)
+{
+  CTestEpg table;
+  CTestEpg client;
+  AddGuide(client);
+
+  EXPECT_TRUE(table.UpdateEntries(client));
+  EXPECT_EQ(3u, table.Size());
+  EXPECT_EQ(3u, table.ChangedCount());
+  EXPECT_EQ(0u, table.DeletedCount());
+}
+
+TEST(TestEpg, UpdateEntriesSkipsUnchangedTags)
+{
+  CTestEpg table;
+  {
+    CTestEpg client;
+    AddGuide(client);
+    table.UpdateEntries(client);
+  }
+  table.ClearChanges();
+
+  CTestEpg client;
+  AddGuide(client);
+
+  EXPECT_TRUE(table.UpdateEntries(client));
+  EXPECT_EQ(3u, table.Size());
+  EXPECT_EQ(0u, table.ChangedCount());
+  EXPECT_EQ(0u, table.DeletedCount());
+}
+
+TEST(TestEpg, UpdateEntriesPersistsOnlyChangedTags)
+{
+  CTestEpg table;
+  {
+    CTestEpg client;
+    AddGuide(client);
+    table.UpdateEntries(client);
+  }
+  table.ClearChanges();
+
+  CTestEpg client;
+  AddEvent(client, 1, "News", 0, 30);
+  AddEvent(client, 2, "Weather and Traffic", 30, 30);
+  AddEvent(client, 3, "Movie", 60, 30);
+
+  EXPECT_TRUE(table.UpdateEntries(client));
+  EXPECT_EQ(1u, table.ChangedCount());
+  EXPECT_TRUE(table.IsChanged(2));
+  EXPECT_EQ("Weather and Traffic", table.GetTagByBroadcastId(2)->Title(true));
+}
+
+TEST(TestEpg, UpdateEntriesMovesTagByUid)
+{
+  CTestEpg table;
+  {
+    CTestEpg client;
+    AddGuide(client);
+    table.UpdateEntries(client);
+  }
+  table.ClearChanges();
+  const CEpgInfoTagPtr movie = table.GetTagByBroadcastId(3);
+
+  // the client starts the movie ten minutes later
+  CTestEpg client;
+  AddEvent(client, 1, "News", 0, 30);
+  AddEvent(client, 2, "Weather", 30, 30);
+  AddEvent(client, 3, "Movie", 70, 30);
+
+  EXPECT_TRUE(table.UpdateEntries(client));
+  EXPECT_EQ(3u, table.Size());
+  EXPECT_EQ(1u, table.ChangedCount());
+  EXPECT_TRUE(table.IsChanged(3));
+  EXPECT_EQ(0u, table.DeletedCount());
+
+  // the existing tag is kept, so it keeps its database entry
+  EXPECT_EQ(movie, table.GetTagByBroadcastId(3));
+  EXPECT_EQ(CDateTime(START + 70 * 60), movie->StartAsUTC());
+  EXPECT_EQ(movie, table.GetTagBetween(CDateTime(START + 70 * 60), CDateTime(START + 100 * 60)));
+}
+
+TEST(TestEpg, MoveEntry)
+{
+  CTestEpg table;
+  AddGuide(table);
+  const CEpgInfoTagPtr movie = table.GetTagByBroadcastId(3);
+
+  table.MoveEntry(movie, CDateTime(START + 70 * 60));
+  EXPECT_EQ(3u, table.Size());
+
+  // the tag is found at its new start time, the old one is free
+  AddEvent(table, 4, "Short Film", 60, 10);
+  EXPECT_EQ(4u, table.Size());
+  EXPECT_EQ(movie, table.GetTagBetween(CDateTime(START + 70 * 60), CDateTime(START + 100 * 60)));
+  EXPECT_NE(movie, table.GetTagByBroadcastId(4));
+}
+
+TEST(TestEpg, MoveEntryIgnoresUnknownTag)
+{
+  CTestEpg table;
+  AddGuide(table);
+
+  CTestEpg other;
+  AddEvent(other, 3, "Movie", 60, 30);
+
+  table.MoveEntry(other.GetTagByBroadcastId(3), CDateTime(START + 70 * 60));
+  EXPECT_EQ(3u, table.Size());
+  EXPECT_NE(other.GetTagByBroadcastId(3), table.GetTagByBroadcastId(3));
+
+  // the tag of the table is still found at its start time
+  AddEvent(table, 3, "Movie", 60, 45);
+  EXPECT_EQ(3u, table.Size());
+}
@@ -0,0 +1,112 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "epg/EpgString.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using namespace EPG;
+
+TEST(TestEpgString, EqualStringsShareData)
+{
+  std::string title("Evening News");
+  CEpgString first(title);
+  CEpgString second(std::string("Evening News"));
+
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(first.c_str(), second.c_str());
+  EXPECT_NE(title.c_str(), first.c_str());
+  EXPECT_EQ("Evening News", first.str());
+}
+
+TEST(TestEpgString, DifferentStringsDoNotShareData)
+{
+  CEpgString first(std::string("Evening News"));
+  CEpgString second(std::string("Morning News"));
+
+  EXPECT_NE(first, second);
+  EXPECT_NE(first.c_str(), second.c_str());
+  EXPECT_EQ("Evening News", first.str());
+  EXPECT_EQ("Morning News", second.str());
+}
+
+TEST(TestEpgString, EmptyString)
+{
+  CEpgString unset;
+  CEpgString empty(std::string(""));
+
+  EXPECT_TRUE(unset.empty());
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(unset, empty);
+  EXPECT_STREQ("", unset.c_str());
+
+  empty = std::string("Movie");
+  EXPECT_FALSE(empty.empty());
+  empty = std::string();
+  EXPECT_TRUE(empty.empty());
+}
+
+TEST(TestEpgString, DataOutlivesFirstUser)
+{
+  std::unique_ptr<CEpgString> first(new CEpgString(std::string("Documentary")));
+  CEpgString second(std::string("Documentary"));
+  const char *data = second.c_str();
+
+  first.reset();
+  EXPECT_EQ(data, second.c_str());
+  EXPECT_EQ("Documentary", second.str());
+
+  // a new user still finds the data of the remaining one
+  CEpgString third(std::string("Documentary"));
+  EXPECT_EQ(data, third.c_str());
+}
+
+TEST(TestEpgString, DataIsCreatedAgainAfterLastUser)
+{
+  {
+    CEpgString first(std::string("Late Show"));
+    CEpgString copy(first);
+    EXPECT_EQ(first.c_str(), copy.c_str());
+  }
+
+  // all users are gone, the pool must not hand out the released data
+  CEpgString second(std::string("Late Show"));
+  EXPECT_EQ("Late Show", second.str());
+
+  CEpgString third(std::string("Late Show"));
+  EXPECT_EQ(second.c_str(), third.c_str());
+}
+
+TEST(TestEpgString, AssignReleasesPreviousData)
+{
+  CEpgString tag(std::string("Weather"));
+  CEpgString other(std::string("Weather"));
+
+  tag = std::string("Sports");
+  EXPECT_EQ("Sports", tag.str());
+  EXPECT_EQ("Weather", other.str());
+  EXPECT_NE(tag, other);
+
+  tag = std::string("Weather");
+  EXPECT_EQ(tag.c_str(), other.c_str());
+}
@@ -0,0 +1,144 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "epg/EpgInfoTag.h"
+#include "epg/GUIEPGGridContainerModel.h"
+#include "pvr/channels/PVRChannel.h"
+
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace EPG;
+using namespace PVR;
+
+namespace
+{
+
+const int CHANNELS = 3;
+const int PROGRAMMES = 3;
+const int PROGRAMME_MINUTES = 30;
+const int BLOCKS = PROGRAMMES * PROGRAMME_MINUTES / CGUIEPGGridContainerModel::MINSPERBLOCK;
+const float BLOCK_SIZE = 10.0f;
+
+class TestGUIEPGGridContainerModel : public ::testing::Test
+{
+protected:
+  TestGUIEPGGridContainerModel()
+  {
+    // the grid is moved to 'now' if it starts later, so use a full hour two days ago
+    time_t start = time(nullptr) - 2 * 24 * 60 * 60;
+    start -= start % (60 * 60);
+
+    std::unique_ptr<CFileItemList> items(new CFileItemList);
+    for (int channel = 0; channel < CHANNELS; ++channel)
+    {
+      CPVRChannelPtr channelTag(new CPVRChannel);
+      channelTag->SetChannelID(channel + 1);
+
+      for (int programme = 0; programme < PROGRAMMES; ++programme)
+      {
+        const std::string title = "Programme " + std::to_string(channel) + "." + std::to_string(programme);
+
+        EPG_TAG data = {};
+        data.iUniqueBroadcastId = channel * PROGRAMMES + programme + 1;
+        data.strTitle = title.c_str();
+        data.startTime = start + programme * PROGRAMME_MINUTES * 60;
+        data.endTime = data.startTime + PROGRAMME_MINUTES * 60;
+
+        CEpgInfoTagPtr tag(new CEpgInfoTag(data));
+        tag->SetPVRChannel(channelTag);
+        items->Add(CFileItemPtr(new CFileItem(tag)));
+      }
+    }
+
+    const CDateTime gridStart(start);
+    const CDateTime gridEnd(start + PROGRAMMES * PROGRAMME_MINUTES * 60);
+    m_model.Refresh(items, gridStart, gridEnd, 6, BLOCKS, BLOCK_SIZE);
+  }
+
+  std::vector<CFileItemPtr> GetRow(int channel) const
+  {
+    std::vector<CFileItemPtr> row;
+    for (int block = 0; block < m_model.GetBlockCount(); ++block)
+      row.emplace_back(m_model.GetGridItem(channel, block));
+    return row;
+  }
+
+  CGUIEPGGridContainerModel m_model;
+};
+
+} // unnamed namespace
+
+TEST_F(TestGUIEPGGridContainerModel, BuildsRowsFromProgrammes)
+{
+  ASSERT_EQ(CHANNELS, m_model.ChannelItemsSize());
+  ASSERT_EQ(CHANNELS * PROGRAMMES, m_model.ProgrammeItemsSize());
+  ASSERT_EQ(BLOCKS, m_model.GetBlockCount());
+
+  const int blocksPerProgramme = PROGRAMME_MINUTES / CGUIEPGGridContainerModel::MINSPERBLOCK;
+  for (int channel = 0; channel < CHANNELS; ++channel)
+  {
+    for (int block = 0; block < BLOCKS; ++block)
+    {
+      const int progIndex = channel * PROGRAMMES + block / blocksPerProgramme;
+      EXPECT_EQ(progIndex, m_model.GetGridItemIndex(channel, block));
+      EXPECT_EQ(m_model.GetProgrammeItem(progIndex), m_model.GetGridItem(channel, block));
+    }
+    EXPECT_FLOAT_EQ(blocksPerProgramme * BLOCK_SIZE, m_model.GetGridItemOriginWidth(channel, 0));
+  }
+}
+
+TEST_F(TestGUIEPGGridContainerModel, RebuildsRowAfterFreeChannel)
+{
+  const std::vector<CFileItemPtr> before = GetRow(0);
+  std::vector<float> widths;
+  for (int block = 0; block < BLOCKS; ++block)
+    widths.emplace_back(m_model.GetGridItemOriginWidth(0, block));
+
+  // keep the channels 1 and 2, the row of channel 0 is dropped
+  m_model.FreeChannelMemory(1, 2);
+
+  EXPECT_EQ(before, GetRow(0));
+  for (int block = 0; block < BLOCKS; ++block)
+  {
+    EXPECT_FLOAT_EQ(widths[block], m_model.GetGridItemOriginWidth(0, block));
+    EXPECT_FLOAT_EQ(widths[block], m_model.GetGridItemWidth(0, block));
+  }
+}
+
+TEST_F(TestGUIEPGGridContainerModel, FreeChannelResetsChangedWidths)
+{
+  const float width = m_model.GetGridItemWidth(0, 0);
+  m_model.SetGridItemWidth(0, 0, width / 2);
+  EXPECT_FLOAT_EQ(width / 2, m_model.GetGridItemWidth(0, 0));
+
+  m_model.FreeChannelMemory(1, 2);
+  EXPECT_FLOAT_EQ(width, m_model.GetGridItemWidth(0, 0));
+
+  // rows of channels that were kept are left alone
+  m_model.SetGridItemWidth(1, 0, width / 2);
+  m_model.FreeChannelMemory(1, 2);
+  EXPECT_FLOAT_EQ(width / 2, m_model.GetGridItemWidth(1, 0));
+}
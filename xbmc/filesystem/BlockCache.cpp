@@ -0,0 +1,366 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "BlockCache.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+using namespace XFILE;
+
+#define BLOCK_CACHE_BLOCK_SIZE  (256 * 1024)
+#define BLOCK_CACHE_MIN_BLOCKS  16
+#define BLOCK_CACHE_MAX_PINNED  (4 * 1024 * 1024)
+
+CBlockCache::CBlockCache(size_t size, int64_t fileSize)
+ : CCacheStrategy()
+ , m_size(size)
+ , m_fileSize(fileSize)
+ , m_end(0)
+ , m_cur(0)
+{
+  m_blockSize = BLOCK_CACHE_BLOCK_SIZE;
+  if (m_size / m_blockSize < BLOCK_CACHE_MIN_BLOCKS)
+    m_blockSize = std::max(m_size / BLOCK_CACHE_MIN_BLOCKS, (size_t)4096);
+  m_maxBlocks = std::max(m_size / m_blockSize, (size_t)BLOCK_CACHE_MIN_BLOCKS);
+
+  // same split as the circular cache: 3/4 read ahead, the rest stays around for seeking back.
+  // Head and tail each get at most 1/16th of the cache.
+  m_maxForward = m_maxBlocks * m_blockSize / 4 * 3;
+  m_pinnedSize = std::min((size_t)BLOCK_CACHE_MAX_PINNED, m_maxBlocks / 16 * m_blockSize);
+}
+
+CBlockCache::~CBlockCache()
+{
+  Close();
+}
+
+int CBlockCache::Open()
+{
+  CSingleLock lock(m_sync);
+  FreeBlocks();
+  m_end = 0;
+  m_cur = 0;
+  return CACHE_RC_OK;
+}
+
+void CBlockCache::Close()
+{
+  CSingleLock lock(m_sync);
+  FreeBlocks();
+}
+
+void CBlockCache::FreeBlocks()
+{
+  for (Blocks::iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+    delete[] it->second.m_data;
+  m_blocks.clear();
+  m_lru.clear();
+
+  for (std::vector<uint8_t*>::iterator it = m_free.begin(); it != m_free.end(); ++it)
+    delete[] *it;
+  m_free.clear();
+}
+
+int64_t CBlockCache::ContiguousEnd(int64_t pos) const
+{
+  int64_t index = pos / m_blockSize;
+  size_t offset = (size_t)(pos % m_blockSize);
+
+  Blocks::const_iterator it = m_blocks.find(index);
+  if (it == m_blocks.end() || offset < it->second.m_begin || offset >= it->second.m_end)
+    return pos;
+
+  // follow the run of adjacent full blocks
+  while (it != m_blocks.end() && it->first == index)
+  {
+    pos = index * m_blockSize + it->second.m_end;
+    if (it->second.m_end != m_blockSize)
+      break;
+
+    ++it;
+    ++index;
+    if (it != m_blocks.end() && it->second.m_begin != 0)
+      break;
+  }
+  return pos;
+}
+
+bool CBlockCache::IsInWriteRun(int64_t pos) const
+{
+  if (pos <= m_end)
+    return pos == m_end || ContiguousEnd(pos) >= m_end;
+  return ContiguousEnd(m_end) >= pos;
+}
+
+bool CBlockCache::IsPinned(int64_t index) const
+{
+  int64_t start = index * m_blockSize;
+  if (start < (int64_t)m_pinnedSize)
+    return true;
+  return m_fileSize > 0 && start + (int64_t)m_blockSize > m_fileSize - (int64_t)m_pinnedSize;
+}
+
+void CBlockCache::Touch(Block &block)
+{
+  m_lru.splice(m_lru.begin(), m_lru, block.m_lru);
+}
+
+std::list<int64_t>::const_iterator CBlockCache::FindEvictable() const
+{
+  // blocks between the read and the write position haven't been read yet
+  int64_t first = std::min(m_cur, m_end) / m_blockSize;
+  int64_t last = std::max(m_cur, m_end) / m_blockSize;
+  for (std::list<int64_t>::const_reverse_iterator lru = m_lru.rbegin(); lru != m_lru.rend(); ++lru)
+  {
+    if (!IsPinned(*lru) && (*lru < first || *lru > last))
+      return std::prev(lru.base());
+  }
+  return m_lru.end();
+}
+
+bool CBlockCache::CanWriteBlock(int64_t index) const
+{
+  return m_blocks.find(index) != m_blocks.end() || !m_free.empty() ||
+         m_blocks.size() < m_maxBlocks || FindEvictable() != m_lru.end();
+}
+
+CBlockCache::Block *CBlockCache::GetBlockForWrite(int64_t index)
+{
+  Blocks::iterator it = m_blocks.find(index);
+  if (it != m_blocks.end())
+    return &it->second;
+
+  uint8_t *data = NULL;
+  if (!m_free.empty())
+  {
+    data = m_free.back();
+    m_free.pop_back();
+  }
+  else if (m_blocks.size() < m_maxBlocks)
+    data = new uint8_t[m_blockSize];
+  else
+  {
+    // evict the least recently used block that isn't pinned and hasn't been read yet
+    std::list<int64_t>::const_iterator lru = FindEvictable();
+    if (lru != m_lru.end())
+    {
+      Blocks::iterator victim = m_blocks.find(*lru);
+      data = victim->second.m_data;
+      m_lru.erase(victim->second.m_lru);
+      m_blocks.erase(victim);
+    }
+  }
+
+  if (!data)
+    return NULL;
+
+  Block &block = m_blocks[index];
+  block.m_data = data;
+  block.m_begin = 0;
+  block.m_end = 0;
+  block.m_lru = m_lru.insert(m_lru.begin(), index);
+  return &block;
+}
+
+size_t CBlockCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  CSingleLock lock(m_sync);
+
+  size_t front = m_end > m_cur ? (size_t)(m_end - m_cur) : 0;
+  if (front >= m_maxForward)
+    return 0;
+
+  // everything is pinned or unread, nothing can be written until the reader moves on
+  if (!CanWriteBlock(m_end / m_blockSize))
+    return 0;
+
+  // never write across a block boundary
+  size_t limit = std::min(m_maxForward - front, m_blockSize - (size_t)(m_end % m_blockSize));
+  return std::min(iRequestSize, limit);
+}
+
+/**
+ * Writes data at the write position. Only writes up to the end of the current
+ * block, so multiple calls may be needed to store all data.
+ */
+int CBlockCache::WriteToCache(const char *buf, size_t len)
+{
+  CSingleLock lock(m_sync);
+
+  int64_t index = m_end / m_blockSize;
+  size_t offset = (size_t)(m_end % m_blockSize);
+  len = std::min(len, m_blockSize - offset);
+  if (len == 0)
+    return 0;
+
+  Block *block = GetBlockForWrite(index);
+  if (!block)
+    return 0; // everything is pinned or unread, wait for the reader
+
+  memcpy(block->m_data + offset, buf, len);
+
+  // a block only holds a single range of valid data, drop what isn't adjacent
+  if (offset > block->m_end || offset + len < block->m_begin || block->m_begin == block->m_end)
+  {
+    block->m_begin = offset;
+    block->m_end = offset + len;
+  }
+  else
+  {
+    block->m_begin = std::min(block->m_begin, offset);
+    block->m_end = std::max(block->m_end, offset + len);
+  }
+  Touch(*block);
+
+  m_end += len;
+  m_written.Set();
+
+  return len;
+}
+
+/**
+ * Reads data from cache. Will only read up till the end of the
+ * block, so multiple calls may be needed to read all data.
+ */
+int CBlockCache::ReadFromCache(char *buf, size_t len)
+{
+  CSingleLock lock(m_sync);
+
+  int64_t index = m_cur / m_blockSize;
+  size_t offset = (size_t)(m_cur % m_blockSize);
+
+  Blocks::iterator it = m_blocks.find(index);
+  if (it == m_blocks.end() || offset < it->second.m_begin || offset >= it->second.m_end)
+  {
+    if (IsEndOfInput())
+      return 0;
+    else
+      return CACHE_RC_WOULD_BLOCK;
+  }
+
+  len = std::min(len, it->second.m_end - offset);
+  if (len == 0)
+    return 0;
+
+  memcpy(buf, it->second.m_data + offset, len);
+  Touch(it->second);
+  m_cur += len;
+
+  m_space.Set();
+
+  return len;
+}
+
+int64_t CBlockCache::WaitForData(unsigned int minimum, unsigned int millis)
+{
+  CSingleLock lock(m_sync);
+  int64_t avail = ContiguousEnd(m_cur) - m_cur;
+
+  if (millis == 0 || IsEndOfInput())
+    return avail;
+
+  if (minimum > m_maxForward)
+    minimum = m_maxForward;
+
+  XbmcThreads::EndTime endtime(millis);
+  while (!IsEndOfInput() && avail < minimum && !endtime.IsTimePast())
+  {
+    lock.Leave();
+    m_written.WaitMSec(50); // may miss the deadline. shouldn't be a problem.
+    lock.Enter();
+    avail = ContiguousEnd(m_cur) - m_cur;
+  }
+
+  return avail;
+}
+
+int64_t CBlockCache::Seek(int64_t pos)
+{
+  CSingleLock lock(m_sync);
+
+  // if seek is a bit over what we have, try to wait a few seconds for the data to be available.
+  // we try to avoid a (heavy) seek on the source
+  if (pos >= m_end && pos < m_end + 100000 && IsInWriteRun(m_cur))
+  {
+    // make everything we have back-cache, to make sure there's sufficient forward space
+    m_cur = m_end;
+    lock.Leave();
+    WaitForData((size_t)(pos - m_cur), 5000);
+    lock.Enter();
+  }
+
+  if (IsInWriteRun(pos))
+  {
+    m_cur = pos;
+    return pos;
+  }
+
+  return CACHE_RC_ERROR;
+}
+
+bool CBlockCache::Reset(int64_t pos, bool clearAnyway)
+{
+  CSingleLock lock(m_sync);
+
+  if (clearAnyway)
+  {
+    FreeBlocks();
+  }
+  else if (IsCachedPosition(pos))
+  {
+    // continue writing after the cached data
+    m_cur = pos;
+    m_end = ContiguousEnd(pos);
+    return false;
+  }
+
+  // the blocks cached elsewhere in the file are kept
+  m_end = pos;
+  m_cur = pos;
+
+  return true;
+}
+
+int64_t CBlockCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  return ContiguousEnd(iFilePosition);
+}
+
+int64_t CBlockCache::CachedDataEndPos()
+{
+  CSingleLock lock(m_sync);
+  return m_end;
+}
+
+bool CBlockCache::IsCachedPosition(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  return iFilePosition == m_end || ContiguousEnd(iFilePosition) > iFilePosition;
+}
+
+CCacheStrategy *CBlockCache::CreateNew()
+{
+  return new CBlockCache(m_size, m_fileSize);
+}
@@ -0,0 +1,108 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include "CacheStrategy.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <list>
+#include <map>
+#include <vector>
+
+namespace XFILE {
+
+/*!
+ \brief Cache strategy keeping sparse, fixed size blocks of the file in memory.
+
+ Unlike CCircularCache, which only holds a single window around the read position, data that
+ has been read stays cached after seeking elsewhere until its blocks are evicted in least recently
+ used order. The blocks at the head and tail of the file, where containers like MP4 and MKV keep
+ their indexes, are never evicted.
+
+ Data is written sequentially from the write position, which is only moved by Reset(). A seek
+ to a cached position that isn't contiguous with the write position fails, so that CFileCache
+ repositions the source to the end of the cached run at that position.
+ */
+class CBlockCache : public CCacheStrategy
+{
+public:
+  CBlockCache(size_t size, int64_t fileSize);
+  ~CBlockCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char *buf, size_t len) override;
+  int ReadFromCache(char *buf, size_t len) override;
+  int64_t WaitForData(unsigned int minimum, unsigned int iMillis) override;
+
+  int64_t Seek(int64_t pos) override;
+  bool Reset(int64_t pos, bool clearAnyway=true) override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  CCacheStrategy *CreateNew() override;
+
+  /*! \brief Maximum amount of unread data that is cached ahead of the read position */
+  size_t GetMaxForwardSize() const { return m_maxForward; }
+
+protected:
+  struct Block
+  {
+    uint8_t *m_data;
+    size_t   m_begin;   /**< offset in the block of the beginning of valid data */
+    size_t   m_end;     /**< offset in the block of the end of valid data */
+    std::list<int64_t>::iterator m_lru;
+  };
+  typedef std::map<int64_t, Block> Blocks;
+
+  /*! \brief Returns the end of the cached data that is contiguous with pos, or pos if not cached */
+  int64_t ContiguousEnd(int64_t pos) const;
+  /*! \brief Whether pos can be read without repositioning the writer */
+  bool IsInWriteRun(int64_t pos) const;
+  bool IsPinned(int64_t index) const;
+  /*! \brief The least recently used block that may be evicted, or m_lru.end() if all are pinned or unread */
+  std::list<int64_t>::const_iterator FindEvictable() const;
+  /*! \brief Whether the block can be written without waiting for the reader */
+  bool CanWriteBlock(int64_t index) const;
+  Block *GetBlockForWrite(int64_t index);
+  void Touch(Block &block);
+  void FreeBlocks();
+
+  size_t            m_size;        /**< maximum amount of memory used for blocks */
+  size_t            m_blockSize;
+  size_t            m_maxBlocks;
+  size_t            m_maxForward;
+  size_t            m_pinnedSize;  /**< size of the head and tail of the file that is never evicted */
+  int64_t           m_fileSize;
+  int64_t           m_end;         /**< index in file of the write position */
+  int64_t           m_cur;         /**< current reading index in file */
+  Blocks            m_blocks;
+  std::list<int64_t> m_lru;        /**< block indexes, most recently used first */
+  std::vector<uint8_t*> m_free;    /**< buffers of evicted blocks, ready for reuse */
+  CCriticalSection  m_sync;
+  CEvent            m_written;
+};
+
+} // namespace XFILE
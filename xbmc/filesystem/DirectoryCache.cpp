@@ -19,8 +19,14 @@
  */
 
 #include "DirectoryCache.h"
+#include "DirectoryFactory.h"
+#include "File.h"
 #include "FileItem.h"
+#include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/StringUtils.h"
@@ -28,16 +34,21 @@
 #include "climits"
 
 #include <algorithm>
+#include <memory>
 
-// Maximum number of directories to keep in our cache
-#define MAX_CACHED_DIRS 50
+// Location and format version of the persisted listings
+#define DISK_CACHE_PATH "special://temp/dircache/"
+#define DISK_CACHE_VERSION 2
+
+// Maximum number of directory modification times to remember while listings are fetched
+#define MAX_PENDING_MODIFIED 100
 
 using namespace XFILE;
 
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
-  m_lastAccess = 0;
+  m_size = 0;
   m_Items = new CFileItemList;
   m_Items->SetIgnoreURLOptions(true);
   m_Items->SetFastLookup(true);
@@ -48,14 +59,76 @@ CDirectoryCache::CDir::~CDir()
   delete m_Items;
 }
 
-void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
+class CDirectoryCache::CSaveJob : public CJob
 {
-  m_lastAccess = accessCounter++;
-}
+public:
+  CSaveJob(const std::shared_ptr<CJobContext> &context, const std::string &storedPath, unsigned int id, int64_t modified, const CFileItemList &items)
+    : m_context(context),
+      m_storedPath(storedPath),
+      m_id(id),
+      m_modified(modified)
+  {
+    // the caller goes on to alter its items
+    m_items.Copy(items);
+  }
+
+  const char *GetType() const override { return "directorycachesave"; }
+
+  bool DoWork() override
+  {
+    CSingleLock lock(m_context->m_section);
+    if (m_context->m_cache == nullptr)
+      return false;
+
+    return m_context->m_cache->SavePending(m_storedPath, m_id, m_modified, m_items);
+  }
+
+private:
+  std::shared_ptr<CJobContext> m_context;
+  std::string m_storedPath;
+  unsigned int m_id;
+  int64_t m_modified;
+  CFileItemList m_items;
+};
+
+class CDirectoryCache::CRevalidateJob : public CJob
+{
+public:
+  CRevalidateJob(const std::shared_ptr<CJobContext> &context, const std::string &storedPath, unsigned int id, uint32_t fingerprint)
+    : m_context(context),
+      m_storedPath(storedPath),
+      m_id(id),
+      m_fingerprint(fingerprint)
+  { }
+
+  const char *GetType() const override { return "directorycacherevalidate"; }
+
+  bool DoWork() override
+  {
+    CSingleLock lock(m_context->m_section);
+    if (m_context->m_cache == nullptr)
+      return false;
+
+    m_context->m_cache->Revalidate(m_storedPath, m_fingerprint, m_id);
+    return true;
+  }
+
+private:
+  std::shared_ptr<CJobContext> m_context;
+  std::string m_storedPath;
+  unsigned int m_id;
+  uint32_t m_fingerprint;
+};
 
 CDirectoryCache::CDirectoryCache(void)
+  : m_jobContext(new CJobContext)
 {
-  m_accessCounter = 0;
+  m_memorySize = 0;
+  m_diskIndexLoaded = false;
+  m_diskSize = 0;
+  m_diskAccessCounter = 0;
+  m_pendingSaveCounter = 0;
+  m_jobContext->m_cache = this;
 #ifdef _DEBUG
   m_cacheHits = 0;
   m_cacheMisses = 0;
@@ -64,32 +137,73 @@ CDirectoryCache::CDirectoryCache(void)
 
 CDirectoryCache::~CDirectoryCache(void)
 {
+  CancelJobs();
 }
 
-bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
+void CDirectoryCache::CancelJobs()
 {
-  CSingleLock lock (m_cs);
+  // queued jobs find no cache left, a running one is waited for
+  CSingleLock lock(m_jobContext->m_section);
+  m_jobContext->m_cache = nullptr;
+}
 
+bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
+{
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
   {
-    CDir* dir = i->second;
-    if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
-       (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
+    CSingleLock lock (m_cs);
+
+    ciCache i = m_cache.find(storedPath);
+    if (i != m_cache.end())
     {
-      items.Copy(*dir->m_Items);
-      dir->SetLastAccess(m_accessCounter);
+      CDir* dir = i->second;
+      if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
+         (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
+      {
+        items.Copy(*dir->m_Items);
+        Touch(dir);
 #ifdef _DEBUG
-      m_cacheHits+=items.Size();
+        m_cacheHits+=items.Size();
 #endif
-      return true;
+        return true;
+      }
     }
   }
-  return false;
+
+  // the disk cache is only used when cached results were asked for
+  if (!retrieveAll || !IsDiskCacheable(storedPath))
+    return false;
+
+  // the time is remembered for SetDirectory(), as the listing fetched after a miss can't be older
+  int64_t modified = GetModificationTime(storedPath);
+  if (modified == 0)
+    return false;
+
+  {
+    CSingleLock lock (m_cs);
+    if (m_pendingModified.size() >= MAX_PENDING_MODIFIED)
+      m_pendingModified.clear();
+    m_pendingModified[storedPath] = modified;
+  }
+
+  uint32_t fingerprint;
+  if (!LoadFromDisk(storedPath, modified, items, fingerprint))
+    return false;
+
+  // files rewritten in place don't change the modification time of the directory
+  QueueRevalidation(storedPath, fingerprint);
+
+  // keep it in memory as well, so that FileExists() checks are fast
+  CSingleLock lock (m_cs);
+  iCache i = m_cache.find(storedPath);
+  if (i != m_cache.end())
+    Delete(i);
+  Insert(storedPath, items, DIR_CACHE_ONCE);
+  m_pendingModified.erase(storedPath);
+  return true;
 }
 
 void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType)
@@ -108,20 +222,33 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
   // IDEALLY, any further processing on the item would actually create a new item
   // instead of altering it, but we can't really enforce that in an easy way, so
   // this is the best solution for now.
-  CSingleLock lock (m_cs);
 
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ClearDirectory(storedPath);
+  bool persist = false;
+  int64_t modified = 0;
+  {
+    CSingleLock lock (m_cs);
 
-  CheckIfFull();
+    iCache i = m_cache.find(storedPath);
+    if (i != m_cache.end())
+      Delete(i);
 
-  CDir* dir = new CDir(cacheType);
-  dir->m_Items->Copy(items);
-  dir->SetLastAccess(m_accessCounter);
-  m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+    Insert(storedPath, items, cacheType);
+
+    std::map<std::string, int64_t>::iterator pending = m_pendingModified.find(storedPath);
+    if (pending != m_pendingModified.end())
+    {
+      persist = true;
+      modified = pending->second;
+      m_pendingModified.erase(pending);
+    }
+  }
+
+  if (persist && IsDiskCacheable(storedPath))
+    QueueSaveToDisk(storedPath, modified, items);
 }
 
 void CDirectoryCache::ClearFile(const std::string& strFile)
@@ -134,49 +261,71 @@ void CDirectoryCache::ClearFile(const std::string& strFile)
 
 void CDirectoryCache::ClearDirectory(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  iCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
-    Delete(i);
+  {
+    CSingleLock lock (m_cs);
+    iCache i = m_cache.find(storedPath);
+    if (i != m_cache.end())
+      Delete(i);
+  }
+
+  if (IsDiskCacheable(storedPath))
+  {
+    CancelPendingSaves(storedPath, false);
+    DeleteFromDisk(storedPath);
+  }
 }
 
 void CDirectoryCache::ClearSubPaths(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
   {
-    if (URIUtils::PathHasParent(i->first, storedPath))
-      Delete(i++);
-    else
-      i++;
+    CSingleLock lock (m_cs);
+    iCache i = m_cache.begin();
+    while (i != m_cache.end())
+    {
+      if (URIUtils::PathHasParent(i->first, storedPath))
+        Delete(i++);
+      else
+        i++;
+    }
+  }
+
+  if (IsDiskCacheable(storedPath))
+  {
+    CancelPendingSaves(storedPath, true);
+    DeleteSubPathsFromDisk(storedPath);
   }
 }
 
 void CDirectoryCache::AddFile(const std::string& strFile)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string strPath = URIUtils::GetDirectory(CURL(strFile).GetWithoutOptions());
   URIUtils::RemoveSlashAtEnd(strPath);
 
-  ciCache i = m_cache.find(strPath);
-  if (i != m_cache.end())
   {
-    CDir *dir = i->second;
-    CFileItemPtr item(new CFileItem(strFile, false));
-    dir->m_Items->Add(item);
-    dir->SetLastAccess(m_accessCounter);
+    CSingleLock lock (m_cs);
+    ciCache i = m_cache.find(strPath);
+    if (i != m_cache.end())
+    {
+      CDir *dir = i->second;
+      CFileItemPtr item(new CFileItem(strFile, false));
+      dir->m_Items->Add(item);
+      Touch(dir);
+    }
+  }
+
+  // the persisted listing no longer matches
+  if (IsDiskCacheable(strPath))
+  {
+    CancelPendingSaves(strPath, false);
+    DeleteFromDisk(strPath);
   }
 }
 
@@ -196,7 +345,7 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
   {
     bInCache = true;
     CDir *dir = i->second;
-    dir->SetLastAccess(m_accessCounter);
+    Touch(dir);
 #ifdef _DEBUG
     m_cacheHits++;
 #endif
@@ -210,12 +359,14 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
 
 void CDirectoryCache::Clear()
 {
-  // this routine clears everything
+  // this routine clears everything in memory. The listings on disk are validated
+  // against the directory on each use, so there is no need to drop them.
   CSingleLock lock (m_cs);
 
   iCache i = m_cache.begin();
   while (i != m_cache.end() )
     Delete(i++);
+  m_pendingModified.clear();
 }
 
 void CDirectoryCache::InitCache(std::set<std::string>& dirs)
@@ -246,46 +397,399 @@ void CDirectoryCache::CheckIfFull()
 {
   CSingleLock lock (m_cs);
 
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  iCache lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+  // remove the least recently used folders until we fit in our memory budget,
+  // always keeping the most recent one (it's the one we're currently working with)
+  std::list<std::string>::iterator it = m_lru.end();
+  while (m_memorySize > g_advancedSettings.m_dirCacheMemorySize && it != m_lru.begin())
   {
+    --it;
+    if (it == m_lru.begin())
+      break;
+
+    iCache i = m_cache.find(*it);
     // ensure dirs that are always cached aren't cleared
-    if (i->second->m_cacheType != DIR_CACHE_ALWAYS)
+    if (i != m_cache.end() && i->second->m_cacheType != DIR_CACHE_ALWAYS)
     {
-      if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
-        lastAccessed = i;
-      numCached++;
+      std::list<std::string>::iterator next = it;
+      ++next;
+      Delete(i);
+      it = next;
     }
   }
-  if (lastAccessed != m_cache.end() && numCached >= MAX_CACHED_DIRS)
-    Delete(lastAccessed);
 }
 
 void CDirectoryCache::Delete(iCache it)
 {
   CDir* dir = it->second;
+  if (dir->m_cacheType != DIR_CACHE_ALWAYS)
+    m_memorySize -= dir->m_size;
+  m_lru.erase(dir->m_lru);
   delete dir;
   m_cache.erase(it);
 }
 
+void CDirectoryCache::Touch(CDir *dir)
+{
+  m_lru.splice(m_lru.begin(), m_lru, dir->m_lru);
+}
+
+void CDirectoryCache::Insert(const std::string &storedPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType)
+{
+  CDir* dir = new CDir(cacheType);
+  dir->m_Items->Copy(items);
+  dir->m_size = EstimateSize(items);
+  dir->m_lru = m_lru.insert(m_lru.begin(), storedPath);
+  m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+
+  // dirs that are always cached don't count towards the budget, as they're never evicted
+  if (cacheType != DIR_CACHE_ALWAYS)
+    m_memorySize += dir->m_size;
+
+  CheckIfFull();
+}
+
+size_t CDirectoryCache::EstimateSize(const CFileItemList &items)
+{
+  size_t size = sizeof(CDir) + sizeof(CFileItemList);
+  for (int i = 0; i < items.Size(); ++i)
+  {
+    const CFileItemPtr item = items[i];
+    size += sizeof(CFileItem) + item->GetPath().size() + item->GetLabel().size() + item->GetLabel2().size();
+  }
+  return size;
+}
+
+bool CDirectoryCache::IsDiskCacheable(const std::string &storedPath) const
+{
+  if (g_advancedSettings.m_dirCacheDiskSize == 0)
+    return false;
+
+  // only network shares are slow enough to list to be worth it, and they report
+  // a directory modification time we can validate the listing against
+  return URIUtils::IsSmb(storedPath) || URIUtils::IsNfs(storedPath);
+}
+
+int64_t CDirectoryCache::GetModificationTime(const std::string &storedPath) const
+{
+  struct __stat64 buffer;
+  if (CFile::Stat(storedPath + "/", &buffer) != 0)
+    return 0;
+  return buffer.st_mtime;
+}
+
+bool CDirectoryCache::ListDirectory(const std::string &storedPath, CFileItemList &items) const
+{
+  const CURL url(storedPath + "/");
+  std::unique_ptr<IDirectory> directory(CDirectoryFactory::Create(url));
+  if (!directory)
+    return false;
+
+  return directory->GetDirectory(url, items);
+}
+
+uint32_t CDirectoryCache::GetFingerprint(const CFileItemList &items)
+{
+  // the order of the items doesn't matter
+  std::vector<std::string> entries;
+  entries.reserve(items.Size());
+  for (int i = 0; i < items.Size(); ++i)
+  {
+    const CFileItemPtr item = items[i];
+    entries.push_back(StringUtils::Format("%s|%" PRId64 "|%s", item->GetPath().c_str(), item->m_dwSize,
+                                          item->m_dateTime.GetAsDBDateTime().c_str()));
+  }
+  std::sort(entries.begin(), entries.end());
+
+  Crc32 crc;
+  for (std::vector<std::string>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+    crc.Compute(it->c_str(), it->size() + 1);
+  return crc;
+}
+
+bool CDirectoryCache::HasDiskEntry(const std::string &storedPath)
+{
+  CSingleLock lock(m_diskSection);
+  LoadDiskIndex();
+  return m_diskIndex.find(storedPath) != m_diskIndex.end();
+}
+
+bool CDirectoryCache::LoadFromDisk(const std::string &storedPath, int64_t modified, CFileItemList &items, uint32_t &fingerprint)
+{
+  CSingleLock lock(m_diskSection);
+  LoadDiskIndex();
+
+  DiskIndex::iterator entry = m_diskIndex.find(storedPath);
+  if (entry == m_diskIndex.end())
+    return false;
+
+  if (entry->second.m_modified != modified)
+  {
+    // the directory has changed since it was cached
+    DeleteFromDisk(storedPath);
+    return false;
+  }
+
+  CFile file;
+  try
+  {
+    if (file.Open(entry->second.m_cacheFile))
+    {
+      CArchive ar(&file, CArchive::load);
+      int version;
+      std::string path;
+      int64_t cachedModified;
+      ar >> version;
+      ar >> path;
+      ar >> cachedModified;
+      ar >> fingerprint;
+      if (version == DISK_CACHE_VERSION && path == storedPath && cachedModified == modified)
+      {
+        ar >> items;
+        ar.Close();
+        entry->second.m_lastAccess = ++m_diskAccessCounter;
+        CLog::Log(LOGDEBUG, "%s - loaded %i items for %s", __FUNCTION__, items.Size(), CURL::GetRedacted(storedPath).c_str());
+        return true;
+      }
+      ar.Close();
+    }
+  }
+  catch (std::out_of_range &)
+  {
+    CLog::Log(LOGERROR, "%s - corrupt cache file for %s", __FUNCTION__, CURL::GetRedacted(storedPath).c_str());
+  }
+  file.Close();
+
+  items.Clear();
+  DeleteFromDisk(storedPath);
+  return false;
+}
+
+void CDirectoryCache::QueueSaveToDisk(const std::string &storedPath, int64_t modified, const CFileItemList &items)
+{
+  unsigned int id = AddPendingSave(storedPath);
+  CJobManager::GetInstance().AddJob(new CSaveJob(m_jobContext, storedPath, id, modified, items), nullptr, CJob::PRIORITY_LOW);
+}
+
+void CDirectoryCache::QueueRevalidation(const std::string &storedPath, uint32_t fingerprint)
+{
+  unsigned int id = AddPendingSave(storedPath);
+  CJobManager::GetInstance().AddJob(new CRevalidateJob(m_jobContext, storedPath, id, fingerprint), nullptr, CJob::PRIORITY_LOW);
+}
+
+unsigned int CDirectoryCache::AddPendingSave(const std::string &storedPath)
+{
+  CSingleLock lock(m_diskSection);
+  unsigned int id = ++m_pendingSaveCounter;
+  m_pendingSaves[storedPath] = id;
+  return id;
+}
+
+void CDirectoryCache::CancelPendingSaves(const std::string &storedPath, bool subPaths)
+{
+  CSingleLock lock(m_diskSection);
+  for (std::map<std::string, unsigned int>::iterator it = m_pendingSaves.begin(); it != m_pendingSaves.end();)
+  {
+    if (subPaths ? URIUtils::PathHasParent(it->first, storedPath) : it->first == storedPath)
+      it = m_pendingSaves.erase(it);
+    else
+      ++it;
+  }
+}
+
+bool CDirectoryCache::SavePending(const std::string &storedPath, unsigned int id, int64_t modified, CFileItemList &items)
+{
+  CSingleLock lock(m_diskSection);
+  std::map<std::string, unsigned int>::iterator pending = m_pendingSaves.find(storedPath);
+  // the directory was cleared or listed again since this was queued
+  if (pending == m_pendingSaves.end() || pending->second != id)
+    return false;
+  m_pendingSaves.erase(pending);
+
+  SaveToDisk(storedPath, modified, items);
+  return true;
+}
+
+void CDirectoryCache::Revalidate(const std::string &storedPath, uint32_t fingerprint, unsigned int id)
+{
+  int64_t modified = GetModificationTime(storedPath);
+  CFileItemList items;
+  if (modified == 0 || !ListDirectory(storedPath, items))
+    return;
+
+  if (GetFingerprint(items) == fingerprint)
+  {
+    CSingleLock lock(m_diskSection);
+    std::map<std::string, unsigned int>::iterator pending = m_pendingSaves.find(storedPath);
+    if (pending != m_pendingSaves.end() && pending->second == id)
+      m_pendingSaves.erase(pending);
+    return;
+  }
+
+  CLog::Log(LOGDEBUG, "%s - items of %s have changed", __FUNCTION__, CURL::GetRedacted(storedPath).c_str());
+  if (!SavePending(storedPath, id, modified, items))
+    return;
+
+  // the listing in memory came from disk as well
+  CSingleLock lock(m_cs);
+  iCache i = m_cache.find(storedPath);
+  if (i != m_cache.end())
+    Delete(i);
+}
+
+void CDirectoryCache::SaveToDisk(const std::string &storedPath, int64_t modified, CFileItemList &items)
+{
+  CSingleLock lock(m_diskSection);
+  LoadDiskIndex();
+  DeleteFromDisk(storedPath);
+
+  CDiskEntry entry;
+  entry.m_cacheFile = StringUtils::Format(DISK_CACHE_PATH "%08x.cache", Crc32::ComputeFromLowerCase(storedPath));
+  entry.m_modified = modified;
+  entry.m_lastAccess = ++m_diskAccessCounter;
+
+  // another path with the same crc may own the file
+  for (DiskIndex::iterator it = m_diskIndex.begin(); it != m_diskIndex.end(); ++it)
+  {
+    if (it->second.m_cacheFile == entry.m_cacheFile)
+    {
+      DeleteFromDisk(it->first);
+      break;
+    }
+  }
+
+  CFile file;
+  if (!file.OpenForWrite(entry.m_cacheFile, true))
+    return;
+
+  CArchive ar(&file, CArchive::store);
+  int version = DISK_CACHE_VERSION;
+  ar << version;
+  ar << storedPath;
+  ar << modified;
+  ar << GetFingerprint(items);
+  ar << items;
+  ar.Close();
+  entry.m_size = file.GetLength();
+  file.Close();
+
+  m_diskIndex.insert(std::make_pair(storedPath, entry));
+  m_diskSize += entry.m_size;
+
+  CheckIfDiskFull();
+}
+
+void CDirectoryCache::DeleteFromDisk(const std::string &storedPath)
+{
+  CSingleLock lock(m_diskSection);
+  LoadDiskIndex();
+
+  DiskIndex::iterator it = m_diskIndex.find(storedPath);
+  if (it == m_diskIndex.end())
+    return;
+
+  CFile::Delete(it->second.m_cacheFile);
+  m_diskSize -= it->second.m_size;
+  m_diskIndex.erase(it);
+}
+
+void CDirectoryCache::DeleteSubPathsFromDisk(const std::string &storedPath)
+{
+  CSingleLock lock(m_diskSection);
+  LoadDiskIndex();
+
+  std::vector<std::string> paths;
+  for (DiskIndex::const_iterator it = m_diskIndex.begin(); it != m_diskIndex.end(); ++it)
+  {
+    if (URIUtils::PathHasParent(it->first, storedPath))
+      paths.push_back(it->first);
+  }
+  for (std::vector<std::string>::const_iterator it = paths.begin(); it != paths.end(); ++it)
+    DeleteFromDisk(*it);
+}
+
+void CDirectoryCache::LoadDiskIndex()
+{
+  if (m_diskIndexLoaded)
+    return;
+  m_diskIndexLoaded = true;
+
+  CDirectory::Create(DISK_CACHE_PATH);
+
+  CFileItemList files;
+  if (!CDirectory::GetDirectory(DISK_CACHE_PATH, files, ".cache", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE))
+    return;
+
+  // oldest files first, so that they are the first to be evicted
+  files.Sort(SortByDate, SortOrderAscending);
+  for (int i = 0; i < files.Size(); ++i)
+  {
+    const CFileItemPtr item = files[i];
+    CFile file;
+    bool valid = false;
+    try
+    {
+      if (file.Open(item->GetPath()))
+      {
+        CArchive ar(&file, CArchive::load);
+        int version;
+        CDiskEntry entry;
+        std::string path;
+        ar >> version;
+        if (version == DISK_CACHE_VERSION)
+        {
+          ar >> path;
+          ar >> entry.m_modified;
+          entry.m_cacheFile = item->GetPath();
+          entry.m_size = item->m_dwSize;
+          entry.m_lastAccess = ++m_diskAccessCounter;
+          valid = m_diskIndex.insert(std::make_pair(path, entry)).second;
+          if (valid)
+            m_diskSize += entry.m_size;
+        }
+        ar.Close();
+      }
+    }
+    catch (std::out_of_range &)
+    {
+    }
+    file.Close();
+
+    if (!valid)
+      CFile::Delete(item->GetPath());
+  }
+  CLog::Log(LOGDEBUG, "%s - %u cached directories using %" PRId64" bytes", __FUNCTION__, (unsigned int)m_diskIndex.size(), m_diskSize);
+
+  CheckIfDiskFull();
+}
+
+void CDirectoryCache::CheckIfDiskFull()
+{
+  while (m_diskSize > (int64_t)g_advancedSettings.m_dirCacheDiskSize && !m_diskIndex.empty())
+  {
+    DiskIndex::iterator oldest = m_diskIndex.begin();
+    for (DiskIndex::iterator it = m_diskIndex.begin(); it != m_diskIndex.end(); ++it)
+    {
+      if (it->second.m_lastAccess < oldest->second.m_lastAccess)
+        oldest = it;
+    }
+    DeleteFromDisk(oldest->first);
+  }
+}
+
 #ifdef _DEBUG
 void CDirectoryCache::PrintStats() const
 {
   CSingleLock lock (m_cs);
   CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, m_cacheHits, m_cacheMisses);
-  // run through and find the oldest and the number of items cached
-  unsigned int oldest = UINT_MAX;
+  // run through and find the number of items cached
   unsigned int numItems = 0;
   unsigned int numDirs = 0;
   for (ciCache i = m_cache.begin(); i != m_cache.end(); i++)
   {
     CDir *dir = i->second;
-    oldest = std::min(oldest, dir->GetLastAccess());
     numItems += dir->m_Items->Size();
     numDirs++;
   }
-  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total, using approx. %u bytes", __FUNCTION__, numDirs, numItems, (unsigned int)m_memorySize);
 }
 #endif
@@ -23,13 +23,27 @@
 #include "Directory.h"
 #include "threads/CriticalSection.h"
 
+#include <list>
 #include <map>
+#include <memory>
 #include <set>
 
 class CFileItem;
 
 namespace XFILE
 {
+  /*!
+   \brief Cache of directory listings.
+
+   Listings are kept in memory in least recently used order, bounded by their estimated size in bytes
+   (see advancedsettings <directorycache><memorysize>).  Listings of network shares (SMB/NFS) are also
+   persisted to a size bounded disk cache (<directorycache><disksize>) together with the modification
+   time of the directory, so that they can be reused across restarts for as long as the directory
+   hasn't changed. The disk cache is only read when cached results are requested (DIR_FLAG_READ_CACHE)
+   and is written from background jobs. As rewriting a file in place doesn't change the modification
+   time of its directory, a listing served from disk is compared with a fresh one in the background
+   and replaced if the names, sizes or dates of the items differ.
+   */
   class CDirectoryCache
   {
     class CDir
@@ -38,14 +52,28 @@ namespace XFILE
       CDir(DIR_CACHE_TYPE cacheType);
       virtual ~CDir();
 
-      void SetLastAccess(unsigned int &accessCounter);
-      unsigned int GetLastAccess() const { return m_lastAccess; };
-
       CFileItemList* m_Items;
       DIR_CACHE_TYPE m_cacheType;
-    private:
+      size_t m_size;                            ///< estimated memory used by the items
+      std::list<std::string>::iterator m_lru;   ///< position in the LRU list
+    };
+
+    struct CDiskEntry
+    {
+      std::string m_cacheFile;
+      int64_t m_modified;          ///< modification time of the cached directory
+      int64_t m_size;              ///< size of the cache file
       unsigned int m_lastAccess;
     };
+    /*! \brief Lets background jobs reach the cache for as long as it exists */
+    struct CJobContext
+    {
+      CCriticalSection m_section;
+      CDirectoryCache *m_cache;
+    };
+
+    class CSaveJob;
+    class CRevalidateJob;
   public:
     CDirectoryCache(void);
     virtual ~CDirectoryCache(void);
@@ -61,6 +89,9 @@ namespace XFILE
     void PrintStats() const;
 #endif
   protected:
+    /*! \brief Stop the background jobs from using the cache, to be called before it is destroyed */
+    void CancelJobs();
+
     void InitCache(std::set<std::string>& dirs);
     void ClearCache(std::set<std::string>& dirs);
     void CheckIfFull();
@@ -69,10 +100,59 @@ namespace XFILE
     typedef std::map<std::string, CDir*>::iterator iCache;
     typedef std::map<std::string, CDir*>::const_iterator ciCache;
     void Delete(iCache i);
+    void Touch(CDir *dir);
+    void Insert(const std::string &storedPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType);
+    static size_t EstimateSize(const CFileItemList &items);
+
+    /*! \brief Whether listings of this path are persisted to the disk cache */
+    virtual bool IsDiskCacheable(const std::string &storedPath) const;
+    virtual int64_t GetModificationTime(const std::string &storedPath) const;
+    /*! \brief List a directory bypassing the cache, used to revalidate listings loaded from disk */
+    virtual bool ListDirectory(const std::string &storedPath, CFileItemList &items) const;
+
+    /*! \brief Identifies the names, sizes and dates of the items of a listing */
+    static uint32_t GetFingerprint(const CFileItemList &items);
+
+    bool HasDiskEntry(const std::string &storedPath);
+    bool LoadFromDisk(const std::string &storedPath, int64_t modified, CFileItemList &items, uint32_t &fingerprint);
+    /*! \brief Persist a listing from a background job */
+    void QueueSaveToDisk(const std::string &storedPath, int64_t modified, const CFileItemList &items);
+    /*! \brief Compare a listing loaded from disk with a fresh one from a background job */
+    void QueueRevalidation(const std::string &storedPath, uint32_t fingerprint);
+    /*! \brief Register a background write of a listing, returns the id the job has to present */
+    unsigned int AddPendingSave(const std::string &storedPath);
+    /*! \brief Drop the background writes of a path (and of the paths below it) that haven't run yet */
+    void CancelPendingSaves(const std::string &storedPath, bool subPaths);
+    /*! \brief Persist a listing unless the write was cancelled or superseded since it was queued */
+    bool SavePending(const std::string &storedPath, unsigned int id, int64_t modified, CFileItemList &items);
+    void Revalidate(const std::string &storedPath, uint32_t fingerprint, unsigned int id);
+    void SaveToDisk(const std::string &storedPath, int64_t modified, CFileItemList &items);
+    void DeleteFromDisk(const std::string &storedPath);
+    void DeleteSubPathsFromDisk(const std::string &storedPath);
+    void LoadDiskIndex();
+    void CheckIfDiskFull();
 
     CCriticalSection m_cs;
 
-    unsigned int m_accessCounter;
+    std::list<std::string> m_lru; ///< cached paths, most recently used first
+    size_t m_memorySize;          ///< estimated memory used by listings that may be evicted
+
+    /*! modification times of directories taken before they were (re)fetched, so that the
+     listing stored to disk can't be newer than the time it is validated against */
+    std::map<std::string, int64_t> m_pendingModified;
+
+    /*! guards the disk cache. It may be held while taking m_cs (listing the cache folder goes
+     through CDirectory), so m_cs must never be held while taking it */
+    CCriticalSection m_diskSection;
+    typedef std::map<std::string, CDiskEntry> DiskIndex;
+    DiskIndex m_diskIndex;
+    bool m_diskIndexLoaded;
+    int64_t m_diskSize;
+    unsigned int m_diskAccessCounter;
+    std::map<std::string, unsigned int> m_pendingSaves; ///< id of the latest background write of each path
+    unsigned int m_pendingSaveCounter;
+
+    std::shared_ptr<CJobContext> m_jobContext;
 
 #ifdef _DEBUG
     unsigned int m_cacheHits;
@@ -0,0 +1,192 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DirectoryPrefetcher.h"
+
+#include "Directory.h"
+#include "FileItem.h"
+#include "URL.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+#include "utils/URIUtils.h"
+
+using namespace XFILE;
+
+struct CDirectoryPrefetcher::Listing
+{
+  enum State
+  {
+    QUEUED,  //!< waiting for a job
+    RUNNING, //!< being listed by a job
+    DONE,    //!< listed by a job
+    TAKEN    //!< listed by the caller itself, the job has nothing left to do
+  };
+
+  Listing() : state(QUEUED), result(false) {}
+
+  CCriticalSection critSection;
+  CEvent done;
+  State state;
+  bool result;
+  CFileItemList items;
+};
+
+class CDirectoryPrefetcher::CListingJob : public CJob
+{
+public:
+  CListingJob(const std::string &path, const Lister &lister, const std::shared_ptr<Listing> &listing)
+    : m_path(path),
+      m_lister(lister),
+      m_listing(listing)
+  { }
+
+  const char *GetType() const override { return "directoryprefetch"; }
+
+  bool DoWork() override
+  {
+    {
+      CSingleLock lock(m_listing->critSection);
+      if (m_listing->state != Listing::QUEUED)
+        return false;
+      m_listing->state = Listing::RUNNING;
+    }
+
+    // nobody else touches the items while the listing is running
+    m_listing->result = m_lister(m_path, m_listing->items);
+
+    {
+      CSingleLock lock(m_listing->critSection);
+      m_listing->state = Listing::DONE;
+    }
+    m_listing->done.Set();
+
+    return m_listing->result;
+  }
+
+private:
+  std::string m_path;
+  Lister m_lister;
+  std::shared_ptr<Listing> m_listing;
+};
+
+CDirectoryPrefetcher::CDirectoryPrefetcher(const std::string &mask, unsigned int jobsPerHost /* = 2 */)
+  : m_lister([mask](const std::string &path, CFileItemList &items) { return CDirectory::GetDirectory(path, items, mask); }),
+    m_jobsPerHost(jobsPerHost)
+{
+}
+
+CDirectoryPrefetcher::CDirectoryPrefetcher(const Lister &lister, unsigned int jobsPerHost /* = 2 */)
+  : m_lister(lister),
+    m_jobsPerHost(jobsPerHost)
+{
+}
+
+CDirectoryPrefetcher::~CDirectoryPrefetcher()
+{
+  Cancel();
+}
+
+void CDirectoryPrefetcher::Prefetch(const std::string &path)
+{
+  CSingleLock lock(m_critSection);
+  if (m_listings.size() >= MAX_PENDING_LISTINGS || m_listings.find(path) != m_listings.end())
+    return;
+
+  const CURL url(path);
+  const std::string host = url.GetProtocol() + "://" + url.GetHostName();
+  auto queue = m_queues.find(host);
+  if (queue == m_queues.end())
+    queue = m_queues.insert(std::make_pair(host, std::unique_ptr<CJobQueue>(new CJobQueue(false, m_jobsPerHost, CJob::PRIORITY_LOW)))).first;
+
+  std::shared_ptr<Listing> listing(new Listing);
+  if (queue->second->AddJob(new CListingJob(path, m_lister, listing)))
+    m_listings.insert(std::make_pair(path, listing));
+}
+
+bool CDirectoryPrefetcher::GetDirectory(const std::string &path, CFileItemList &items)
+{
+  std::shared_ptr<Listing> listing;
+  {
+    CSingleLock lock(m_critSection);
+    auto it = m_listings.find(path);
+    if (it != m_listings.end())
+    {
+      listing = it->second;
+      m_listings.erase(it);
+    }
+  }
+
+  if (listing)
+  {
+    bool bWait = false;
+    {
+      CSingleLock lock(listing->critSection);
+      if (listing->state == Listing::QUEUED)
+        listing->state = Listing::TAKEN;
+      else
+        bWait = true;
+    }
+
+    if (bWait)
+    {
+      listing->done.Wait();
+      items.Copy(listing->items);
+      return listing->result;
+    }
+  }
+
+  return m_lister(path, items);
+}
+
+void CDirectoryPrefetcher::Discard(const std::string &path)
+{
+  CSingleLock lock(m_critSection);
+  for (auto it = m_listings.begin(); it != m_listings.end();)
+  {
+    if (URIUtils::PathEquals(it->first, path, true) || URIUtils::PathHasParent(it->first, path))
+    {
+      // a queued job finds nothing left to do, a running one finishes into the void
+      {
+        CSingleLock listingLock(it->second->critSection);
+        if (it->second->state == Listing::QUEUED)
+          it->second->state = Listing::TAKEN;
+      }
+      it = m_listings.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+void CDirectoryPrefetcher::Cancel()
+{
+  CSingleLock lock(m_critSection);
+  for (const auto &listing : m_listings)
+  {
+    CSingleLock listingLock(listing.second->critSection);
+    if (listing.second->state == Listing::QUEUED)
+      listing.second->state = Listing::TAKEN;
+  }
+  m_listings.clear();
+
+  for (const auto &queue : m_queues)
+    queue.second->CancelJobs();
+}
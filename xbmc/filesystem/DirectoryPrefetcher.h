@@ -0,0 +1,108 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "threads/CriticalSection.h"
+
+class CFileItemList;
+class CJobQueue;
+
+namespace XFILE
+{
+  /*!
+   \brief Lists directories in the background before they are needed.
+
+   Library scans walk their sources one directory at a time, waiting for every listing in
+   turn. Directories that are going to be scanned soon can be passed to Prefetch(), they
+   are then listed by background jobs, with a limited number of jobs per host. This way
+   listings of different hosts overlap with each other and with the processing of the
+   current directory, while the caller still processes the directories in its own order.
+   */
+  class CDirectoryPrefetcher
+  {
+  public:
+    /*! \brief Function listing a directory, called from the background jobs and the caller */
+    typedef std::function<bool(const std::string &path, CFileItemList &items)> Lister;
+
+    /*!
+     \param mask the mask to list the directories with, see CDirectory::GetDirectory()
+     \param jobsPerHost the maximum number of directories listed at once on a single host
+     */
+    CDirectoryPrefetcher(const std::string &mask, unsigned int jobsPerHost = 2);
+
+    /*!
+     \param lister the function used to list the directories
+     \param jobsPerHost the maximum number of directories listed at once on a single host
+     */
+    CDirectoryPrefetcher(const Lister &lister, unsigned int jobsPerHost = 2);
+    ~CDirectoryPrefetcher();
+
+    /*!
+     \brief Start listing a directory in the background.
+     Does nothing if the directory is already being prefetched or too many listings are pending.
+     \param path the directory to list
+     */
+    void Prefetch(const std::string &path);
+
+    /*!
+     \brief Get the listing of a directory.
+     Waits for the prefetched listing if it is being fetched. A directory that wasn't
+     prefetched, or whose listing hasn't been started yet, is listed right away.
+     \param path the directory to list
+     \param items [out] the items of the directory
+     \return true if the directory could be listed, false otherwise
+     */
+    bool GetDirectory(const std::string &path, CFileItemList &items);
+
+    /*!
+     \brief Drop the listings of a directory and of everything below it.
+     To be called for directories the caller has finished with or decided to skip, so that
+     their listings don't count towards the limit of pending listings.
+     \param path the directory to drop the listings of
+     */
+    void Discard(const std::string &path);
+
+    /*!
+     \brief Drop all pending listings.
+     */
+    void Cancel();
+
+  private:
+    CDirectoryPrefetcher(const CDirectoryPrefetcher&) = delete;
+    CDirectoryPrefetcher& operator=(const CDirectoryPrefetcher&) = delete;
+
+    struct Listing;
+    class CListingJob;
+
+    static const size_t MAX_PENDING_LISTINGS = 64;
+
+    Lister m_lister;
+    unsigned int m_jobsPerHost;
+
+    CCriticalSection m_critSection;
+    std::map<std::string, std::shared_ptr<Listing>> m_listings;
+    std::map<std::string, std::unique_ptr<CJobQueue>> m_queues; //!< one queue per host
+  };
+}
@@ -24,6 +24,7 @@
 #include "File.h"
 #include "URL.h"
 
+#include "BlockCache.h"
 #include "CircularCache.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
@@ -207,8 +208,20 @@ bool CFileCache::Open(const CURL& url)
         front /= 2;
         back /= 2;
       }
-      m_pCache = new CCircularCache(front, back);
-      m_forwardCacheSize = front;
+      if (g_advancedSettings.m_cacheBlocks && m_seekPossible > 0 && m_fileSize > (int64_t)cacheSize &&
+          (m_flags & READ_AUDIO_VIDEO))
+      {
+        // keep what has been read around, so seeking back and forth (and to the container index
+        // at the head and tail of the file) doesn't need the source to deliver it again
+        CBlockCache *cache = new CBlockCache(front + back, m_fileSize);
+        m_forwardCacheSize = cache->GetMaxForwardSize();
+        m_pCache = cache;
+      }
+      else
+      {
+        m_pCache = new CCircularCache(front, back);
+        m_forwardCacheSize = front;
+      }
     }
 
     if (m_flags & READ_MULTI_STREAM)
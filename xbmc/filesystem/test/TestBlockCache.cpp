@@ -0,0 +1,192 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/BlockCache.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+// 16 blocks of 4 KiB, the first and last block of the file are pinned
+const size_t CACHE_SIZE = 16 * 4096;
+const int64_t BLOCK_SIZE = 4096;
+const int64_t FILE_SIZE = 1024 * 1024;
+
+char DataAt(int64_t pos)
+{
+  return (char)(pos * 7 % 251);
+}
+
+void Write(CBlockCache &cache, int64_t pos, size_t len)
+{
+  std::vector<char> buf(len);
+  for (size_t i = 0; i < len; i++)
+    buf[i] = DataAt(pos + i);
+
+  size_t done = 0;
+  while (done < len)
+  {
+    size_t size = cache.GetMaxWriteSize(len - done);
+    ASSERT_GT(size, 0U);
+    int written = cache.WriteToCache(buf.data() + done, size);
+    ASSERT_GT(written, 0);
+    done += written;
+  }
+}
+
+void Read(CBlockCache &cache, int64_t pos, size_t len)
+{
+  std::vector<char> buf(len);
+  size_t done = 0;
+  while (done < len)
+  {
+    int read = cache.ReadFromCache(buf.data() + done, len - done);
+    ASSERT_GT(read, 0);
+    done += read;
+  }
+  for (size_t i = 0; i < len; i++)
+    ASSERT_EQ(DataAt(pos + i), buf[i]) << "at position " << pos + i;
+}
+}
+
+TEST(TestBlockCache, SparseFill)
+{
+  CBlockCache cache(CACHE_SIZE, FILE_SIZE);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Write(cache, 0, 2 * BLOCK_SIZE);
+
+  // start writing elsewhere without dropping what we have
+  EXPECT_TRUE(cache.Reset(200000, false));
+  Write(cache, 200000, 2 * BLOCK_SIZE);
+
+  EXPECT_TRUE(cache.IsCachedPosition(0));
+  EXPECT_TRUE(cache.IsCachedPosition(5000));
+  EXPECT_FALSE(cache.IsCachedPosition(2 * BLOCK_SIZE));
+  EXPECT_FALSE(cache.IsCachedPosition(100000));
+  EXPECT_TRUE(cache.IsCachedPosition(200000));
+  EXPECT_TRUE(cache.IsCachedPosition(200000 + 2 * BLOCK_SIZE - 1));
+
+  EXPECT_EQ(2 * BLOCK_SIZE, cache.CachedDataEndPosIfSeekTo(0));
+  EXPECT_EQ(100000, cache.CachedDataEndPosIfSeekTo(100000));
+  EXPECT_EQ(200000 + 2 * BLOCK_SIZE, cache.CachedDataEndPosIfSeekTo(200100));
+  EXPECT_EQ(200000 + 2 * BLOCK_SIZE, cache.CachedDataEndPos());
+}
+
+TEST(TestBlockCache, OutOfOrderReads)
+{
+  CBlockCache cache(CACHE_SIZE, FILE_SIZE);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Write(cache, 0, 2 * BLOCK_SIZE);
+  cache.Reset(200000, false);
+  Write(cache, 200000, 2 * BLOCK_SIZE);
+
+  // cached, but not contiguous with the write position: the caller has to reset the cache there
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(1000));
+  EXPECT_FALSE(cache.Reset(1000, false));
+  EXPECT_EQ(2 * BLOCK_SIZE, cache.CachedDataEndPos());
+  Read(cache, 1000, 2 * BLOCK_SIZE - 1000);
+  char c;
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.ReadFromCache(&c, 1));
+
+  // back to the second run, which is read without fetching it again
+  EXPECT_FALSE(cache.Reset(200000, false));
+  EXPECT_EQ(200000 + 2 * BLOCK_SIZE, cache.CachedDataEndPos());
+  Read(cache, 200000, 1000);
+
+  // seeking within the write run doesn't need a reset
+  EXPECT_EQ(204000, cache.Seek(204000));
+  Read(cache, 204000, 200000 + 2 * BLOCK_SIZE - 204000);
+
+  // an uncached position is reported as such
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(100000));
+}
+
+TEST(TestBlockCache, Eviction)
+{
+  CBlockCache cache(CACHE_SIZE, FILE_SIZE);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  for (int64_t block = 0; block < 10; block++)
+  {
+    Write(cache, block * BLOCK_SIZE, BLOCK_SIZE);
+    Read(cache, block * BLOCK_SIZE, BLOCK_SIZE);
+  }
+
+  // read block 1 again, so that it becomes the most recently used one
+  EXPECT_FALSE(cache.Reset(BLOCK_SIZE, false));
+  Read(cache, BLOCK_SIZE, BLOCK_SIZE);
+  EXPECT_FALSE(cache.Reset(10 * BLOCK_SIZE, false));
+
+  // 11 more blocks don't fit, so the 5 least recently used ones are evicted
+  for (int64_t block = 10; block < 21; block++)
+  {
+    Write(cache, block * BLOCK_SIZE, BLOCK_SIZE);
+    Read(cache, block * BLOCK_SIZE, BLOCK_SIZE);
+  }
+
+  // the head of the file is pinned
+  EXPECT_TRUE(cache.IsCachedPosition(0));
+  EXPECT_TRUE(cache.IsCachedPosition(BLOCK_SIZE));
+  EXPECT_EQ(2 * BLOCK_SIZE, cache.CachedDataEndPosIfSeekTo(BLOCK_SIZE));
+  for (int64_t block = 2; block < 7; block++)
+    EXPECT_FALSE(cache.IsCachedPosition(block * BLOCK_SIZE)) << "block " << block;
+  EXPECT_EQ(21 * BLOCK_SIZE, cache.CachedDataEndPosIfSeekTo(7 * BLOCK_SIZE));
+
+  // evicted data is fetched again
+  EXPECT_TRUE(cache.Reset(3 * BLOCK_SIZE, false));
+  Write(cache, 3 * BLOCK_SIZE, BLOCK_SIZE);
+  Read(cache, 3 * BLOCK_SIZE, BLOCK_SIZE);
+}
+
+namespace
+{
+class CWholeReadAheadCache : public CBlockCache
+{
+public:
+  CWholeReadAheadCache() : CBlockCache(CACHE_SIZE, FILE_SIZE)
+  {
+    // let the read ahead fill every block, so that none of them can be evicted
+    m_maxForward = 2 * CACHE_SIZE;
+  }
+};
+}
+
+TEST(TestBlockCache, NoWriteSpaceWhileNothingCanBeEvicted)
+{
+  CWholeReadAheadCache cache;
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Write(cache, 0, CACHE_SIZE);
+
+  // all blocks are pinned or unread, so no write space may be reported
+  EXPECT_EQ(0U, cache.GetMaxWriteSize(BLOCK_SIZE));
+  EXPECT_EQ(0, cache.WriteToCache("x", 1));
+
+  // once a block has been read it can be evicted
+  Read(cache, 0, 2 * BLOCK_SIZE);
+  EXPECT_EQ((size_t)BLOCK_SIZE, cache.GetMaxWriteSize(BLOCK_SIZE));
+  Write(cache, CACHE_SIZE, BLOCK_SIZE);
+}
@@ -0,0 +1,302 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/DirectoryCache.h"
+#include "FileItem.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SystemClock.h"
+#include "utils/StringUtils.h"
+
+#ifdef TARGET_POSIX
+#include "linux/XTimeUtils.h"
+#endif
+
+#include <map>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+/* Listings of "test://" paths are persisted, their modification times and contents are
+ * provided by the test instead of a server */
+class CTestDirectoryCache : public CDirectoryCache
+{
+public:
+  ~CTestDirectoryCache()
+  {
+    CancelJobs();
+  }
+
+  bool IsDiskCacheable(const std::string &storedPath) const override
+  {
+    return StringUtils::StartsWith(storedPath, "test://");
+  }
+
+  int64_t GetModificationTime(const std::string &storedPath) const override
+  {
+    CSingleLock lock(m_section);
+    std::map<std::string, int64_t>::const_iterator it = m_modified.find(storedPath);
+    return it != m_modified.end() ? it->second : 0;
+  }
+
+  bool ListDirectory(const std::string &storedPath, CFileItemList &items) const override
+  {
+    CSingleLock lock(m_section);
+    std::map<std::string, CFileItemList*>::const_iterator it = m_listings.find(storedPath);
+    if (it == m_listings.end())
+      return false;
+    items.Copy(*it->second);
+    return true;
+  }
+
+  void SetServerDirectory(const std::string &storedPath, int64_t modified, CFileItemList *items)
+  {
+    CSingleLock lock(m_section);
+    m_modified[storedPath] = modified;
+    m_listings[storedPath] = items;
+  }
+
+  bool IsCached(const std::string &storedPath)
+  {
+    CSingleLock lock(m_cs);
+    return m_cache.find(storedPath) != m_cache.end();
+  }
+
+  size_t GetMemorySize()
+  {
+    CSingleLock lock(m_cs);
+    return m_memorySize;
+  }
+
+  // waits for the background write of a listing
+  bool WaitForDiskEntry(const std::string &storedPath)
+  {
+    XbmcThreads::EndTime timeout(5000);
+    while (!HasDiskEntry(storedPath))
+    {
+      if (timeout.IsTimePast())
+        return false;
+      Sleep(10);
+    }
+    return true;
+  }
+
+  using CDirectoryCache::EstimateSize;
+  using CDirectoryCache::HasDiskEntry;
+  using CDirectoryCache::AddPendingSave;
+  using CDirectoryCache::SavePending;
+  using CDirectoryCache::Revalidate;
+  using CDirectoryCache::GetFingerprint;
+
+private:
+  CCriticalSection m_section;
+  std::map<std::string, int64_t> m_modified;
+  std::map<std::string, CFileItemList*> m_listings;
+};
+
+void FillListing(CFileItemList &items, const std::string &path, int count, int64_t size = 100)
+{
+  items.Clear();
+  for (int i = 0; i < count; i++)
+  {
+    CFileItemPtr item(new CFileItem(StringUtils::Format("%s/file%02i.mkv", path.c_str(), i), false));
+    item->m_dwSize = size;
+    items.Add(item);
+  }
+}
+
+class TestDirectoryCache : public testing::Test
+{
+protected:
+  TestDirectoryCache()
+  {
+    m_memorySize = g_advancedSettings.m_dirCacheMemorySize;
+    m_diskSize = g_advancedSettings.m_dirCacheDiskSize;
+  }
+
+  ~TestDirectoryCache()
+  {
+    g_advancedSettings.m_dirCacheMemorySize = m_memorySize;
+    g_advancedSettings.m_dirCacheDiskSize = m_diskSize;
+  }
+
+  unsigned int m_memorySize;
+  unsigned int m_diskSize;
+};
+}
+
+TEST_F(TestDirectoryCache, EvictsLeastRecentlyUsed)
+{
+  CTestDirectoryCache cache;
+  CFileItemList items;
+  FillListing(items, "mem://host/a", 10);
+  const size_t size = CTestDirectoryCache::EstimateSize(items);
+
+  // room for three listings
+  g_advancedSettings.m_dirCacheMemorySize = 3 * size + size / 2;
+
+  const char *paths[] = { "mem://host/a", "mem://host/b", "mem://host/c" };
+  for (const char *path : paths)
+  {
+    FillListing(items, path, 10);
+    cache.SetDirectory(path, items, DIR_CACHE_ONCE);
+  }
+
+  // using the oldest listing makes the second one the least recently used
+  CFileItemList cached;
+  EXPECT_TRUE(cache.GetDirectory("mem://host/a", cached, true));
+  EXPECT_EQ(10, cached.Size());
+
+  FillListing(items, "mem://host/d", 10);
+  cache.SetDirectory("mem://host/d", items, DIR_CACHE_ONCE);
+
+  EXPECT_TRUE(cache.IsCached("mem://host/a"));
+  EXPECT_FALSE(cache.IsCached("mem://host/b"));
+  EXPECT_TRUE(cache.IsCached("mem://host/c"));
+  EXPECT_TRUE(cache.IsCached("mem://host/d"));
+}
+
+TEST_F(TestDirectoryCache, StaysWithinMemoryLimit)
+{
+  CTestDirectoryCache cache;
+  g_advancedSettings.m_dirCacheMemorySize = 64 * 1024;
+
+  CFileItemList items;
+  for (int i = 0; i < 100; i++)
+  {
+    std::string path = StringUtils::Format("mem://host/dir%02i", i);
+    FillListing(items, path, 20);
+    cache.SetDirectory(path, items, DIR_CACHE_ONCE);
+    EXPECT_LE(cache.GetMemorySize(), g_advancedSettings.m_dirCacheMemorySize);
+  }
+  EXPECT_TRUE(cache.IsCached("mem://host/dir99"));
+  EXPECT_FALSE(cache.IsCached("mem://host/dir00"));
+
+  // listings that are always cached are never evicted and don't count towards the limit
+  FillListing(items, "mem://host/always", 20);
+  cache.SetDirectory("mem://host/always", items, DIR_CACHE_ALWAYS);
+  for (int i = 0; i < 100; i++)
+  {
+    std::string path = StringUtils::Format("mem://host/other%02i", i);
+    FillListing(items, path, 20);
+    cache.SetDirectory(path, items, DIR_CACHE_ONCE);
+  }
+  EXPECT_TRUE(cache.IsCached("mem://host/always"));
+  EXPECT_LE(cache.GetMemorySize(), g_advancedSettings.m_dirCacheMemorySize);
+
+  // the most recent listing is kept even if it doesn't fit on its own
+  FillListing(items, "mem://host/huge", 2000);
+  cache.SetDirectory("mem://host/huge", items, DIR_CACHE_ONCE);
+  EXPECT_TRUE(cache.IsCached("mem://host/huge"));
+}
+
+TEST_F(TestDirectoryCache, DiskRoundTrip)
+{
+  const std::string path = "test://host/share/movies";
+  CFileItemList server;
+  FillListing(server, path, 5);
+  CFileItemList items;
+
+  {
+    CTestDirectoryCache cache;
+    cache.SetServerDirectory(path, 1000, &server);
+
+    // the first listing is persisted
+    EXPECT_FALSE(cache.GetDirectory(path, items, true));
+    cache.SetDirectory(path, server, DIR_CACHE_ONCE);
+    ASSERT_TRUE(cache.WaitForDiskEntry(path));
+  }
+
+  {
+    // a new cache, e.g. after a restart, uses the persisted listing
+    CTestDirectoryCache cache;
+    cache.SetServerDirectory(path, 1000, &server);
+    EXPECT_TRUE(cache.GetDirectory(path, items, true));
+    ASSERT_EQ(5, items.Size());
+    EXPECT_EQ(server[3]->GetPath(), items[3]->GetPath());
+
+    // but not once the directory has changed
+    CTestDirectoryCache changed;
+    changed.SetServerDirectory(path, 2000, &server);
+    EXPECT_FALSE(changed.GetDirectory(path, items, true));
+    EXPECT_FALSE(changed.HasDiskEntry(path));
+  }
+}
+
+TEST_F(TestDirectoryCache, ClearingAPathOnlyDropsItsPendingWrites)
+{
+  CTestDirectoryCache cache;
+  CFileItemList items;
+  FillListing(items, "test://host/share/a", 2);
+
+  unsigned int idA = cache.AddPendingSave("test://host/share/a");
+  unsigned int idB = cache.AddPendingSave("test://host/share/b");
+  unsigned int idSub = cache.AddPendingSave("test://host/share/c/sub");
+
+  cache.ClearDirectory("test://host/share/a");
+  cache.ClearSubPaths("test://host/share/c");
+
+  EXPECT_FALSE(cache.SavePending("test://host/share/a", idA, 1000, items));
+  EXPECT_FALSE(cache.SavePending("test://host/share/c/sub", idSub, 1000, items));
+  EXPECT_TRUE(cache.SavePending("test://host/share/b", idB, 1000, items));
+  EXPECT_TRUE(cache.HasDiskEntry("test://host/share/b"));
+
+  // a newer write supersedes an older one
+  unsigned int older = cache.AddPendingSave("test://host/share/b");
+  unsigned int newer = cache.AddPendingSave("test://host/share/b");
+  EXPECT_FALSE(cache.SavePending("test://host/share/b", older, 1000, items));
+  EXPECT_TRUE(cache.SavePending("test://host/share/b", newer, 1000, items));
+
+  cache.ClearDirectory("test://host/share/b");
+  EXPECT_FALSE(cache.HasDiskEntry("test://host/share/b"));
+}
+
+TEST_F(TestDirectoryCache, RevalidatesFilesChangedInPlace)
+{
+  const std::string path = "test://host/share/tv";
+  CFileItemList server;
+  FillListing(server, path, 5);
+  CFileItemList items;
+
+  CTestDirectoryCache cache;
+  cache.SetServerDirectory(path, 1000, &server);
+  EXPECT_FALSE(cache.GetDirectory(path, items, true));
+  cache.SetDirectory(path, server, DIR_CACHE_ONCE);
+  ASSERT_TRUE(cache.WaitForDiskEntry(path));
+  const uint32_t fingerprint = CTestDirectoryCache::GetFingerprint(server);
+
+  // an unchanged listing is left alone
+  cache.Revalidate(path, fingerprint, cache.AddPendingSave(path));
+  EXPECT_TRUE(cache.IsCached(path));
+
+  // a file is rewritten, the directory keeps its modification time
+  server[2]->m_dwSize = 12345;
+  EXPECT_NE(fingerprint, CTestDirectoryCache::GetFingerprint(server));
+  cache.Revalidate(path, fingerprint, cache.AddPendingSave(path));
+  EXPECT_FALSE(cache.IsCached(path));
+
+  EXPECT_TRUE(cache.GetDirectory(path, items, true));
+  ASSERT_EQ(5, items.Size());
+  EXPECT_EQ(12345, items[2]->m_dwSize);
+
+  cache.ClearDirectory(path);
+}
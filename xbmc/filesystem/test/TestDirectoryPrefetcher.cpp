@@ -0,0 +1,155 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/DirectoryPrefetcher.h"
+#include "FileItem.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+
+#ifdef TARGET_POSIX
+#include "../linux/XTimeUtils.h"
+#endif
+
+#include <map>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+const std::string BLOCKING_PATH = "smb://host/blocking/";
+
+/* Lists every directory as a single item named after the directory. Listing BLOCKING_PATH
+ * blocks until released, keeping the only job of the host busy. */
+class TestDirectoryPrefetcher : public testing::Test
+{
+protected:
+  TestDirectoryPrefetcher()
+    : m_prefetcher([this](const std::string &path, CFileItemList &items) { return List(path, items); }, 1)
+  { }
+
+  ~TestDirectoryPrefetcher()
+  {
+    m_release.Set();
+  }
+
+  bool List(const std::string &path, CFileItemList &items)
+  {
+    {
+      CSingleLock lock(m_critSection);
+      m_listers[path].push_back(std::this_thread::get_id());
+    }
+
+    if (path == BLOCKING_PATH)
+    {
+      m_blocking.Set();
+      m_release.Wait();
+    }
+
+    items.Add(CFileItemPtr(new CFileItem(path + "item", false)));
+    return true;
+  }
+
+  std::vector<std::thread::id> Listers(const std::string &path)
+  {
+    CSingleLock lock(m_critSection);
+    return m_listers[path];
+  }
+
+  CCriticalSection m_critSection;
+  std::map<std::string, std::vector<std::thread::id>> m_listers;
+  CEvent m_blocking;
+  CEvent m_release;
+  CDirectoryPrefetcher m_prefetcher;
+};
+}
+
+TEST_F(TestDirectoryPrefetcher, QueuedListingIsTakenByCaller)
+{
+  const std::string path = "smb://host/queued/";
+
+  m_prefetcher.Prefetch(BLOCKING_PATH);
+  m_prefetcher.Prefetch(path);
+  ASSERT_TRUE(m_blocking.WaitMSec(5000));
+
+  // the job of the second directory is still waiting behind the blocking one
+  CFileItemList items;
+  EXPECT_TRUE(m_prefetcher.GetDirectory(path, items));
+  ASSERT_EQ(1, items.Size());
+  EXPECT_EQ(path + "item", items[0]->GetPath());
+
+  m_release.Set();
+  Sleep(100);
+
+  // listed once, by the caller, the queued job had nothing left to do
+  std::vector<std::thread::id> listers = Listers(path);
+  ASSERT_EQ(1U, listers.size());
+  EXPECT_EQ(std::this_thread::get_id(), listers[0]);
+}
+
+TEST_F(TestDirectoryPrefetcher, RunningListingIsWaitedFor)
+{
+  m_prefetcher.Prefetch(BLOCKING_PATH);
+  ASSERT_TRUE(m_blocking.WaitMSec(5000));
+
+  std::thread release([this]() { Sleep(100); m_release.Set(); });
+
+  CFileItemList items;
+  EXPECT_TRUE(m_prefetcher.GetDirectory(BLOCKING_PATH, items));
+  release.join();
+  ASSERT_EQ(1, items.Size());
+  EXPECT_EQ(BLOCKING_PATH + "item", items[0]->GetPath());
+
+  // listed once, by the job
+  std::vector<std::thread::id> listers = Listers(BLOCKING_PATH);
+  ASSERT_EQ(1U, listers.size());
+  EXPECT_NE(std::this_thread::get_id(), listers[0]);
+}
+
+TEST_F(TestDirectoryPrefetcher, DiscardDropsSubdirectories)
+{
+  const std::string skipped = "smb://host/skipped/";
+  const std::string sub = "smb://host/skipped/sub/";
+  const std::string other = "smb://host/other/";
+
+  m_prefetcher.Prefetch(BLOCKING_PATH);
+  m_prefetcher.Prefetch(skipped);
+  m_prefetcher.Prefetch(sub);
+  m_prefetcher.Prefetch(other);
+  ASSERT_TRUE(m_blocking.WaitMSec(5000));
+
+  m_prefetcher.Discard(skipped);
+  m_release.Set();
+  Sleep(100);
+
+  // the prefetched listing of the other directory is used
+  CFileItemList items;
+  EXPECT_TRUE(m_prefetcher.GetDirectory(other, items));
+  EXPECT_EQ(1, items.Size());
+  std::vector<std::thread::id> listers = Listers(other);
+  ASSERT_EQ(1U, listers.size());
+  EXPECT_NE(std::this_thread::get_id(), listers[0]);
+
+  // the discarded ones were never listed
+  EXPECT_TRUE(Listers(skipped).empty());
+  EXPECT_TRUE(Listers(sub).empty());
+}
@@ -26,6 +26,7 @@
 #include "filesystem/SpecialProtocol.h"
 #include "utils/MathUtils.h"
 #include "utils/log.h"
+#include "utils/TraceProfiler.h"
 #include "windowing/WindowingFactory.h"
 #include "URL.h"
 #include "filesystem/File.h"
@@ -355,6 +356,7 @@ void CGUIFontTTFBase::End()
 
 void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors, const vecText &text, uint32_t alignment, float maxPixelWidth, bool scrolling)
 {
+  TRACE_SCOPE("CGUIFontTTFBase::DrawTextInternal");
   Begin();
 
   uint32_t rawAlignment = alignment;
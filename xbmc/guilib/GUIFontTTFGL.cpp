@@ -58,6 +58,11 @@ CGUIFontTTFGL::~CGUIFontTTFGL(void)
 
 bool CGUIFontTTFGL::FirstBegin()
 {
+#if defined(HAS_GLES)
+  // queued GUI quads must be drawn before we touch texture and blend state
+  g_Windowing.FlushGUIQuads();
+#endif
+
   if (m_textureStatus == TEXTURE_REALLOCATED)
   {
     if (glIsTexture(m_nTexture))
@@ -154,6 +159,7 @@ void CGUIFontTTFGL::LastEnd()
   glEnableClientState(GL_VERTEX_ARRAY);
   glEnableClientState(GL_TEXTURE_COORD_ARRAY);
   glDrawArrays(GL_QUADS, 0, m_vertex.size());
+  g_Windowing.CountDrawCall();
   glPopClientAttrib();
 
   glActiveTexture(GL_TEXTURE1);
@@ -203,6 +209,7 @@ void CGUIFontTTFGL::LastEnd()
     glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, u));
 
     glDrawArrays(GL_TRIANGLES, 0, vecVertices.size());
+    g_Windowing.CountDrawCall();
   }
   if (!m_vertexTrans.empty())
   {
@@ -249,6 +256,7 @@ void CGUIFontTTFGL::LastEnd()
         glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (GLvoid *) (character*sizeof(SVertex)*4 + offsetof(SVertex, u)));
 
         glDrawElements(GL_TRIANGLES, 6 * count, GL_UNSIGNED_SHORT, 0);
+        g_Windowing.CountDrawCall();
       }
 
       glMatrixModview.Pop();
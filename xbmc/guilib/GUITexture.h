@@ -153,6 +153,7 @@ protected:
 
   float m_frameWidth, m_frameHeight;          // size in pixels of the actual frame within the texture
   float m_texCoordsScaleU, m_texCoordsScaleV; // scale factor for pixel->texture coordinates
+  CPoint m_texCoordsOffset;                   // position of the frame within the texture (atlas pages)
 
   // animations
   int m_currentLoop;
@@ -162,6 +163,7 @@ protected:
   float m_diffuseU, m_diffuseV;           // size of the diffuse frame (in tex coords)
   float m_diffuseScaleU, m_diffuseScaleV; // scale factor of the diffuse frame (from texture coords to diffuse tex coords)
   CPoint m_diffuseOffset;                 // offset into the diffuse frame (it's not always the origin)
+  CPoint m_diffuseTexOffset;              // position of the diffuse frame within its texture (atlas pages)
 
   bool m_allocateDynamically;
   enum ALLOCATE_TYPE { NO = 0, NORMAL, LARGE, NORMAL_FAILED, LARGE_FAILED };
@@ -46,91 +46,45 @@ void CGUITextureGLES::Begin(color_t color)
   if (m_diffuse.size())
     m_diffuse.m_textures[0]->LoadToGPU();
 
-  texture->BindToUnit(0);
+  m_batchState.texture = static_cast<CTexture*>(texture)->GetTextureObject();
+  m_batchState.diffuse = 0;
 
   // Setup Colors
-  m_col[0] = (GLubyte)GET_R(color);
-  m_col[1] = (GLubyte)GET_G(color);
-  m_col[2] = (GLubyte)GET_B(color);
-  m_col[3] = (GLubyte)GET_A(color);
+  m_batchState.color[0] = GET_R(color) / 255.0f;
+  m_batchState.color[1] = GET_G(color) / 255.0f;
+  m_batchState.color[2] = GET_B(color) / 255.0f;
+  m_batchState.color[3] = GET_A(color) / 255.0f;
 
-  bool hasAlpha = m_texture.m_textures[m_currentFrame]->HasAlpha() || m_col[3] < 255;
+  bool hasAlpha = texture->HasAlpha() || GET_A(color) < 255;
 
   if (m_diffuse.size())
   {
-    if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255 )
-    {
-      g_Windowing.EnableGUIShader(SM_MULTI);
-    }
+    if (color == 0xffffffff)
+      m_batchState.method = SM_MULTI;
     else
-    {
-      g_Windowing.EnableGUIShader(SM_MULTI_BLENDCOLOR);
-    }
+      m_batchState.method = SM_MULTI_BLENDCOLOR;
 
     hasAlpha |= m_diffuse.m_textures[0]->HasAlpha();
 
-    m_diffuse.m_textures[0]->BindToUnit(1);
-
+    m_batchState.diffuse = static_cast<CTexture*>(m_diffuse.m_textures[0])->GetTextureObject();
   }
   else
   {
-    if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255)
-    {
-      g_Windowing.EnableGUIShader(SM_TEXTURE_NOBLEND);
-    }
+    if (color == 0xffffffff)
+      m_batchState.method = SM_TEXTURE_NOBLEND;
     else
-    {
-      g_Windowing.EnableGUIShader(SM_TEXTURE);
-    }
+      m_batchState.method = SM_TEXTURE;
   }
 
-  if ( hasAlpha )
-  {
-    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
-    glEnable( GL_BLEND );
-  }
-  else
-  {
-    glDisable(GL_BLEND);
-  }
+  m_batchState.blend = hasAlpha;
   m_packedVertices.clear();
 }
 
 void CGUITextureGLES::End()
 {
-  GLint posLoc  = g_Windowing.GUIShaderGetPos();
-  GLint tex0Loc = g_Windowing.GUIShaderGetCoord0();
-  GLint tex1Loc = g_Windowing.GUIShaderGetCoord1();
-  GLint uniColLoc = g_Windowing.GUIShaderGetUniCol();
-
-  if(uniColLoc >= 0)
-  {
-    glUniform4f(uniColLoc,(m_col[0] / 255.0f), (m_col[1] / 255.0f), (m_col[2] / 255.0f), (m_col[3] / 255.0f));
-  }
-
-  if(m_diffuse.size())
-  {
-    glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&m_packedVertices[0] + offsetof(PackedVertex, u2));
-    glEnableVertexAttribArray(tex1Loc);
-  }
-  glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&m_packedVertices[0] + offsetof(PackedVertex, x));
-  glEnableVertexAttribArray(posLoc);
-  glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), (char*)&m_packedVertices[0] + offsetof(PackedVertex, u1));
-  glEnableVertexAttribArray(tex0Loc);
-
-  glDrawElements(GL_TRIANGLES, m_packedVertices.size()*6 / 4, GL_UNSIGNED_SHORT, m_idx.data());
-
-  if (m_diffuse.size())
-  {
-    glDisableVertexAttribArray(tex1Loc);
-    glActiveTexture(GL_TEXTURE0);
-  }
-
-  glDisableVertexAttribArray(posLoc);
-  glDisableVertexAttribArray(tex0Loc);
-
-  glEnable(GL_BLEND);
-  g_Windowing.DisableGUIShader();
+  // the quads are drawn once the render system flushes its batch, which lets
+  // consecutive textures sharing the same state go out in a single draw call
+  g_Windowing.AddGUIQuads(m_batchState, m_packedVertices);
 }
 
 void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
@@ -206,21 +160,12 @@ void CGUITextureGLES::Draw(float *x, float *y, float *z, const CRect &texture, c
     vertices[i].z = z[i];
     m_packedVertices.push_back(vertices[i]);
   }
-
-  if ((m_packedVertices.size() / 4) > (m_idx.size() / 6))
-  {
-    size_t i = m_packedVertices.size() - 4;
-    m_idx.push_back(i+0);
-    m_idx.push_back(i+1);
-    m_idx.push_back(i+2);
-    m_idx.push_back(i+2);
-    m_idx.push_back(i+3);
-    m_idx.push_back(i+0);
-  }
 }
 
 void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  g_Windowing.FlushGUIQuads();
+
   if (texture)
   {
     texture->LoadToGPU();
@@ -278,6 +223,7 @@ void CGUITextureGLES::DrawQuad(const CRect &rect, color_t color, CBaseTexture *t
     tex[2][1] = tex[3][1] = coords.y2;
   }
   glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_BYTE, idx);
+  g_Windowing.CountDrawCall();
 
   glDisableVertexAttribArray(posLoc);
   if (texture)
@@ -31,15 +31,7 @@
 #include "GUITexture.h"
 
 #include "system_gl.h"
-#include <vector>
-
-struct PackedVertex
-{
-  float x, y, z;
-  float u1, v1;
-  float u2, v2;
-};
-typedef std::vector<PackedVertex> PackedVertices;
+#include "rendering/gles/RenderSystemGLES.h"
 
 class CGUITextureGLES : public CGUITextureBase
 {
@@ -51,10 +43,8 @@ protected:
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation);
   void End();
 
-  GLubyte m_col[4];
-
+  GUIBatchState m_batchState;
   PackedVertices m_packedVertices;
-  std::vector<GLushort> m_idx;
 };
 
 #endif
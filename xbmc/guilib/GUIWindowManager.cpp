@@ -37,6 +37,7 @@
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/SeekHandler.h"
+#include "utils/TraceProfiler.h"
 
 #include "windows/GUIWindowHome.h"
 #include "events/windows/GUIWindowEventLog.h"
@@ -1026,6 +1027,7 @@ bool RenderOrderSortFunction(CGUIWindow *first, CGUIWindow *second)
 
 void CGUIWindowManager::Process(unsigned int currentTime)
 {
+  TRACE_SCOPE("CGUIWindowManager::Process");
   assert(g_application.IsCurrentThread());
   CSingleLock lock(g_graphicsContext);
 
@@ -1097,6 +1099,7 @@ void CGUIWindowManager::RenderEx() const
 
 bool CGUIWindowManager::Render()
 {
+  TRACE_SCOPE("CGUIWindowManager::Render");
   assert(g_application.IsCurrentThread());
   CSingleExit lock(g_graphicsContext);
 
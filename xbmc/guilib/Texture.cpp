@@ -22,6 +22,7 @@
 #include "windowing/WindowingFactory.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
+#include "utils/TraceProfiler.h"
 #include "DDSImage.h"
 #include "filesystem/File.h"
 #include "filesystem/ResourceFile.h"
@@ -105,6 +106,7 @@ void CBaseTexture::Allocate(unsigned int width, unsigned int height, unsigned in
 
   _aligned_free(m_pixels);
   m_pixels = NULL;
+  m_pendingRegions.clear();
   if (GetPitch() * GetRows() > 0)
   {
     size_t size = GetPitch() * GetRows();
@@ -154,6 +156,30 @@ void CBaseTexture::Update(unsigned int width, unsigned int height, unsigned int
     LoadToGPU();
 }
 
+void CBaseTexture::UpdateRegion(unsigned int x, unsigned int y, unsigned int width, unsigned int height, unsigned int pitch, const unsigned char *pixels)
+{
+  if (pixels == NULL || m_format != XB_FMT_A8R8G8B8 ||
+      x + width > m_textureWidth || y + height > m_textureHeight)
+    return;
+
+  unsigned int rowSize = GetPitch(width);
+  if (m_pixels)
+  {
+    // not uploaded yet, so patch the pixels that will be
+    for (unsigned int row = 0; row < height; row++)
+      memcpy(m_pixels + (y + row) * GetPitch() + GetPitch(x), pixels + row * pitch, rowSize);
+    return;
+  }
+
+  if (!m_loadedToGPU)
+    return;
+
+  Region region = { x, y, width, height, std::vector<unsigned char>(rowSize * height) };
+  for (unsigned int row = 0; row < height; row++)
+    memcpy(region.pixels.data() + row * rowSize, pixels + row * pitch, rowSize);
+  m_pendingRegions.push_back(std::move(region));
+}
+
 void CBaseTexture::ClampToEdge()
 {
   if (m_pixels == nullptr)
@@ -189,6 +215,7 @@ void CBaseTexture::ClampToEdge()
 
 CBaseTexture *CBaseTexture::LoadFromFile(const std::string& texturePath, unsigned int idealWidth, unsigned int idealHeight, bool requirePixels, const std::string& strMimeType)
 {
+  TRACE_SCOPE("CBaseTexture::LoadFromFile");
 #if defined(TARGET_ANDROID)
   CURL url(texturePath);
   if (url.IsProtocol("androidapp"))
@@ -220,6 +247,7 @@ CBaseTexture *CBaseTexture::LoadFromFile(const std::string& texturePath, unsigne
 
 CBaseTexture *CBaseTexture::LoadFromFileInMemory(unsigned char *buffer, size_t bufferSize, const std::string &mimeType, unsigned int idealWidth, unsigned int idealHeight)
 {
+  TRACE_SCOPE("CBaseTexture::LoadFromFileInMemory");
   CTexture *texture = new CTexture();
   if (texture->LoadFromFileInMem(buffer, bufferSize, mimeType, idealWidth, idealHeight))
     return texture;
@@ -23,6 +23,8 @@
 #include "system.h"
 #include "XBTF.h"
 #include "guilib/imagefactory.h"
+
+#include <vector>
 #ifdef TARGET_POSIX
 #include "linux/XMemUtils.h"
 #endif
@@ -77,6 +79,7 @@ public:
   bool LoadPaletted(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, const unsigned char *pixels, const COLOR *palette);
 
   bool HasAlpha() const;
+  void SetAlpha(bool hasAlpha) { m_hasAlpha = hasAlpha; }
 
   void SetMipmapping();
   bool IsMipmapped() const;
@@ -91,6 +94,8 @@ public:
   unsigned int GetRows() const { return GetRows(m_textureHeight); }
   unsigned int GetTextureWidth() const { return m_textureWidth; }
   unsigned int GetTextureHeight() const { return m_textureHeight; }
+  /*! \brief return the XB_FMT_* format of the pixel data */
+  unsigned int GetTextureFormat() const { return m_format; }
   unsigned int GetWidth() const { return m_imageWidth; }
   unsigned int GetHeight() const { return m_imageHeight; }
   /*! \brief return the original width of the image, before scaling/cropping */
@@ -105,6 +110,12 @@ public:
   void Allocate(unsigned int width, unsigned int height, unsigned int format);
   void ClampToEdge();
 
+  /*! \brief Replace a rectangle of an A8R8G8B8 texture
+   Patches the pixels if the texture hasn't been uploaded yet. Otherwise only the rectangle is
+   uploaded, on the next call to LoadToGPU().
+   */
+  void UpdateRegion(unsigned int x, unsigned int y, unsigned int width, unsigned int height, unsigned int pitch, const unsigned char *pixels);
+
   static unsigned int PadPow2(unsigned int x);
   static bool SwapBlueRed(unsigned char *pixels, unsigned int height, unsigned int pitch, unsigned int elements = 4, unsigned int offset=0);
 
@@ -131,6 +142,13 @@ protected:
 
   unsigned char* m_pixels;
   bool m_loadedToGPU;
+
+  struct Region
+  {
+    unsigned int x, y, width, height;
+    std::vector<unsigned char> pixels; ///< rows of the rectangle, without padding
+  };
+  std::vector<Region> m_pendingRegions; ///< rectangles updated since the texture was uploaded
   unsigned int m_format;
   int m_orientation;
   bool m_hasAlpha;
@@ -0,0 +1,249 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#include "GraphicContext.h"
+#include "Texture.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "windowing/WindowingFactory.h"
+
+#define ATLAS_GUTTER 1
+
+CTextureAtlasPacker::CTextureAtlasPacker(unsigned int width, unsigned int height)
+  : m_width(width)
+  , m_height(height)
+  , m_usedArea(0)
+{
+  m_skyline.push_back({0, 0, width});
+}
+
+bool CTextureAtlasPacker::Fit(size_t index, unsigned int width, unsigned int height, unsigned int &y) const
+{
+  unsigned int x = m_skyline[index].x;
+  if (x + width > m_width)
+    return false;
+
+  // the rectangle rests on the highest segment below it
+  unsigned int remaining = width;
+  y = m_skyline[index].y;
+  for (size_t i = index; i < m_skyline.size(); ++i)
+  {
+    y = std::max(y, m_skyline[i].y);
+    if (y + height > m_height)
+      return false;
+    if (m_skyline[i].width >= remaining)
+      break;
+    remaining -= m_skyline[i].width;
+  }
+  return true;
+}
+
+bool CTextureAtlasPacker::Insert(unsigned int width, unsigned int height, unsigned int &x, unsigned int &y)
+{
+  if (width == 0 || height == 0)
+    return false;
+
+  size_t best = m_skyline.size();
+  unsigned int bestY = 0;
+  unsigned int bestTop = UINT_MAX;
+  unsigned int bestWidth = UINT_MAX;
+  for (size_t i = 0; i < m_skyline.size(); ++i)
+  {
+    unsigned int top;
+    if (!Fit(i, width, height, top))
+      continue;
+    if (top + height < bestTop || (top + height == bestTop && m_skyline[i].width < bestWidth))
+    {
+      best = i;
+      bestY = top;
+      bestTop = top + height;
+      bestWidth = m_skyline[i].width;
+    }
+  }
+  if (best == m_skyline.size())
+    return false;
+
+  Segment segment = { m_skyline[best].x, bestY + height, width };
+  m_skyline.insert(m_skyline.begin() + best, segment);
+
+  // cut away whatever the new segment now covers
+  for (size_t i = best + 1; i < m_skyline.size();)
+  {
+    const Segment &previous = m_skyline[i - 1];
+    Segment &current = m_skyline[i];
+    unsigned int previousEnd = previous.x + previous.width;
+    if (current.x >= previousEnd)
+      break;
+
+    unsigned int shrink = previousEnd - current.x;
+    if (current.width <= shrink)
+    {
+      m_skyline.erase(m_skyline.begin() + i);
+      continue;
+    }
+    current.x += shrink;
+    current.width -= shrink;
+    break;
+  }
+
+  // merge neighbours of equal height
+  for (size_t i = 0; i + 1 < m_skyline.size();)
+  {
+    if (m_skyline[i].y == m_skyline[i + 1].y)
+    {
+      m_skyline[i].width += m_skyline[i + 1].width;
+      m_skyline.erase(m_skyline.begin() + i + 1);
+    }
+    else
+      ++i;
+  }
+
+  x = segment.x;
+  y = bestY;
+  m_usedArea += width * height;
+  return true;
+}
+
+CTextureAtlas::Page::Page(unsigned int size, bool alpha)
+  : texture(new CTexture())
+  , packer(size, size)
+  , references(0)
+  , hasAlpha(alpha)
+{
+}
+
+CTextureAtlas::Page::~Page()
+{
+  delete texture;
+}
+
+CTextureAtlas::CTextureAtlas(unsigned int pageSize, unsigned int maxImageSize)
+  : m_pageSize(pageSize)
+  , m_maxImageSize(maxImageSize)
+{
+}
+
+CTextureAtlas::~CTextureAtlas()
+{
+  if (!m_pages.empty())
+    CLog::Log(LOGWARNING, "%s: %u atlas pages still in use", __FUNCTION__, GetPageCount());
+}
+
+bool CTextureAtlas::CanAdd(const CBaseTexture *texture) const
+{
+  return texture &&
+         texture->GetPixels() &&
+         texture->GetTextureFormat() == XB_FMT_A8R8G8B8 &&
+         !texture->IsMipmapped() &&
+         texture->GetOrientation() == 0 &&
+         texture->GetWidth() > 0 && texture->GetWidth() <= m_maxImageSize &&
+         texture->GetHeight() > 0 && texture->GetHeight() <= m_maxImageSize;
+}
+
+static void CopyWithGutter(const CBaseTexture *texture, unsigned char *dst, unsigned int dstPitch, unsigned int x, unsigned int y)
+{
+  const unsigned char *src = texture->GetPixels();
+  unsigned int srcPitch = texture->GetPitch();
+  int width = texture->GetWidth();
+  int height = texture->GetHeight();
+
+  for (int row = -ATLAS_GUTTER; row < height + ATLAS_GUTTER; ++row)
+  {
+    const unsigned char *srcRow = src + std::min(std::max(row, 0), height - 1) * srcPitch;
+    unsigned char *dstRow = dst + (y + ATLAS_GUTTER + row) * dstPitch + x * 4;
+    for (int i = 0; i < ATLAS_GUTTER; ++i)
+      memcpy(dstRow + i * 4, srcRow, 4);
+    dstRow += ATLAS_GUTTER * 4;
+    memcpy(dstRow, srcRow, width * 4);
+    dstRow += width * 4;
+    for (int i = 0; i < ATLAS_GUTTER; ++i)
+      memcpy(dstRow + i * 4, srcRow + (width - 1) * 4, 4);
+  }
+}
+
+CBaseTexture* CTextureAtlas::Add(const CBaseTexture *texture, unsigned int &x, unsigned int &y)
+{
+  if (!CanAdd(texture))
+    return NULL;
+
+  // pages are released and their textures uploaded from the render thread
+  CSingleLock lock(g_graphicsContext);
+  bool hasAlpha = texture->HasAlpha();
+  unsigned int width = texture->GetWidth() + 2 * ATLAS_GUTTER;
+  unsigned int height = texture->GetHeight() + 2 * ATLAS_GUTTER;
+
+  Page *page = NULL;
+  unsigned int cellX, cellY;
+  for (auto &it : m_pages)
+  {
+    if (it->hasAlpha == hasAlpha && it->packer.Insert(width, height, cellX, cellY))
+    {
+      page = it.get();
+      break;
+    }
+  }
+
+  if (!page)
+  {
+    unsigned int size = std::min(m_pageSize, g_Windowing.GetMaxTextureSize());
+    if (width > size || height > size)
+      return NULL;
+
+    m_pages.emplace_back(new Page(size, hasAlpha));
+    page = m_pages.back().get();
+    page->packer.Insert(width, height, cellX, cellY);
+    page->texture->Allocate(size, size, XB_FMT_A8R8G8B8);
+    page->texture->SetAlpha(hasAlpha);
+    if (page->texture->GetPixels())
+      memset(page->texture->GetPixels(), 0, page->texture->GetPitch() * page->texture->GetRows());
+    CLog::Log(LOGDEBUG, "%s: created %ux%u %s page, %u pages in use", __FUNCTION__, size, size,
+              hasAlpha ? "alpha" : "opaque", GetPageCount());
+  }
+
+  // the pixels of the page are freed once it is uploaded, after that only this cell is uploaded
+  std::vector<unsigned char> cell(width * height * 4);
+  CopyWithGutter(texture, cell.data(), width * 4, 0, 0);
+  page->texture->UpdateRegion(cellX, cellY, width, height, width * 4, cell.data());
+
+  page->references++;
+  x = cellX + ATLAS_GUTTER;
+  y = cellY + ATLAS_GUTTER;
+  return page->texture;
+}
+
+void CTextureAtlas::Release(const CBaseTexture *texture)
+{
+  CSingleLock lock(g_graphicsContext);
+  for (auto it = m_pages.begin(); it != m_pages.end(); ++it)
+  {
+    if ((*it)->texture != texture)
+      continue;
+
+    if (--(*it)->references == 0)
+      m_pages.erase(it);
+    return;
+  }
+}
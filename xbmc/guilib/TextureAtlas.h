@@ -0,0 +1,116 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+class CBaseTexture;
+
+/*!
+ \ingroup textures
+ \brief Skyline rectangle packer used to lay out atlas pages
+ */
+class CTextureAtlasPacker
+{
+public:
+  CTextureAtlasPacker(unsigned int width, unsigned int height);
+
+  /*! \brief Find room for a rectangle on the page
+   Uses the bottom-left rule: the rectangle goes where its top edge ends up lowest.
+   \param width width of the rectangle
+   \param height height of the rectangle
+   \param x [out] left edge of the rectangle on the page
+   \param y [out] top edge of the rectangle on the page
+   \return true if the rectangle fits, false if the page is full
+   */
+  bool Insert(unsigned int width, unsigned int height, unsigned int &x, unsigned int &y);
+
+  unsigned int GetWidth() const { return m_width; }
+  unsigned int GetHeight() const { return m_height; }
+  unsigned int GetUsedArea() const { return m_usedArea; }
+
+private:
+  struct Segment
+  {
+    unsigned int x;
+    unsigned int y;
+    unsigned int width;
+  };
+
+  bool Fit(size_t index, unsigned int width, unsigned int height, unsigned int &y) const;
+
+  unsigned int m_width;
+  unsigned int m_height;
+  unsigned int m_usedArea;
+  std::vector<Segment> m_skyline;
+};
+
+/*!
+ \ingroup textures
+ \brief Packs small GUI images into shared texture pages
+
+ Images are copied into a page with a one pixel border that repeats their
+ edge pixels, so bilinear filtering never picks up a neighbour. The pixels
+ of a page are only kept until it is uploaded to the GPU. A page can still
+ take new images afterwards, only their rectangle is then uploaded the next
+ time the page is used. Opaque and translucent images go to separate pages,
+ so opaque textures keep rendering without blending.
+ */
+class CTextureAtlas
+{
+public:
+  CTextureAtlas(unsigned int pageSize = 2048, unsigned int maxImageSize = 256);
+  ~CTextureAtlas();
+
+  /*! \brief Whether the texture is small enough and in a format we can pack */
+  bool CanAdd(const CBaseTexture *texture) const;
+
+  /*! \brief Copy a texture into an atlas page
+   The caller keeps ownership of texture and may delete it afterwards.
+   \param texture the texture to copy, its pixels must not have been uploaded yet
+   \param x [out] left edge of the image within the returned page
+   \param y [out] top edge of the image within the returned page
+   \return the page holding the image, owned by the atlas, or NULL on failure
+   */
+  CBaseTexture* Add(const CBaseTexture *texture, unsigned int &x, unsigned int &y);
+
+  /*! \brief Drop one image reference to a page, the page is freed with its last image */
+  void Release(const CBaseTexture *page);
+
+  unsigned int GetPageCount() const { return m_pages.size(); }
+
+private:
+  struct Page
+  {
+    Page(unsigned int size, bool alpha);
+    ~Page();
+
+    CBaseTexture *texture;
+    CTextureAtlasPacker packer;
+    unsigned int references;
+    bool hasAlpha;
+  };
+
+  unsigned int m_pageSize;
+  unsigned int m_maxImageSize;
+  std::vector<std::unique_ptr<Page> > m_pages;
+};
@@ -79,7 +79,9 @@ void CDXTexture::LoadToGPU()
 {
   if (!m_pixels)
   {
-    // nothing to load - probably same image (no change)
+    // nothing to load - probably same image (no change), apart from updated rectangles
+    if (!m_pendingRegions.empty())
+      LoadRegionsToGPU();
     return;
   }
 
@@ -87,6 +89,8 @@ void CDXTexture::LoadToGPU()
   D3D11_USAGE usage = g_Windowing.DefaultD3DUsage();
   if (m_format == XB_FMT_RGB8 && usage == D3D11_USAGE_DEFAULT)
     usage = D3D11_USAGE_DYNAMIC; // fallback to dynamic to allow CPU write to texture
+  else if (m_format == XB_FMT_A8R8G8B8)
+    usage = D3D11_USAGE_DEFAULT; // UpdateRegion() rectangles are uploaded with UpdateSubresource()
 
   if (m_texture.Get() == nullptr)
   {
@@ -189,6 +193,31 @@ void CDXTexture::LoadToGPU()
   m_loadedToGPU = true;
 }
 
+void CDXTexture::LoadRegionsToGPU()
+{
+  ID3D11DeviceContext* pContext = g_Windowing.GetImmediateContext();
+  if (m_texture.Get() && pContext)
+  {
+    // UpdateSubresource() is invalid on dynamic textures, which LoadToGPU() creates when the
+    // whole texture is uploaded again. Dynamic textures can only be mapped with discard.
+    D3D11_TEXTURE2D_DESC texDesc;
+    m_texture.GetDesc(&texDesc);
+    if (texDesc.Usage != D3D11_USAGE_DEFAULT)
+    {
+      CLog::Log(LOGERROR, "%s - unable to update a texture with usage %d", __FUNCTION__, texDesc.Usage);
+      m_pendingRegions.clear();
+      return;
+    }
+
+    for (const auto &region : m_pendingRegions)
+    {
+      CD3D11_BOX box(region.x, region.y, 0, region.x + region.width, region.y + region.height, 1);
+      pContext->UpdateSubresource(m_texture.Get(), 0, &box, region.pixels.data(), GetPitch(region.width), 0);
+    }
+  }
+  m_pendingRegions.clear();
+}
+
 void CDXTexture::BindToUnit(unsigned int unit)
 {
 }
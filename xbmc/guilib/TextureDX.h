@@ -49,6 +49,9 @@ public:
   };
 
 private:
+  /*! \brief Upload the rectangles updated since the texture was loaded to the GPU */
+  void LoadRegionsToGPU();
+
   CD3DTexture m_texture;
   DXGI_FORMAT GetFormat();
 };
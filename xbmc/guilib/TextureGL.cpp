@@ -60,7 +60,9 @@ void CGLTexture::LoadToGPU()
 {
   if (!m_pixels)
   {
-    // nothing to load - probably same image (no change)
+    // nothing to load - probably same image (no change), apart from updated rectangles
+    if (!m_pendingRegions.empty())
+      LoadRegionsToGPU();
     return;
   }
   if (m_texture == 0)
@@ -204,6 +206,38 @@ void CGLTexture::LoadToGPU()
   m_loadedToGPU = true;
 }
 
+void CGLTexture::LoadRegionsToGPU()
+{
+  if (m_texture == 0)
+    return;
+
+  glBindTexture(GL_TEXTURE_2D, m_texture);
+
+#ifndef HAS_GLES
+  GLenum pixelformat = GL_BGRA;
+#else
+#ifndef GL_BGRA_EXT
+#define GL_BGRA_EXT 0x80E1
+#endif
+  // must match the format the texture was created with, see LoadToGPU()
+  bool swap = !g_Windowing.SupportsBGRA() && !g_Windowing.SupportsBGRAApple();
+  GLenum pixelformat = swap ? GL_RGBA : GL_BGRA_EXT;
+#endif
+
+  for (auto &region : m_pendingRegions)
+  {
+#ifdef HAS_GLES
+    if (swap)
+      SwapBlueRed(region.pixels.data(), region.height, GetPitch(region.width));
+#endif
+    glTexSubImage2D(GL_TEXTURE_2D, 0, region.x, region.y, region.width, region.height,
+      pixelformat, GL_UNSIGNED_BYTE, region.pixels.data());
+  }
+  m_pendingRegions.clear();
+
+  VerifyGLState();
+}
+
 void CGLTexture::BindToUnit(unsigned int unit)
 {
   glActiveTexture(GL_TEXTURE0 + unit);
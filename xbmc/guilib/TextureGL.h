@@ -39,8 +39,12 @@ public:
   virtual void DestroyTextureObject();
   void LoadToGPU();
   void BindToUnit(unsigned int unit);
+  GLuint GetTextureObject() const { return m_texture; }
 
 protected:
+  /*! \brief Upload the rectangles updated since the texture was loaded to the GPU */
+  void LoadRegionsToGPU();
+
   GLuint m_texture;
 };
 
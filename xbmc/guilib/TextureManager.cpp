@@ -26,6 +26,7 @@
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
 #include "GraphicContext.h"
+#include "settings/AdvancedSettings.h"
 #include "system.h"
 #include "Texture.h"
 #include "threads/SingleLock.h"
@@ -33,14 +34,13 @@
 #include "URL.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/TraceProfiler.h"
 #include "utils/URIUtils.h"
 
 #ifdef _DEBUG_TEXTURES
 #include "utils/TimeUtils.h"
 #endif
-#if defined(TARGET_DARWIN_IOS)
 #include "windowing/WindowingFactory.h" // for g_Windowing in CGUITextureManager::FreeUnusedTextures
-#endif
 #include "FFmpegImage.h"
 
 /************************************************************************/
@@ -54,6 +54,8 @@ CTextureArray::CTextureArray(int width, int height, int loops,  bool texCoordsAr
   m_orientation = 0;
   m_texWidth = 0;
   m_texHeight = 0;
+  m_texOffsetX = 0;
+  m_texOffsetY = 0;
   m_texCoordsArePixels = false;
 }
 
@@ -83,6 +85,8 @@ void CTextureArray::Reset()
   m_orientation = 0;
   m_texWidth = 0;
   m_texHeight = 0;
+  m_texOffsetX = 0;
+  m_texOffsetY = 0;
   m_texCoordsArePixels = false;
 }
 
@@ -131,6 +135,7 @@ CTextureMap::CTextureMap()
 {
   m_referenceCount = 0;
   m_memUsage = 0;
+  m_atlas = NULL;
 }
 
 CTextureMap::CTextureMap(const std::string& textureName, int width, int height, int loops)
@@ -139,6 +144,7 @@ CTextureMap::CTextureMap(const std::string& textureName, int width, int height,
 {
   m_referenceCount = 0;
   m_memUsage = 0;
+  m_atlas = NULL;
 }
 
 CTextureMap::~CTextureMap()
@@ -194,7 +200,16 @@ void CTextureMap::Flush()
 
 void CTextureMap::FreeTexture()
 {
-  m_texture.Free();
+  if (m_atlas)
+  {
+    // the pages are shared, hand our references back instead of deleting them
+    for (unsigned int i = 0; i < m_texture.m_textures.size(); i++)
+      m_atlas->Release(m_texture.m_textures[i]);
+    m_texture.Reset();
+    m_atlas = NULL;
+  }
+  else
+    m_texture.Free();
 }
 
 void CTextureMap::SetHeight(int height)
@@ -220,6 +235,16 @@ void CTextureMap::Add(CBaseTexture* texture, int delay)
     m_memUsage += sizeof(CTexture) + (texture->GetTextureWidth() * texture->GetTextureHeight() * 4);
 }
 
+void CTextureMap::AddFromAtlas(CTextureAtlas *atlas, CBaseTexture *page, int x, int y)
+{
+  m_atlas = atlas;
+  m_texture.Add(page, 100);
+  m_texture.m_texOffsetX = x;
+  m_texture.m_texOffsetY = y;
+
+  m_memUsage += m_texture.m_width * m_texture.m_height * 4;
+}
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -294,6 +319,7 @@ bool CGUITextureManager::HasTexture(const std::string &textureName, std::string
 
 const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName, bool checkBundleOnly /*= false */)
 {
+  TRACE_SCOPE("CGUITextureManager::Load");
   std::string strPath;
   static CTextureArray emptyTexture;
   int bundle = -1;
@@ -458,7 +484,20 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
   if (!pTexture) return emptyTexture;
 
   CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
-  pMap->Add(pTexture, 100);
+
+  // small images share atlas pages, which saves texture binds and allocations
+  unsigned int x, y;
+  CBaseTexture *page = NULL;
+  if (g_advancedSettings.m_guiTextureAtlas && m_atlas.CanAdd(pTexture))
+    page = m_atlas.Add(pTexture, x, y);
+
+  if (page)
+  {
+    delete pTexture;
+    pMap->AddFromAtlas(&m_atlas, page, x, y);
+  }
+  else
+    pMap->Add(pTexture, 100);
   m_vecTextures.push_back(pMap);
 
 #ifdef _DEBUG_TEXTURES
@@ -514,6 +553,11 @@ void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
       ++i;
   }
 
+#if defined(HAS_GLES)
+  // queued GUI quads may still reference these textures
+  if (!m_unusedHwTextures.empty())
+    g_Windowing.FlushGUIQuads();
+#endif
 #if defined(HAS_GL) || defined(HAS_GLES)
   for (unsigned int i = 0; i < m_unusedHwTextures.size(); ++i)
   {
@@ -28,6 +28,7 @@
 #include <vector>
 #include <utility>
 
+#include "TextureAtlas.h"
 #include "TextureBundle.h"
 #include "threads/CriticalSection.h"
 
@@ -57,6 +58,8 @@ public:
   int m_loops;
   int m_texWidth;
   int m_texHeight;
+  int m_texOffsetX; ///< position of the image within its texture, non-zero for atlas pages
+  int m_texOffsetY;
   bool m_texCoordsArePixels;
 };
 
@@ -75,6 +78,8 @@ public:
   virtual ~CTextureMap();
 
   void Add(CBaseTexture* texture, int delay);
+  /*! \brief Use an image packed into an atlas page, the page is released through the atlas */
+  void AddFromAtlas(CTextureAtlas *atlas, CBaseTexture *page, int x, int y);
   bool Release();
 
   const std::string& GetName() const;
@@ -92,6 +97,7 @@ protected:
   std::string m_textureName;
   unsigned int m_referenceCount;
   uint32_t m_memUsage;
+  CTextureAtlas *m_atlas;
 };
 
 /*!
@@ -132,6 +138,7 @@ protected:
   typedef std::list<std::pair<CTextureMap*, unsigned int> >::iterator ilistUnused;
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
+  CTextureAtlas m_atlas;
 
   std::vector<std::string> m_texturePaths;
   CCriticalSection m_section;
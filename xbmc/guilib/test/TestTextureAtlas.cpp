@@ -0,0 +1,99 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/TextureAtlas.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+struct Placed
+{
+  unsigned int x, y, width, height;
+};
+
+bool Overlaps(const Placed &a, const Placed &b)
+{
+  return a.x < b.x + b.width && b.x < a.x + a.width &&
+         a.y < b.y + b.height && b.y < a.y + a.height;
+}
+}
+
+TEST(TestTextureAtlasPacker, FillsRowsFirst)
+{
+  CTextureAtlasPacker packer(64, 64);
+  unsigned int x, y;
+
+  EXPECT_TRUE(packer.Insert(32, 16, x, y));
+  EXPECT_EQ(0u, x);
+  EXPECT_EQ(0u, y);
+  EXPECT_TRUE(packer.Insert(32, 16, x, y));
+  EXPECT_EQ(32u, x);
+  EXPECT_EQ(0u, y);
+  EXPECT_TRUE(packer.Insert(64, 16, x, y));
+  EXPECT_EQ(0u, x);
+  EXPECT_EQ(16u, y);
+  EXPECT_EQ(64u * 32u, packer.GetUsedArea());
+}
+
+TEST(TestTextureAtlasPacker, RejectsWhatDoesNotFit)
+{
+  CTextureAtlasPacker packer(64, 64);
+  unsigned int x, y;
+
+  EXPECT_FALSE(packer.Insert(65, 1, x, y));
+  EXPECT_FALSE(packer.Insert(1, 65, x, y));
+  EXPECT_FALSE(packer.Insert(0, 10, x, y));
+  EXPECT_TRUE(packer.Insert(64, 64, x, y));
+  EXPECT_FALSE(packer.Insert(1, 1, x, y));
+}
+
+TEST(TestTextureAtlasPacker, NoOverlaps)
+{
+  const unsigned int size = 512;
+  CTextureAtlasPacker packer(size, size);
+  std::vector<Placed> placed;
+
+  // a deterministic mix of icon sized rectangles
+  unsigned int seed = 12345;
+  for (int i = 0; i < 2000; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    unsigned int width = 4 + (seed >> 16) % 60;
+    seed = seed * 1103515245 + 12345;
+    unsigned int height = 4 + (seed >> 16) % 60;
+
+    unsigned int x, y;
+    if (!packer.Insert(width, height, x, y))
+      continue;
+
+    Placed rect = { x, y, width, height };
+    EXPECT_LE(x + width, size);
+    EXPECT_LE(y + height, size);
+    for (const auto &other : placed)
+      ASSERT_FALSE(Overlaps(rect, other));
+    placed.push_back(rect);
+  }
+
+  // the page should be reasonably full once inserts start failing
+  EXPECT_GT(packer.GetUsedArea(), size * size * 7 / 10);
+}
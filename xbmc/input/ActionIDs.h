@@ -234,6 +234,7 @@
 #define ACTION_TOGGLE_DIGITAL_ANALOG  202 //!< switch digital <-> analog
 #define ACTION_RELOAD_KEYMAPS         203 //!< reloads CButtonTranslator's keymaps
 #define ACTION_GUIPROFILE_BEGIN       204 //!< start the GUIControlProfiler running
+#define ACTION_TRACEPROFILE_BEGIN     205 //!< start recording a trace of the render loop
 
 #define ACTION_TELETEXT_RED           215 //!< Teletext Color button <b>Red</b> to control TopText
 #define ACTION_TELETEXT_GREEN         216 //!< Teletext Color button <b>Green</b> to control TopText
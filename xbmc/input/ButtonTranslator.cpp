@@ -208,6 +208,7 @@ static const ActionMapping actions[] =
     { "firstpage"                , ACTION_FIRST_PAGE },
     { "lastpage"                 , ACTION_LAST_PAGE },
     { "guiprofile"               , ACTION_GUIPROFILE_BEGIN },
+    { "traceprofile"             , ACTION_TRACEPROFILE_BEGIN },
     { "red"                      , ACTION_TELETEXT_RED },
     { "green"                    , ACTION_TELETEXT_GREEN },
     { "yellow"                   , ACTION_TELETEXT_YELLOW },
@@ -73,11 +73,19 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+
+  /*! \brief Whether the value may change without the info manager being notified.
+   Volatile info bools are set dirty every frame, the others only depend on skin settings
+   or constants and keep their value until the info manager cache is reset.
+   \sa CGUIInfoManager::ResetFrameCache, CGUIInfoManager::ResetCache
+   */
+  bool IsVolatile() const { return m_volatile; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
+  bool m_volatile;             ///< needs to be re-evaluated every frame
 
 private:
   std::string  m_expression;   ///< original expression
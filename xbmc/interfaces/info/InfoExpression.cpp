@@ -19,6 +19,7 @@
  */
 
 #include "InfoExpression.h"
+#include <algorithm>
 #include <stack>
 #include "utils/log.h"
 #include "GUIInfoManager.h"
@@ -31,6 +32,7 @@ InfoSingle::InfoSingle(const std::string &expression, int context)
 : InfoBool(expression, context)
 {
   m_condition = g_infoManager.TranslateSingleString(expression, m_listItemDependent);
+  m_volatile = g_infoManager.IsVolatileCondition(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -41,16 +43,18 @@ void InfoSingle::Update(const CGUIListItem *item)
 InfoExpression::InfoExpression(const std::string &expression, int context)
 : InfoBool(expression, context)
 {
+  // the expression is only volatile if one of its conditions is
+  m_volatile = false;
   if (!Parse(expression))
   {
     CLog::Log(LOGERROR, "Error parsing boolean expression %s", expression.c_str());
-    m_expression_tree = std::make_shared<InfoLeaf>(g_infoManager.Register("false", 0), false);
+    Compile(std::make_shared<InfoLeaf>(g_infoManager.Register("false", 0), false));
   }
 }
 
 void InfoExpression::Update(const CGUIListItem *item)
 {
-  m_value = m_expression_tree->Evaluate(item);
+  m_value = Evaluate(0, item);
 }
 
 /* Expressions are rewritten at parse time into a form which favours the
@@ -69,11 +73,62 @@ void InfoExpression::Update(const CGUIListItem *item)
  * 2) Combining adjacent AND or OR operations such that each path from the root
  *    to a leaf encounters a strictly alternating pattern of AND and OR
  *    operations. So [A|B]|[C|D+[[E|F]|G] becomes A|B|C|[D+[E|F|G]].
+ *
+ * The resulting tree is then compiled into flat arrays of nodes and child
+ * indices, which are evaluated without virtual calls or reference counting.
  */
 
-bool InfoExpression::InfoLeaf::Evaluate(const CGUIListItem *item)
+unsigned int InfoExpression::Compile(const InfoSubexpressionPtr &expression)
+{
+  unsigned int index = m_nodes.size();
+  m_nodes.push_back(InfoNode());
+
+  if (expression->Type() == NODE_LEAF)
+  {
+    const InfoLeaf &leaf = static_cast<const InfoLeaf&>(*expression);
+    m_leaves.push_back(leaf.GetInfo());
+    m_volatile |= leaf.GetInfo()->IsVolatile();
+    m_nodes[index] = { NODE_LEAF, leaf.Inverted(), leaf.GetInfo().get(), 0, 0 };
+  }
+  else
+  {
+    const std::list<InfoSubexpressionPtr> &children = static_cast<const InfoAssociativeGroup&>(*expression).GetChildren();
+    unsigned int first = m_children.size();
+    m_children.resize(first + children.size());
+    unsigned int i = first;
+    for (const auto &child : children)
+    {
+      unsigned int node = Compile(child);
+      m_children[i++] = node;
+    }
+    m_nodes[index] = { expression->Type(), false, nullptr, first, static_cast<unsigned int>(children.size()) };
+  }
+  return index;
+}
+
+bool InfoExpression::Evaluate(unsigned int index, const CGUIListItem *item)
 {
-  return m_invert ^ m_info->Get(item);
+  const InfoNode &node = m_nodes[index];
+  if (node.type == NODE_LEAF)
+    return node.invert ^ node.info->Get(item);
+
+  /* Handle either AND or OR by using the relation
+   * A AND B == !(!A OR !B)
+   * to convert ANDs into ORs
+   */
+  bool use_and = (node.type == NODE_AND);
+  unsigned int *first = &m_children[node.first];
+  unsigned int *last = first + node.count;
+  for (unsigned int *it = first; it != last; ++it)
+  {
+    if (use_and ^ Evaluate(*it, item))
+    {
+      /* Move this child to the head of the group so we evaluate faster next time */
+      std::rotate(first, it, it + 1);
+      return !use_and;
+    }
+  }
+  return use_and;
 }
 
 InfoExpression::InfoAssociativeGroup::InfoAssociativeGroup(
@@ -96,29 +151,6 @@ void InfoExpression::InfoAssociativeGroup::Merge(std::shared_ptr<InfoAssociative
   m_children.splice(m_children.end(), other->m_children);
 }
 
-bool InfoExpression::InfoAssociativeGroup::Evaluate(const CGUIListItem *item)
-{
-  /* Handle either AND or OR by using the relation
-   * A AND B == !(!A OR !B)
-   * to convert ANDs into ORs
-   */
-  std::list<InfoSubexpressionPtr>::iterator last = m_children.end();
-  std::list<InfoSubexpressionPtr>::iterator it = m_children.begin();
-  bool use_and = (m_type == NODE_AND);
-  bool result = use_and ^ (*it)->Evaluate(item);
-  while (!result && ++it != last)
-  {
-    result = use_and ^ (*it)->Evaluate(item);
-    if (result)
-    {
-      /* Move this child to the head of the list so we evaluate faster next time */
-      m_children.push_front(*it);
-      m_children.erase(it);
-    }
-  }
-  return use_and ^ result;
-}
-
 /* Expressions are parsed using the shunting-yard algorithm. Binary operators
  * (AND/OR) are treated as right-associative so that we don't need to make a
  * special case for the unary NOT operator. This has no effect upon the answers
@@ -306,6 +338,6 @@ bool InfoExpression::Parse(const std::string &expression)
   while (!operator_stack.empty())
     OperatorPop(operator_stack, invert, nodes);
 
-  m_expression_tree = nodes.top();
+  Compile(nodes.top());
   return true;
 }
@@ -69,12 +69,11 @@ private:
     NODE_OR,
   } node_type_t;
 
-  // An abstract base class for nodes in the expression tree
+  // An abstract base class for nodes in the expression tree built by the parser
   class InfoSubexpression
   {
   public:
     virtual ~InfoSubexpression(void) {}; // so we can destruct derived classes using a pointer to their base class
-    virtual bool Evaluate(const CGUIListItem *item) = 0;
     virtual node_type_t Type() const=0;
   };
 
@@ -85,8 +84,9 @@ private:
   {
   public:
     InfoLeaf(InfoPtr info, bool invert) : m_info(info), m_invert(invert) {};
-    virtual bool Evaluate(const CGUIListItem *item);
     virtual node_type_t Type() const { return NODE_LEAF; };
+    const InfoPtr &GetInfo() const { return m_info; };
+    bool Inverted() const { return m_invert; };
   private:
     InfoPtr m_info;
     bool m_invert;
@@ -99,17 +99,32 @@ private:
     InfoAssociativeGroup(node_type_t type, const InfoSubexpressionPtr &left, const InfoSubexpressionPtr &right);
     void AddChild(const InfoSubexpressionPtr &child);
     void Merge(std::shared_ptr<InfoAssociativeGroup> other);
-    virtual bool Evaluate(const CGUIListItem *item);
     virtual node_type_t Type() const { return m_type; };
+    const std::list<InfoSubexpressionPtr> &GetChildren() const { return m_children; };
   private:
     node_type_t m_type;
     std::list<InfoSubexpressionPtr> m_children;
   };
 
+  // A node of the compiled expression, children of a group are a range of m_children
+  struct InfoNode
+  {
+    node_type_t type;
+    bool invert;          ///< leaves: invert the value of info
+    InfoBool *info;       ///< leaves: the condition, owned by m_leaves
+    unsigned int first;   ///< groups: index of the first child in m_children
+    unsigned int count;   ///< groups: number of children
+  };
+
   static operator_t GetOperator(char ch);
   static void OperatorPop(std::stack<operator_t> &operator_stack, bool &invert, std::stack<InfoSubexpressionPtr> &nodes);
   bool Parse(const std::string &expression);
-  InfoSubexpressionPtr m_expression_tree;
+  unsigned int Compile(const InfoSubexpressionPtr &expression);
+  bool Evaluate(unsigned int node, const CGUIListItem *item);
+
+  std::vector<InfoNode> m_nodes;        ///< compiled expression, the root is the first node
+  std::vector<unsigned int> m_children; ///< children of the group nodes
+  std::vector<InfoPtr> m_leaves;        ///< conditions referenced by the leaves
 };
 
 };
@@ -250,6 +250,48 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
   delete thumbLoader;
 }
 
+CFileItemHandler::CQueryHandler::CQueryHandler(const char *ID, bool allowFile, const char *resultname, const CVariant &parameterObject, CVariant &result)
+  : m_ID(ID),
+    m_allowFile(allowFile),
+    m_resultname(resultname),
+    m_parameterObject(parameterObject),
+    m_result(result),
+    m_size(0),
+    m_success(false),
+    m_done(std::make_shared<CEvent>())
+{ }
+
+bool CFileItemHandler::CQueryHandler::OnQueryItems(unsigned int queryId, CFileItemList &items)
+{
+  m_size += items.Size();
+  // the last batch carries the number of items without the limits
+  if (items.HasProperty("total") && items.GetProperty("total").asInteger() > m_size)
+    m_size = (int)items.GetProperty("total").asInteger();
+
+  HandleFileItemList(m_ID, m_allowFile, m_resultname, items, m_parameterObject, m_result, false);
+  return true;
+}
+
+void CFileItemHandler::CQueryHandler::OnQueryDone(unsigned int queryId, bool success)
+{
+  int start, end;
+  HandleLimits(m_parameterObject, m_result, m_size, start, end);
+  m_success = success;
+
+  std::shared_ptr<CEvent> done(m_done);
+  done->Set();
+}
+
+bool CFileItemHandler::CQueryHandler::Wait()
+{
+  m_done->Wait();
+
+  // a partial result would be passed on as the data of the error
+  if (!m_success)
+    m_result = CVariant();
+  return m_success;
+}
+
 void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const CVariant &validFields, CVariant &result, bool append /* = true */, CThumbLoader *thumbLoader /* = NULL */)
 {
   std::set<std::string> fields;
@@ -379,9 +421,9 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
   if (resultname)
   {
     if (append)
-      result[resultname].append(object);
+      result[resultname].append(std::move(object));
     else
-      result[resultname] = object;
+      result[resultname] = std::move(object);
   }
 }
 
@@ -19,11 +19,14 @@
  *
  */
 
+#include <memory>
 #include <set>
 
 #include "JSONRPC.h"
 #include "JSONUtils.h"
 #include "FileItem.h"
+#include "dbwrappers/DatabaseQueryQueue.h"
+#include "threads/Event.h"
 
 class CThumbLoader;
 class CVariant;
@@ -39,8 +42,44 @@ namespace JSONRPC
     static void HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const CVariant &validFields, CVariant &result, bool append = true, CThumbLoader *thumbLoader = NULL);
     static void HandleFileItem(const char *ID, bool allowFile, const char *resultname, CFileItemPtr item, const CVariant &parameterObject, const std::set<std::string> &validFields, CVariant &result, bool append = true, CThumbLoader *thumbLoader = NULL);
 
+    /*!
+     \brief Run a library query through CDatabaseQueryQueue and add its items to
+            the result batch by batch, so that they are never all held at once.
+            Only for queries that sort and limit the items themselves.
+     \return False if the query failed
+     */
+    template<class TDatabase>
+    static bool HandleFileItemQuery(const char *ID, bool allowFile, const char *resultname, const typename CDatabaseQueryJobT<TDatabase>::Query &query, const CVariant &parameterObject, CVariant &result)
+    {
+      CQueryHandler handler(ID, allowFile, resultname, parameterObject, result);
+      CDatabaseQueryQueue::GetInstance().AddQuery<TDatabase>(query, &handler);
+      return handler.Wait();
+    }
+
     static bool FillFileItemList(const CVariant &parameterObject, CFileItemList &list);
   private:
+    class CQueryHandler : public IDatabaseQueryCallback
+    {
+    public:
+      CQueryHandler(const char *ID, bool allowFile, const char *resultname, const CVariant &parameterObject, CVariant &result);
+
+      bool OnQueryItems(unsigned int queryId, CFileItemList &items) override;
+      void OnQueryDone(unsigned int queryId, bool success) override;
+
+      bool Wait();
+
+    private:
+      const char *m_ID;
+      bool m_allowFile;
+      const char *m_resultname;
+      const CVariant &m_parameterObject;
+      CVariant &m_result;
+      int m_size;
+      bool m_success;
+      // shared with OnQueryDone() as the handler may be gone before Set() has returned
+      std::shared_ptr<CEvent> m_done;
+    };
+
     static void Sort(CFileItemList &items, const CVariant& parameterObject);
     static bool GetField(const std::string &field, const CVariant &info, const CFileItemPtr &item, CVariant &result, bool &fetchedArt, CThumbLoader *thumbLoader = NULL);
   };
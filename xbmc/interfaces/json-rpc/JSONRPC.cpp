@@ -19,6 +19,7 @@
  */
 
 #include <string.h>
+#include <vector>
 
 #include "JSONRPC.h"
 #include "ServiceDescription.h"
@@ -235,48 +236,89 @@ JSONRPC_STATUS CJSONRPC::NotifyAll(const std::string &method, ITransportLayer *t
 
 std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client)
 {
-  CVariant inputroot, outputroot, result;
-  bool hasResponse = false;
+  std::string str;
+  bool success = MethodCall(inputString, transport, client, [&str](const char *data, size_t length)
+  {
+    str.append(data, length);
+    return true;
+  });
+
+  if (!success)
+    str.clear();
+
+  return str;
+}
+
+bool CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client, const CJSONVariantWriter::StreamCallback &output)
+{
+  bool batch = false;
+  std::vector<CVariant> responses;
+  if (!HandleCall(inputString, transport, client, responses, batch))
+    return false;
+
+  bool compact = g_advancedSettings.m_jsonOutputCompact;
+  if (!batch)
+    return CJSONVariantWriter::Write(responses.front(), output, compact);
+
+  for (std::vector<CVariant>::const_iterator response = responses.begin(); response != responses.end(); ++response)
+  {
+    if (!output(response == responses.begin() ? "[" : ",", 1) ||
+        !CJSONVariantWriter::Write(*response, output, compact))
+      return false;
+  }
+
+  return output("]", 1);
+}
+
+bool CJSONRPC::HandleCall(const std::string &inputString, ITransportLayer *transport, IClient *client, std::vector<CVariant> &responses, bool &batch)
+{
+  CVariant inputroot;
+  responses.clear();
+  batch = false;
 
   if(g_advancedSettings.CanLogComponent(LOGJSONRPC))
     CLog::Log(LOGDEBUG, "JSONRPC: Incoming request: %s", inputString.c_str());
 
   inputroot = CJSONVariantParser::Parse((unsigned char *)inputString.c_str(), inputString.length());
-  if (!inputroot.isNull())
-  {
-    if (inputroot.isArray())
-    {
-      if (inputroot.size() <= 0)
-      {
-        CLog::Log(LOGERROR, "JSONRPC: Empty batch call\n");
-        BuildResponse(inputroot, InvalidRequest, CVariant(), outputroot);
-        hasResponse = true;
-      }
-      else
-      {
-        for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array(); itr++)
-        {
-          CVariant response;
-          if (HandleMethodCall(*itr, response, transport, client))
-          {
-            outputroot.append(response);
-            hasResponse = true;
-          }
-        }
-      }
-    }
-    else
-      hasResponse = HandleMethodCall(inputroot, outputroot, transport, client);
-  }
-  else
+  if (inputroot.isNull())
   {
     CLog::Log(LOGERROR, "JSONRPC: Failed to parse '%s'\n", inputString.c_str());
+    CVariant outputroot;
     BuildResponse(inputroot, ParseError, CVariant(), outputroot);
-    hasResponse = true;
+    responses.push_back(std::move(outputroot));
+    return true;
   }
 
-  std::string str = hasResponse ? CJSONVariantWriter::Write(outputroot, g_advancedSettings.m_jsonOutputCompact) : "";
-  return str;
+  if (!inputroot.isArray())
+  {
+    CVariant outputroot;
+    if (!HandleMethodCall(inputroot, outputroot, transport, client))
+      return false;
+
+    responses.push_back(std::move(outputroot));
+    return true;
+  }
+
+  if (inputroot.size() <= 0)
+  {
+    CLog::Log(LOGERROR, "JSONRPC: Empty batch call\n");
+    CVariant outputroot;
+    BuildResponse(inputroot, InvalidRequest, CVariant(), outputroot);
+    responses.push_back(std::move(outputroot));
+    return true;
+  }
+
+  // all calls of a batch are handled before anything is written so that the
+  // output is never interleaved with the execution of a method
+  for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array(); itr++)
+  {
+    CVariant response;
+    if (HandleMethodCall(*itr, response, transport, client))
+      responses.push_back(std::move(response));
+  }
+
+  batch = true;
+  return !responses.empty();
 }
 
 bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
@@ -306,7 +348,7 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     errorCode = InvalidRequest;
   }
 
-  BuildResponse(request, errorCode, result, response);
+  BuildResponse(request, errorCode, std::move(result), response);
 
   return !isNotification;
 }
@@ -316,7 +358,7 @@ inline bool CJSONRPC::IsProperJSONRPC(const CVariant& inputroot)
   return inputroot.isMember("jsonrpc") && inputroot["jsonrpc"].isString() && inputroot["jsonrpc"] == CVariant("2.0") && inputroot.isMember("method") && inputroot["method"].isString() && (!inputroot.isMember("params") || inputroot["params"].isArray() || inputroot["params"].isObject());
 }
 
-inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response)
+inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant&& result, CVariant& response)
 {
   response["jsonrpc"] = "2.0";
   response["id"] = request.isMember("id") ? request["id"] : CVariant();
@@ -324,7 +366,7 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
   switch (code)
   {
     case OK:
-      response["result"] = result;
+      response["result"] = std::move(result);
       break;
     case ACK:
       response["result"] = "OK";
@@ -337,7 +379,7 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
       response["error"]["code"] = InvalidParams;
       response["error"]["message"] = "Invalid params.";
       if (!result.isNull())
-        response["error"]["data"] = result;
+        response["error"]["data"] = std::move(result);
       break;
     case MethodNotFound:
       response["error"]["code"] = MethodNotFound;
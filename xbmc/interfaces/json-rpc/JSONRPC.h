@@ -23,9 +23,11 @@
 #include <map>
 #include <stdio.h>
 #include <string>
+#include <vector>
 
 #include "JSONRPCUtils.h"
 #include "JSONServiceDescription.h"
+#include "utils/JSONVariantWriter.h"
 
 class CVariant;
 
@@ -64,6 +66,34 @@ namespace JSONRPC
      */
     static std::string MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client);
 
+    /*
+     \brief Handles an incoming JSON-RPC request and streams the response
+     \param inputString received JSON-RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \param output Callback receiving the JSON-RPC response in chunks
+     \return True if a response was written, false if there was none or writing it failed
+
+     Works like MethodCall() above but serializes the response in chunks
+     instead of building the whole output in memory first. The callback is
+     only invoked once all requested methods have been executed.
+     */
+    static bool MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client, const CJSONVariantWriter::StreamCallback &output);
+
+    /*
+     \brief Handles an incoming JSON-RPC request without serializing the response
+     \param inputString received JSON-RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \param responses Receives the JSON-RPC responses
+     \param batch Set to true if the responses have to be sent as an array
+     \return True if there is a response to send, false otherwise
+
+     Lets transports that send the response while it is serialized, like the
+     webserver, take care of writing the responses themselves.
+     */
+    static bool HandleCall(const std::string &inputString, ITransportLayer *transport, IClient *client, std::vector<CVariant> &responses, bool &batch);
+
     static JSONRPC_STATUS Introspect(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Version(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Permission(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -77,7 +107,7 @@ namespace JSONRPC
     static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
-    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
+    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant&& result, CVariant& response);
 
     static bool m_initialized;
   };
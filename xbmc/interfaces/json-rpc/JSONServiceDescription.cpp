@@ -266,6 +266,7 @@ JSONSchemaTypeDefinition::JSONSchemaTypeDefinition()
     minLength(-1),
     maxLength(-1),
     enums(),
+    stringEnums(),
     items(),
     minItems(0),
     maxItems(0),
@@ -599,7 +600,11 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
       // Only add the current item to the enum value 
       // list if it is not duplicate
       if (approved)
+      {
         enums.push_back(*enumItr);
+        if (enumItr->isString())
+          stringEnums.insert(enumItr->asString());
+      }
     }
   }
 
@@ -651,9 +656,21 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
 
 JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &outputValue, CVariant &errorData)
 {
-  if (!name.empty())
-    errorData["name"] = name;
-  SchemaValueTypeToJson(type, errorData["type"]);
+  JSONRPC_STATUS status = CheckValue(value, outputValue, errorData);
+
+  // only describe the type in the error data if the value didn't match
+  if (status != OK)
+  {
+    if (!name.empty())
+      errorData["name"] = name;
+    SchemaValueTypeToJson(type, errorData["type"]);
+  }
+
+  return status;
+}
+
+JSONRPC_STATUS JSONSchemaTypeDefinition::CheckValue(const CVariant &value, CVariant &outputValue, CVariant &errorData)
+{
   std::string errorMessage;
 
   if (referencedType != NULL && !referencedTypeSet)
@@ -743,11 +760,12 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
       // Loop through all array elements
       for (unsigned int arrayIndex = 0; arrayIndex < value.size(); arrayIndex++)
       {
-        CVariant temp;
-        JSONRPC_STATUS status = itemType->Check(value[arrayIndex], temp, errorData["property"]);
+        CVariant temp, propertyError;
+        JSONRPC_STATUS status = itemType->Check(value[arrayIndex], temp, propertyError);
         outputValue.push_back(temp);
         if (status != OK)
         {
+          errorData["property"] = std::move(propertyError);
           CLog::Log(LOGDEBUG, "JSONRPC: Array element at index %u does not match in type %s", arrayIndex, name.c_str());
           errorMessage = StringUtils::Format("array element at index %u does not match", arrayIndex);
           errorData["message"] = errorMessage.c_str();
@@ -780,9 +798,11 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
       unsigned int arrayIndex;
       for (arrayIndex = 0; arrayIndex < std::min(items.size(), (size_t)value.size()); arrayIndex++)
       {
-        JSONRPC_STATUS status = items.at(arrayIndex)->Check(value[arrayIndex], outputValue[arrayIndex], errorData["property"]);
+        CVariant propertyError;
+        JSONRPC_STATUS status = items.at(arrayIndex)->Check(value[arrayIndex], outputValue[arrayIndex], propertyError);
         if (status != OK)
         {
+          errorData["property"] = std::move(propertyError);
           CLog::Log(LOGDEBUG, "JSONRPC: Array element at index %u does not match with items schema in type %s", arrayIndex, name.c_str());
           return status;
         }
@@ -850,9 +870,11 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
     {
       if (value.isMember(propertiesIterator->second->name))
       {
-        JSONRPC_STATUS status = propertiesIterator->second->Check(value[propertiesIterator->second->name], outputValue[propertiesIterator->second->name], errorData["property"]);
+        CVariant propertyError;
+        JSONRPC_STATUS status = propertiesIterator->second->Check(value[propertiesIterator->second->name], outputValue[propertiesIterator->second->name], propertyError);
         if (status != OK)
         {
+          errorData["property"] = std::move(propertyError);
           CLog::Log(LOGDEBUG, "JSONRPC: Invalid property \"%s\" in type %s", propertiesIterator->second->name.c_str(), name.c_str());
           return status;
         }
@@ -892,9 +914,11 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
             continue;
           }
 
-          JSONRPC_STATUS status = additionalProperties->Check(value[iter->first], outputValue[iter->first], errorData["property"]);
+          CVariant propertyError;
+          JSONRPC_STATUS status = additionalProperties->Check(value[iter->first], outputValue[iter->first], propertyError);
           if (status != OK)
           {
+            errorData["property"] = std::move(propertyError);
             CLog::Log(LOGDEBUG, "JSONRPC: Invalid additional property \"%s\" in type %s", iter->first.c_str(), name.c_str());
             return status;
           }
@@ -920,12 +944,17 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
   if (enums.size() > 0)
   {
     bool valid = false;
-    for (std::vector<CVariant>::const_iterator enumItr = enums.begin(); enumItr != enums.end(); ++enumItr)
+    if (value.isString())
+      valid = stringEnums.find(value.asString()) != stringEnums.end();
+    else
     {
-      if (*enumItr == value)
+      for (std::vector<CVariant>::const_iterator enumItr = enums.begin(); enumItr != enums.end(); ++enumItr)
       {
-        valid = true;
-        break;
+        if (*enumItr == value)
+        {
+          valid = true;
+          break;
+        }
       }
     }
 
@@ -1379,13 +1408,17 @@ JSONRPC_STATUS JsonRpcMethod::checkParameter(const CVariant &requestParameters,
   // Let's check if the parameter has been provided
   if (ParameterExists(requestParameters, type->name, position))
   {
-    // Get the parameter
-    CVariant parameterValue = GetParameter(requestParameters, type->name, position);
+    // Get the parameter (without copying it)
+    const CVariant &parameterValue = IsValueMember(requestParameters, type->name) ? requestParameters[type->name] : requestParameters[position];
 
     // Evaluate the type of the parameter
-    JSONRPC_STATUS status = type->Check(parameterValue, outputParameters[type->name], errorData["stack"]);
+    CVariant parameterError;
+    JSONRPC_STATUS status = type->Check(parameterValue, outputParameters[type->name], parameterError);
     if (status != OK)
+    {
+      errorData["stack"] = std::move(parameterError);
       return status;
+    }
 
     // The parameter was present and valid
     handled++;
@@ -1650,6 +1683,11 @@ bool CJSONServiceDescription::AddEnum(const std::string &name, const std::vector
       return false;
   }
   definition->enums.insert(definition->enums.begin(), values.begin(), values.end());
+  for (std::vector<CVariant>::const_iterator value = values.begin(); value != values.end(); ++value)
+  {
+    if (value->isString())
+      definition->stringEnums.insert(value->asString());
+  }
 
   int schemaType = (int)AnyValue;
   for (unsigned int index = 0; index < types.size(); index++)
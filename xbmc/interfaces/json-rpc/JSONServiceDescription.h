@@ -20,6 +20,7 @@
  */
 
 #include <string>
+#include <unordered_set>
 #include <vector>
 #include <limits>
 #include <memory>
@@ -158,6 +159,12 @@ namespace JSONRPC
      */
     std::vector<CVariant> enums;
 
+    /*!
+     \brief String values of enums to quickly
+     check a string value against them
+     */
+    std::unordered_set<std::string> stringEnums;
+
     /*!
      \brief List of possible values in an array
      */
@@ -222,6 +229,9 @@ namespace JSONRPC
      \brief Type definition for additional properties
      */
     JSONSchemaTypeDefinitionPtr additionalProperties;
+
+  private:
+    JSONRPC_STATUS CheckValue(const CVariant &value, CVariant &outputValue, CVariant &errorData);
   };
 
   /*! 
@@ -125,10 +125,10 @@ JSONRPC_STATUS CPlayerOperations::GetProperties(const std::string &method, ITran
     if ((ret = GetPropertyValue(player, propertyName, property)) != OK)
       return ret;
 
-    properties[propertyName] = property;
+    properties[propertyName] = std::move(property);
   }
 
-  result = properties;
+  result = std::move(properties);
 
   return OK;
 }
@@ -34,10 +34,6 @@ using namespace KODI::MESSAGING;
 
 JSONRPC_STATUS CVideoLibrary::GetMovies(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
-  CVideoDatabase videodatabase;
-  if (!videodatabase.Open())
-    return InternalError;
-
   SortDescription sorting;
   ParseLimits(parameterObject, sorting.limitStart, sorting.limitEnd);
   if (!ParseSorting(parameterObject, sorting.sortBy, sorting.sortOrder, sorting.sortAttributes))
@@ -82,11 +78,14 @@ JSONRPC_STATUS CVideoLibrary::GetMovies(const std::string &method, ITransportLay
   if (setID < 0)
     setID = 0;
 
-  CFileItemList items;
-  if (!videodatabase.GetMoviesNav(videoUrl.ToString(), items, genreID, year, -1, -1, -1, -1, setID, -1, sorting, RequiresAdditionalDetails(MediaTypeMovie, parameterObject)))
+  std::string strUrl = videoUrl.ToString();
+  int details = RequiresAdditionalDetails(MediaTypeMovie, parameterObject);
+  if (!HandleFileItemQuery<CVideoDatabase>("movieid", true, "movies",
+      [&](CVideoDatabase &db, CFileItemList &items) { return db.GetMoviesNav(strUrl, items, genreID, year, -1, -1, -1, -1, setID, -1, sorting, details); },
+      parameterObject, result))
     return InvalidParams;
 
-  return HandleItems("movieid", "movies", items, parameterObject, result, false);
+  return OK;
 }
 
 JSONRPC_STATUS CVideoLibrary::GetMovieDetails(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
@@ -144,10 +143,6 @@ JSONRPC_STATUS CVideoLibrary::GetMovieSetDetails(const std::string &method, ITra
 
 JSONRPC_STATUS CVideoLibrary::GetTVShows(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
-  CVideoDatabase videodatabase;
-  if (!videodatabase.Open())
-    return InternalError;
-
   SortDescription sorting;
   ParseLimits(parameterObject, sorting.limitStart, sorting.limitEnd);
   if (!ParseSorting(parameterObject, sorting.sortBy, sorting.sortOrder, sorting.sortAttributes))
@@ -179,12 +174,14 @@ JSONRPC_STATUS CVideoLibrary::GetTVShows(const std::string &method, ITransportLa
     videoUrl.AddOption("xsp", xsp);
   }
 
-  CFileItemList items;
-  CDatabase::Filter nofilter;
-  if (!videodatabase.GetTvShowsByWhere(videoUrl.ToString(), nofilter, items, sorting, RequiresAdditionalDetails(MediaTypeTvShow, parameterObject)))
+  std::string strUrl = videoUrl.ToString();
+  int details = RequiresAdditionalDetails(MediaTypeTvShow, parameterObject);
+  if (!HandleFileItemQuery<CVideoDatabase>("tvshowid", true, "tvshows",
+      [&](CVideoDatabase &db, CFileItemList &items) { return db.GetTvShowsByWhere(strUrl, CDatabase::Filter(), items, sorting, details); },
+      parameterObject, result))
     return InvalidParams;
 
-  return HandleItems("tvshowid", "tvshows", items, parameterObject, result, false);
+  return OK;
 }
 
 JSONRPC_STATUS CVideoLibrary::GetTVShowDetails(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
@@ -242,10 +239,6 @@ JSONRPC_STATUS CVideoLibrary::GetSeasonDetails(const std::string &method, ITrans
 
 JSONRPC_STATUS CVideoLibrary::GetEpisodes(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
-  CVideoDatabase videodatabase;
-  if (!videodatabase.Open())
-    return InternalError;
-
   SortDescription sorting;
   ParseLimits(parameterObject, sorting.limitStart, sorting.limitEnd);
   if (!ParseSorting(parameterObject, sorting.sortBy, sorting.sortOrder, sorting.sortAttributes))
@@ -290,11 +283,14 @@ JSONRPC_STATUS CVideoLibrary::GetEpisodes(const std::string &method, ITransportL
       videoUrl.AddOption("season", season);
   }
 
-  CFileItemList items;
-  if (!videodatabase.GetEpisodesByWhere(videoUrl.ToString(), CDatabase::Filter(), items, false, sorting, RequiresAdditionalDetails(MediaTypeEpisode, parameterObject)))
+  std::string strUrl = videoUrl.ToString();
+  int details = RequiresAdditionalDetails(MediaTypeEpisode, parameterObject);
+  if (!HandleFileItemQuery<CVideoDatabase>("episodeid", true, "episodes",
+      [&](CVideoDatabase &db, CFileItemList &items) { return db.GetEpisodesByWhere(strUrl, CDatabase::Filter(), items, false, sorting, details); },
+      parameterObject, result))
     return InvalidParams;
 
-  return HandleItems("episodeid", "episodes", items, parameterObject, result, false);
+  return OK;
 }
 
 JSONRPC_STATUS CVideoLibrary::GetEpisodeDetails(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
@@ -324,10 +320,6 @@ JSONRPC_STATUS CVideoLibrary::GetEpisodeDetails(const std::string &method, ITran
 
 JSONRPC_STATUS CVideoLibrary::GetMusicVideos(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
-  CVideoDatabase videodatabase;
-  if (!videodatabase.Open())
-    return InternalError;
-
   SortDescription sorting;
   ParseLimits(parameterObject, sorting.limitStart, sorting.limitEnd);
   if (!ParseSorting(parameterObject, sorting.sortBy, sorting.sortOrder, sorting.sortAttributes))
@@ -362,11 +354,14 @@ JSONRPC_STATUS CVideoLibrary::GetMusicVideos(const std::string &method, ITranspo
     videoUrl.AddOption("xsp", xsp);
   }
 
-  CFileItemList items;
-  if (!videodatabase.GetMusicVideosNav(videoUrl.ToString(), items, genreID, year, -1, -1, -1, -1, -1, sorting, RequiresAdditionalDetails(MediaTypeMusicVideo, parameterObject)))
+  std::string strUrl = videoUrl.ToString();
+  int details = RequiresAdditionalDetails(MediaTypeMusicVideo, parameterObject);
+  if (!HandleFileItemQuery<CVideoDatabase>("musicvideoid", true, "musicvideos",
+      [&](CVideoDatabase &db, CFileItemList &items) { return db.GetMusicVideosNav(strUrl, items, genreID, year, -1, -1, -1, -1, -1, sorting, details); },
+      parameterObject, result))
     return InternalError;
 
-  return HandleItems("musicvideoid", "musicvideos", items, parameterObject, result, false);
+  return OK;
 }
 
 JSONRPC_STATUS CVideoLibrary::GetMusicVideoDetails(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
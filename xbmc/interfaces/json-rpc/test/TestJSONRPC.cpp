@@ -0,0 +1,107 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "interfaces/json-rpc/JSONRPC.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/Variant.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace JSONRPC;
+
+TEST(TestJSONRPC, StreamBatchCall)
+{
+  // an invalid request and a call of an unknown method
+  const std::string request = "[{\"foo\":1},{\"jsonrpc\":\"2.0\",\"method\":\"Test.Unknown\",\"id\":2}]";
+
+  std::vector<std::string> chunks;
+  EXPECT_TRUE(CJSONRPC::MethodCall(request, nullptr, nullptr, [&chunks](const char *data, size_t length)
+  {
+    chunks.push_back(std::string(data, length));
+    return true;
+  }));
+
+  // each response is written on its own, framed by separate chunks
+  ASSERT_GE(chunks.size(), 5U);
+  EXPECT_EQ("[", chunks.front());
+  EXPECT_EQ("]", chunks.back());
+  unsigned int separators = 0;
+  for (std::vector<std::string>::const_iterator chunk = chunks.begin(); chunk != chunks.end(); ++chunk)
+  {
+    if (*chunk == ",")
+      separators++;
+  }
+  EXPECT_EQ(1U, separators);
+
+  std::string streamed;
+  for (std::vector<std::string>::const_iterator chunk = chunks.begin(); chunk != chunks.end(); ++chunk)
+    streamed += *chunk;
+  EXPECT_EQ(CJSONRPC::MethodCall(request, nullptr, nullptr), streamed);
+
+  CVariant responses = CJSONVariantParser::Parse(streamed);
+  ASSERT_TRUE(responses.isArray());
+  ASSERT_EQ(2U, responses.size());
+  EXPECT_EQ(-32600, responses[0]["error"]["code"].asInteger());
+  EXPECT_TRUE(responses[0]["id"].isNull());
+  EXPECT_EQ(-32601, responses[1]["error"]["code"].asInteger());
+  EXPECT_EQ(2, responses[1]["id"].asInteger());
+}
+
+TEST(TestJSONRPC, StreamBatchCallAbort)
+{
+  const std::string request = "[{\"foo\":1},{\"bar\":2}]";
+
+  unsigned int calls = 0;
+  EXPECT_FALSE(CJSONRPC::MethodCall(request, nullptr, nullptr, [&calls](const char *data, size_t length)
+  {
+    calls++;
+    return false;
+  }));
+  EXPECT_EQ(1U, calls);
+}
+
+TEST(TestJSONRPC, HandleCall)
+{
+  std::vector<CVariant> responses;
+  bool batch = true;
+
+  // a single call is answered with a single response
+  EXPECT_TRUE(CJSONRPC::HandleCall("{\"foo\":1}", nullptr, nullptr, responses, batch));
+  EXPECT_FALSE(batch);
+  ASSERT_EQ(1U, responses.size());
+  EXPECT_EQ(-32600, responses[0]["error"]["code"].asInteger());
+
+  // so is a request which can't be parsed
+  EXPECT_TRUE(CJSONRPC::HandleCall("{", nullptr, nullptr, responses, batch));
+  EXPECT_FALSE(batch);
+  ASSERT_EQ(1U, responses.size());
+  EXPECT_EQ(-32700, responses[0]["error"]["code"].asInteger());
+
+  // a batch call is answered with one response per call
+  EXPECT_TRUE(CJSONRPC::HandleCall("[{\"foo\":1},{\"jsonrpc\":\"2.0\",\"method\":\"Test.Unknown\",\"id\":2}]", nullptr, nullptr, responses, batch));
+  EXPECT_TRUE(batch);
+  ASSERT_EQ(2U, responses.size());
+  EXPECT_EQ(-32600, responses[0]["error"]["code"].asInteger());
+  EXPECT_EQ(-32601, responses[1]["error"]["code"].asInteger());
+  EXPECT_EQ(2, responses[1]["id"].asInteger());
+}
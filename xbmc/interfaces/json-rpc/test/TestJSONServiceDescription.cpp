@@ -0,0 +1,111 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "interfaces/json-rpc/JSONServiceDescription.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+using namespace JSONRPC;
+
+namespace
+{
+JSONSchemaTypeDefinitionPtr ParseType(const std::string &json)
+{
+  JSONSchemaTypeDefinitionPtr type(new JSONSchemaTypeDefinition());
+  EXPECT_TRUE(type->Parse(CJSONVariantParser::Parse(json)));
+  return type;
+}
+}
+
+TEST(TestJSONServiceDescription, CheckStringEnum)
+{
+  JSONSchemaTypeDefinitionPtr type = ParseType("{\"type\":\"string\",\"enum\":[\"title\",\"artist\",\"album\"]}");
+  type->name = "field";
+
+  CVariant output, errorData;
+  EXPECT_EQ(OK, type->Check(CVariant("artist"), output, errorData));
+  EXPECT_STREQ("artist", output.c_str());
+  EXPECT_TRUE(errorData.isNull());
+
+  EXPECT_EQ(InvalidParams, type->Check(CVariant("genre"), output, errorData));
+  EXPECT_FALSE(errorData["message"].empty());
+  EXPECT_STREQ("field", errorData["name"].c_str());
+  EXPECT_STREQ("string", errorData["type"].c_str());
+
+  // an enum value of another case is still a different value
+  errorData.clear();
+  EXPECT_EQ(InvalidParams, type->Check(CVariant("Artist"), output, errorData));
+  EXPECT_FALSE(errorData.isNull());
+}
+
+TEST(TestJSONServiceDescription, CheckIntegerEnum)
+{
+  JSONSchemaTypeDefinitionPtr type = ParseType("{\"type\":\"integer\",\"enum\":[1,2]}");
+
+  CVariant output, errorData;
+  EXPECT_EQ(OK, type->Check(CVariant(2), output, errorData));
+  EXPECT_TRUE(errorData.isNull());
+
+  EXPECT_EQ(InvalidParams, type->Check(CVariant(3), output, errorData));
+  EXPECT_FALSE(errorData["message"].empty());
+}
+
+TEST(TestJSONServiceDescription, CheckArrayOfStringEnums)
+{
+  // like the "properties" parameter of Player.GetProperties
+  JSONSchemaTypeDefinitionPtr type = ParseType("{\"type\":\"array\",\"uniqueItems\":true,"
+                                               "\"items\":{\"type\":\"string\",\"enum\":[\"speed\",\"time\",\"position\"]}}");
+
+  CVariant value(CVariant::VariantTypeArray);
+  value.push_back("time");
+  value.push_back("speed");
+
+  CVariant output, errorData;
+  EXPECT_EQ(OK, type->Check(value, output, errorData));
+  EXPECT_TRUE(value == output);
+  EXPECT_TRUE(errorData.isNull());
+
+  value.push_back("duration");
+  EXPECT_EQ(InvalidParams, type->Check(value, output, errorData));
+  EXPECT_FALSE(errorData["message"].empty());
+  EXPECT_FALSE(errorData["property"]["message"].empty());
+  EXPECT_STREQ("array", errorData["type"].c_str());
+}
+
+TEST(TestJSONServiceDescription, CheckObject)
+{
+  JSONSchemaTypeDefinitionPtr type = ParseType("{\"type\":\"object\",\"properties\":{"
+                                               "\"sort\":{\"type\":\"string\",\"enum\":[\"ascending\",\"descending\"]},"
+                                               "\"limit\":{\"type\":\"integer\"}}}");
+
+  CVariant value;
+  value["sort"] = "descending";
+
+  CVariant output, errorData;
+  EXPECT_EQ(OK, type->Check(value, output, errorData));
+  EXPECT_STREQ("descending", output["sort"].c_str());
+  EXPECT_TRUE(errorData.isNull());
+
+  value["sort"] = "random";
+  EXPECT_EQ(InvalidParams, type->Check(value, output, errorData));
+  EXPECT_FALSE(errorData["property"]["message"].empty());
+}
@@ -209,6 +209,8 @@ void CMusicDatabase::CreateAnalytics()
   m_pDS->exec("CREATE INDEX idxAlbum ON album(strAlbum(255))");
   m_pDS->exec("CREATE INDEX idxAlbum_1 ON album(bCompilation)");
   m_pDS->exec("CREATE UNIQUE INDEX idxAlbum_2 ON album(strMusicBrainzAlbumID(36))");
+  m_pDS->exec("CREATE INDEX idxAlbum_3 ON album(strType(255))");
+  m_pDS->exec("CREATE INDEX idxAlbum_4 ON album(strLabel(255))");
 
   m_pDS->exec("CREATE UNIQUE INDEX idxAlbumArtist_1 ON album_artist ( idAlbum, idArtist )");
   m_pDS->exec("CREATE UNIQUE INDEX idxAlbumArtist_2 ON album_artist ( idArtist, idAlbum )");
@@ -271,6 +273,11 @@ void CMusicDatabase::CreateAnalytics()
               "  DELETE FROM cue WHERE cue.idPath = old.idPath;"
               " END");
 
+  CLog::Log(LOGINFO, "create search indices");
+  CreateSearchIndex("artist", "idArtist", { "strArtist" });
+  CreateSearchIndex("album", "idAlbum", { "strAlbum" });
+  CreateSearchIndex("song", "idSong", { "strTitle" });
+
   // we create views last to ensure all indexes are rolled in
   CreateViews();
 }
@@ -724,15 +731,22 @@ int CMusicDatabase::AddSong(const int idAlbum,
     if (!strThumb.empty())
       SetArtForItem(idSong, MediaTypeSong, "thumb", strThumb);
 
+    std::vector<std::string> songGenres;
+    std::vector<std::string> albumGenres;
     unsigned int index = 0;
     for (const auto &i : genres)
     {
       // index will be wrong for albums, but ordering is not all that relevant
       // for genres anyway
       int idGenre = AddGenre(i);
-      AddSongGenre(idGenre, idSong, index);
-      AddAlbumGenre(idGenre, idAlbum, index++);
+      if (idGenre != -1 && idSong != -1)
+        songGenres.push_back(PrepareSQL("%i,%i,%i", idGenre, idSong, index));
+      if (idGenre != -1 && idAlbum != -1)
+        albumGenres.push_back(PrepareSQL("%i,%i,%i", idGenre, idAlbum, index));
+      index++;
     }
+    ExecuteInsertRows("REPLACE INTO song_genre (idGenre, idSong, iOrder)", songGenres);
+    ExecuteInsertRows("REPLACE INTO album_genre (idGenre, idAlbum, iOrder)", albumGenres);
 
     UpdateFileDateAdded(idSong, strPathAndFileName);
 
@@ -2248,9 +2262,9 @@ bool CMusicDatabase::SearchArtists(const std::string& search, CFileItemList &art
     std::string strVariousArtists = g_localizeStrings.Get(340).c_str();
     std::string strSQL;
     if (search.size() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from artist "
-                                "where (strArtist like '%s%%' or strArtist like '%% %s%%') and strArtist <> '%s' "
-                                , search.c_str(), search.c_str(), strVariousArtists.c_str() );
+      strSQL=PrepareSQL("select * from artist where strArtist <> '%s' and ", strVariousArtists.c_str()) +
+             GetSearchCondition("artist", "idArtist", search, { "strArtist" },
+                                PrepareSQL("(strArtist like '%s%%' or strArtist like '%% %s%%')", search.c_str(), search.c_str()));
     else
       strSQL=PrepareSQL("select * from artist "
                                 "where strArtist like '%s%%' and strArtist <> '%s' "
@@ -2795,7 +2809,10 @@ bool CMusicDatabase::SearchSongs(const std::string& search, CFileItemList &items
 
     std::string strSQL;
     if (search.size() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' or strTitle like '%% %s%%' limit 1000", search.c_str(), search.c_str());
+      strSQL="select * from songview where " +
+             GetSearchCondition("song", "idSong", search, { "strTitle" },
+                                PrepareSQL("(strTitle like '%s%%' or strTitle like '%% %s%%')", search.c_str(), search.c_str())) +
+             " limit 1000";
     else
       strSQL=PrepareSQL("select * from songview where strTitle like '%s%%' limit 1000", search.c_str());
 
@@ -2831,7 +2848,9 @@ bool CMusicDatabase::SearchAlbums(const std::string& search, CFileItemList &albu
 
     std::string strSQL;
     if (search.size() >= MIN_FULL_SEARCH_LENGTH)
-      strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%' or strAlbum like '%% %s%%'", search.c_str(), search.c_str());
+      strSQL="select * from albumview where " +
+             GetSearchCondition("album", "idAlbum", search, { "strAlbum" },
+                                PrepareSQL("(strAlbum like '%s%%' or strAlbum like '%% %s%%')", search.c_str(), search.c_str()));
     else
       strSQL=PrepareSQL("select * from albumview where strAlbum like '%s%%'", search.c_str());
 
@@ -3691,8 +3710,20 @@ bool CMusicDatabase::GetCommonNav(const std::string &strBaseDir, const std::stri
   
   try
   {
+    // albumview adds per album aggregates over the songs. Unfiltered album
+    // nodes only need the distinct values of an indexed album column, so
+    // read the album table under the view's name (the default album filters
+    // only refer to columns of the album table)
+    std::string navTable = table;
+    CMusicDbUrl navUrl;
+    if (table == "albumview" &&
+        (filter.fields.empty() || filter.fields == "*") && filter.join.empty() && filter.where.empty() &&
+        filter.group.empty() && filter.order.empty() && filter.limit.empty() &&
+        navUrl.FromString(strBaseDir) && navUrl.GetOptions().empty())
+      navTable = "album AS albumview";
+
     Filter extFilter = filter;
-    std::string strSQL = "SELECT %s FROM " + table + " ";
+    std::string strSQL = "SELECT %s FROM " + navTable + " ";
     extFilter.AppendGroup(labelField);
     extFilter.AppendWhere(labelField + " != ''");
     
@@ -3929,6 +3960,12 @@ bool CMusicDatabase::GetArtistsByWhere(const std::string& strBaseDir, const Filt
         m_pDS->close();
         CLog::Log(LOGERROR, "%s - out of memory getting listing (got %i)", __FUNCTION__, items.Size());
       }
+
+      if (!StreamItems(items))
+      {
+        m_pDS->close();
+        return false;
+      }
     }
 
     // cleanup
@@ -4087,6 +4124,12 @@ bool CMusicDatabase::GetAlbumsByWhere(const std::string &baseDir, const Filter &
         m_pDS->close();
         CLog::Log(LOGERROR, "%s - out of memory getting listing (got %i)", __FUNCTION__, items.Size());
       }
+
+      if (!StreamItems(items))
+      {
+        m_pDS->close();
+        return false;
+      }
     }
 
     // cleanup
@@ -4290,12 +4333,23 @@ bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filte
       strSQL = "SELECT songview.* FROM songview " + strSQLExtra;
 
     CLog::Log(LOGDEBUG, "%s query = %s", __FUNCTION__, strSQL.c_str());
+
+    // Avoid sorting with limits when have join with songartistview 
+    // Limit when SortByNone already applied in SQL, 
+    // apply sort later to fileitems list rather than dataset
+    sorting = sortDescription;
+    if (artistData && sortDescription.sortBy != SortByNone)
+      sorting.sortBy = SortByNone;
+
+    // Without any dataset sorting the rows can be walked in the order they are
+    // returned, so stream them rather than load the whole result into memory
+    bool streamed = sorting.sortBy == SortByNone;
+
     // run query
-    if (!m_pDS->query(strSQL))
+    if (!(streamed ? m_pDS->query_forward(strSQL) : m_pDS->query(strSQL)))
       return false;
 
-    int iRowsFound = m_pDS->num_rows();
-    if (iRowsFound == 0)
+    if (m_pDS->eof())
     {
       m_pDS->close();
       return true;
@@ -4304,63 +4358,71 @@ bool CMusicDatabase::GetSongsFullByWhere(const std::string &baseDir, const Filte
     // Store the total number of songs as a property
     items.SetProperty("total", total);
 
-    DatabaseResults results;
-    results.reserve(iRowsFound);
-    // Avoid sorting with limits when have join with songartistview 
-    // Limit when SortByNone already applied in SQL, 
-    // apply sort later to fileitems list rather than dataset
-    sorting = sortDescription;
-    if (artistData && sortDescription.sortBy != SortByNone)
-      sorting.sortBy = SortByNone;
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeSong, m_pDS, results))
-      return false;
-
     // Get songs from returned rows. If join songartistview then there is a row for every artist
     items.Reserve(total);
     int songArtistOffset = song_enumCount;
     int songId = -1;
     VECARTISTCREDITS artistCredits;
-    const dbiplus::query_data &data = m_pDS->get_result_set().records;
     int count = 0;
-    for (const auto &i : results)
+    auto addRecord = [&](const dbiplus::sql_record* const record)
     {
-      unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
-      
-      try
-      {
-        if (songId != record->at(song_idSong).get_asInt())
-        { //New song
-          if (songId > 0 && !artistCredits.empty())
-          {
-            //Store artist credits for previous song
-            GetFileItemFromArtistCredits(artistCredits, items[items.Size()-1].get());
-            artistCredits.clear();
-          }
-          songId = record->at(song_idSong).get_asInt();
-          CFileItemPtr item(new CFileItem);
-          GetFileItemFromDataset(record, item.get(), musicUrl);
-          // HACK for sorting by database returned order
-          item->m_iprogramCount = ++count;
-          items.Add(item);
+      if (songId != record->at(song_idSong).get_asInt())
+      { //New song
+        if (songId > 0 && !artistCredits.empty())
+        {
+          //Store artist credits for previous song
+          GetFileItemFromArtistCredits(artistCredits, items[items.Size()-1].get());
+          artistCredits.clear();
         }
-        // Get song artist credits and contributors
-        if (artistData)
+        songId = record->at(song_idSong).get_asInt();
+        CFileItemPtr item(new CFileItem);
+        GetFileItemFromDataset(record, item.get(), musicUrl);
+        // HACK for sorting by database returned order
+        item->m_iprogramCount = ++count;
+        items.Add(item);
+      }
+      // Get song artist credits and contributors
+      if (artistData)
+      {
+        int idSongArtistRole = record->at(songArtistOffset + artistCredit_idRole).get_asInt();
+        if (idSongArtistRole == ROLE_ARTIST)
+          artistCredits.push_back(GetArtistCreditFromDataset(record, songArtistOffset));
+        else
+          items[items.Size() - 1]->GetMusicInfoTag()->AppendArtistRole(GetArtistRoleFromDataset(record, songArtistOffset));           
+      }
+    };
+
+    try
+    {
+      if (streamed)
+      {
+        while (!m_pDS->eof())
         {
-          int idSongArtistRole = record->at(songArtistOffset + artistCredit_idRole).get_asInt();
-          if (idSongArtistRole == ROLE_ARTIST)
-            artistCredits.push_back(GetArtistCreditFromDataset(record, songArtistOffset));
-          else
-            items[items.Size() - 1]->GetMusicInfoTag()->AppendArtistRole(GetArtistRoleFromDataset(record, songArtistOffset));           
+          addRecord(m_pDS->get_sql_record());
+          m_pDS->next();
         }
       }
-      catch (...)
+      else
       {
-        m_pDS->close();
-        CLog::Log(LOGERROR, "%s: out of memory loading query: %s", __FUNCTION__, filter.where.c_str());
-        return (items.Size() > 0);
+        DatabaseResults results;
+        results.reserve(m_pDS->num_rows());
+        if (!SortUtils::SortFromDataset(sorting, MediaTypeSong, m_pDS, results))
+          return false;
+
+        const dbiplus::query_data &data = m_pDS->get_result_set().records;
+        for (const auto &i : results)
+        {
+          unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
+          addRecord(data.at(targetRow));
+        }
       }
     }
+    catch (...)
+    {
+      m_pDS->close();
+      CLog::Log(LOGERROR, "%s: out of memory loading query: %s", __FUNCTION__, filter.where.c_str());
+      return (items.Size() > 0);
+    }
     if (!artistCredits.empty())
     {
       //Store artist credits for final song
@@ -5007,7 +5069,7 @@ void CMusicDatabase::UpdateTables(int version)
 
 int CMusicDatabase::GetSchemaVersion() const
 {
-  return 62;
+  return 64;
 }
 
 int CMusicDatabase::GetMusicNeedsTagScan()
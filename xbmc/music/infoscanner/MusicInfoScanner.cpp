@@ -136,9 +136,16 @@ void CMusicInfoScanner::Process()
       m_bCanInterrupt = false;
       m_needsCleanup = false;
 
+      // list the folders of different sources and hosts in parallel, while they are scanned in order
+      m_prefetcher.reset(new CDirectoryPrefetcher(g_advancedSettings.GetMusicExtensions() + "|.jpg|.tbn|.lrc|.cdg"));
+
       bool commit = true;
       for (std::set<std::string>::const_iterator it = m_pathsToScan.begin(); it != m_pathsToScan.end(); ++it)
       {
+        std::set<std::string>::const_iterator next = std::next(it);
+        if (next != m_pathsToScan.end())
+          m_prefetcher->Prefetch(*next);
+
         if (!CDirectory::Exists(*it) && !m_bClean)
         {
           /*
@@ -158,6 +165,8 @@ void CMusicInfoScanner::Process()
         }
       }
 
+      m_prefetcher.reset();
+
       if (commit)
       {
         g_infoManager.ResetLibraryBools();
@@ -453,7 +462,10 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
 
   std::set<std::string>::const_iterator it = m_seenPaths.find(strDirectory);
   if (it != m_seenPaths.end())
+  {
+    m_prefetcher->Discard(strDirectory);
     return true;
+  }
 
   m_seenPaths.insert(strDirectory);
 
@@ -461,11 +473,23 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
   const std::vector<std::string> &regexps = g_advancedSettings.m_audioExcludeFromScanRegExps;
 
   if (IsExcluded(strDirectory, regexps))
+  {
+    m_prefetcher->Discard(strDirectory);
     return true;
+  }
 
   // load subfolder
   CFileItemList items;
-  CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.GetMusicExtensions() + "|.jpg|.tbn|.lrc|.cdg");
+  m_prefetcher->GetDirectory(strDirectory, items);
+
+  // start listing the subfolders we're going to scan next
+  for (int i = 0; i < items.Size(); ++i)
+  {
+    const CFileItemPtr pItem = items[i];
+    if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList() &&
+        m_seenPaths.find(pItem->GetPath()) == m_seenPaths.end())
+      m_prefetcher->Prefetch(pItem->GetPath());
+  }
 
   // sort and get the path hash.  Note that we don't filter .cue sheet items here as we want
   // to detect changes in the .cue sheet as well.  The .cue sheet items only need filtering
@@ -529,6 +553,8 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
     }
   }
 
+  // drop the listings of subfolders that weren't scanned
+  m_prefetcher->Discard(strDirectory);
   return !m_bStop;
 }
 
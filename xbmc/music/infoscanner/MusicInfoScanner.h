@@ -18,9 +18,12 @@
  *  <http://www.gnu.org/licenses/>.
  *
  */
+#include <memory>
+
 #include "InfoScanner.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
+#include "filesystem/DirectoryPrefetcher.h"
 #include "music/MusicDatabase.h"
 #include "threads/Thread.h"
 
@@ -221,6 +224,7 @@ protected:
 
   std::set<std::string> m_pathsToScan;
   std::set<std::string> m_seenPaths;
+  std::unique_ptr<XFILE::CDirectoryPrefetcher> m_prefetcher; //!< lists the folders to scan ahead of time
   int m_flags;
   CThread m_fileCountReader;
 };
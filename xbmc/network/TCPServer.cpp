@@ -21,6 +21,7 @@
 #include "TCPServer.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <algorithm>
 #include <memory.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -29,6 +30,7 @@
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "interfaces/AnnouncementManager.h"
 #include "utils/log.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 #include "threads/SingleLock.h"
 #include "websocket/WebSocketManager.h"
@@ -60,6 +62,30 @@ using namespace ANNOUNCEMENT;
 
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
+std::string CTCPServer::GetCoalescingKey(AnnouncementFlag flag, const char *message, const CVariant &data)
+{
+  std::string method = StringUtils::Format("%s.%s", AnnouncementFlagToString(flag), message);
+
+  if (flag == Player && (strcmp(message, "OnSeek") == 0 || strcmp(message, "OnSpeedChanged") == 0))
+    return method + "." + data["player"]["playerid"].asString();
+
+  if (flag == Application && strcmp(message, "OnVolumeChanged") == 0)
+    return method;
+
+  if ((flag == VideoLibrary || flag == AudioLibrary) && strcmp(message, "OnUpdate") == 0)
+  {
+    const CVariant &item = data.isMember("item") ? data["item"] : data;
+    if (!item.isMember("id") || data["added"].asBoolean())
+      return "";
+
+    // only updates carrying the same kind of information may replace each other
+    return StringUtils::Format("%s.%s.%s%s", method.c_str(), item["type"].asString().c_str(), item["id"].asString().c_str(),
+                               data.isMember("playcount") ? ".playcount" : "");
+  }
+
+  return "";
+}
+
 bool CTCPServer::StartServer(int port, bool nonlocal)
 {
   StopServer(true);
@@ -126,6 +152,20 @@ void CTCPServer::Process()
     struct timeval  to     = {1, 0};
     FD_ZERO(&rfds);
 
+    // wake up in time to send the pending announcements. Announcements made
+    // while waiting in select() must not wait longer than about one window.
+    if (g_advancedSettings.m_jsonNotificationWindow > 0)
+    {
+      unsigned int millisLeft = std::min(g_advancedSettings.m_jsonNotificationWindow, 1000u);
+
+      CSingleLock lock(m_announcementsSection);
+      if (!m_announcements.empty())
+        millisLeft = std::min(m_announcementsTimeout.MillisLeft(), millisLeft);
+
+      to.tv_sec = millisLeft / 1000;
+      to.tv_usec = (millisLeft % 1000) * 1000;
+    }
+
     for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); ++it)
     {
       FD_SET(*it, &rfds);
@@ -222,6 +262,8 @@ void CTCPServer::Process()
         }
       }
     }
+
+    SendAnnouncements();
   }
 
   Deinitialize();
@@ -246,6 +288,27 @@ void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char
 {
   std::string str = IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact);
 
+  // collect the announcements and let the server thread send them at the
+  // end of the notification window
+  if (g_advancedSettings.m_jsonNotificationWindow > 0)
+  {
+    PendingAnnouncement announcement = { flag, GetCoalescingKey(flag, message, data), str };
+
+    CSingleLock lock(m_announcementsSection);
+    // the window starts with the first announcement even if it is replaced later on
+    if (m_announcements.empty())
+      m_announcementsTimeout.Set(g_advancedSettings.m_jsonNotificationWindow);
+    else if (!announcement.key.empty())
+    {
+      m_announcements.erase(std::remove_if(m_announcements.begin(), m_announcements.end(),
+                                           [&announcement](const PendingAnnouncement &pending) { return pending.key == announcement.key; }),
+                            m_announcements.end());
+    }
+
+    m_announcements.push_back(std::move(announcement));
+    return;
+  }
+
   for (unsigned int i = 0; i < m_connections.size(); i++)
   {
     {
@@ -258,6 +321,37 @@ void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char
   }
 }
 
+void CTCPServer::SendAnnouncements()
+{
+  std::vector<PendingAnnouncement> announcements;
+  {
+    CSingleLock lock(m_announcementsSection);
+    if (m_announcements.empty() || !m_announcementsTimeout.IsTimePast())
+      return;
+
+    announcements.swap(m_announcements);
+  }
+
+  for (unsigned int i = 0; i < m_connections.size(); i++)
+  {
+    int flags;
+    {
+      CSingleLock lock (m_connections[i]->m_critSection);
+      flags = m_connections[i]->GetAnnouncementFlags();
+    }
+
+    std::vector<const std::string*> clientAnnouncements;
+    for (std::vector<PendingAnnouncement>::const_iterator announcement = announcements.begin(); announcement != announcements.end(); ++announcement)
+    {
+      if ((flags & announcement->flag) != 0)
+        clientAnnouncements.push_back(&announcement->json);
+    }
+
+    if (!clientAnnouncements.empty())
+      m_connections[i]->SendAnnouncements(clientAnnouncements, g_advancedSettings.m_jsonBatchNotifications);
+  }
+}
+
 bool CTCPServer::Initialize()
 {
   Deinitialize();
@@ -480,6 +574,11 @@ void CTCPServer::Deinitialize()
 
   m_connections.clear();
 
+  {
+    CSingleLock lock(m_announcementsSection);
+    m_announcements.clear();
+  }
+
   for (unsigned int i = 0; i < m_servers.size(); i++)
     closesocket(m_servers[i]);
 
@@ -544,6 +643,26 @@ void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
   } while (sent < size);
 }
 
+void CTCPServer::CTCPClient::SendAnnouncements(const std::vector<const std::string*> &announcements, bool batch)
+{
+  // write all announcements at once, either as a JSON array or one after the other
+  std::string buffer;
+  if (batch)
+    buffer = "[";
+
+  for (std::vector<const std::string*>::const_iterator announcement = announcements.begin(); announcement != announcements.end(); ++announcement)
+  {
+    if (batch && announcement != announcements.begin())
+      buffer += ",";
+    buffer += **announcement;
+  }
+
+  if (batch)
+    buffer += "]";
+
+  Send(buffer.c_str(), buffer.size());
+}
+
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
 {
   m_new = false;
@@ -572,8 +691,7 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
         m_endBrackets++;
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        Send(line.c_str(), line.size());
+        SendResponse(host, m_buffer);
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
       }
@@ -581,6 +699,14 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
   }
 }
 
+void CTCPServer::CTCPClient::SendResponse(CTCPServer *host, const std::string &request)
+{
+  // the method is executed and the response serialized without holding the
+  // client's lock, which Send() only takes around each send() call
+  std::string response = CJSONRPC::MethodCall(request, host, this);
+  Send(response.c_str(), response.size());
+}
+
 void CTCPServer::CTCPClient::Disconnect()
 {
   if (m_socket > 0)
@@ -678,6 +804,26 @@ void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buff
     Disconnect();
 }
 
+void CTCPServer::CWebSocketClient::SendAnnouncements(const std::vector<const std::string*> &announcements, bool batch)
+{
+  if (batch)
+  {
+    CTCPClient::SendAnnouncements(announcements, batch);
+    return;
+  }
+
+  // every call to Send() results in a separate websocket message
+  for (std::vector<const std::string*>::const_iterator announcement = announcements.begin(); announcement != announcements.end(); ++announcement)
+    Send((*announcement)->c_str(), (*announcement)->size());
+}
+
+void CTCPServer::CWebSocketClient::SendResponse(CTCPServer *host, const std::string &request)
+{
+  // every call to Send() results in a separate websocket message
+  std::string response = CJSONRPC::MethodCall(request, host, this);
+  Send(response.c_str(), response.size());
+}
+
 void CTCPServer::CWebSocketClient::Disconnect()
 {
   if (m_socket > 0)
@@ -27,6 +27,7 @@
 #include "interfaces/json-rpc/IJSONRPCAnnouncer.h"
 #include "interfaces/json-rpc/ITransportLayer.h"
 #include "threads/CriticalSection.h"
+#include "threads/SystemClock.h"
 #include "threads/Thread.h"
 #include "websocket/WebSocket.h"
 
@@ -46,6 +47,13 @@ namespace JSONRPC
     virtual int GetCapabilities();
 
     virtual void Announce(ANNOUNCEMENT::AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data);
+
+    /*!
+     \brief Returns a key identifying announcements which only report the latest state
+     of something, so that a newer one can replace an older one that hasn't been sent yet.
+     \return the key, or an empty string for announcements that must all be sent
+     */
+    static std::string GetCoalescingKey(ANNOUNCEMENT::AnnouncementFlag flag, const char *message, const CVariant &data);
   protected:
     void Process();
   private:
@@ -55,6 +63,8 @@ namespace JSONRPC
     bool InitializeTCP();
     void Deinitialize();
 
+    void SendAnnouncements();
+
     class CTCPClient : public IClient
     {
     public:
@@ -70,6 +80,7 @@ namespace JSONRPC
       virtual bool SetAnnouncementFlags(int flags);
 
       virtual void Send(const char *data, unsigned int size);
+      virtual void SendAnnouncements(const std::vector<const std::string*> &announcements, bool batch);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
@@ -83,6 +94,7 @@ namespace JSONRPC
 
     protected:
       void Copy(const CTCPClient& client);
+      virtual void SendResponse(CTCPServer *host, const std::string &request);
     private:
       bool m_new;
       int m_announcementflags;
@@ -101,17 +113,34 @@ namespace JSONRPC
       ~CWebSocketClient();
 
       virtual void Send(const char *data, unsigned int size);
+      virtual void SendAnnouncements(const std::vector<const std::string*> &announcements, bool batch);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
       virtual bool IsNew() const { return m_websocket == NULL; }
       virtual bool Closing() const { return m_websocket != NULL && m_websocket->GetState() == WebSocketStateClosed; }
 
+    protected:
+      virtual void SendResponse(CTCPServer *host, const std::string &request);
+
     private:
       CWebSocket *m_websocket;
     };
 
+    /*!
+     \brief Announcement waiting to be sent to the clients
+     */
+    struct PendingAnnouncement
+    {
+      ANNOUNCEMENT::AnnouncementFlag flag;
+      std::string key;  //!< announcements with the same non-empty key replace each other
+      std::string json;
+    };
+
     std::vector<CTCPClient*> m_connections;
+    std::vector<PendingAnnouncement> m_announcements;
+    XbmcThreads::EndTime m_announcementsTimeout;
+    CCriticalSection m_announcementsSection;
     std::vector<SOCKET> m_servers;
     int m_port;
     bool m_nonlocal;
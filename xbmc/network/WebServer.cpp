@@ -22,15 +22,20 @@
 
 #ifdef HAS_WEB_SERVER
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 #if defined(TARGET_POSIX)
+#include <fcntl.h>
 #include <pthread.h>
+#include <unistd.h>
 #endif
 
 #include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
 #include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
 #include "settings/AdvancedSettings.h"
@@ -55,6 +60,7 @@
 #endif // TARGET_WINDOWS
 
 #define MAX_POST_BUFFER_SIZE 2048
+#define STREAM_BLOCK_SIZE    (64 * 1024)
 
 #define PAGE_FILE_NOT_FOUND "<html><head><title>File not found</title></head><body>File not found</body></html>"
 #define NOT_SUPPORTED       "<html><head><title>Not Supported</title></head><body>The method you are trying to use is not supported by this server</body></html>"
@@ -112,6 +118,34 @@ static MHD_Response* create_response(size_t size, void* data, int free, int copy
 #endif
 }
 
+#if defined(TARGET_POSIX) && (MHD_VERSION >= 0x00094000)
+static MHD_Response* create_local_file_response(const std::string &filePath, uint64_t offset, uint64_t length)
+{
+  // only files on a local filesystem can be handed to MHD as a file descriptor
+  const std::string localPath = CSpecialProtocol::TranslatePath(filePath);
+  if (!URIUtils::IsHD(localPath) || URIUtils::IsStack(localPath) || URIUtils::IsInArchive(localPath))
+    return nullptr;
+
+  int fd = open(localPath.c_str(), O_RDONLY);
+  if (fd < 0)
+    return nullptr;
+
+  // MHD closes the file descriptor when it destroys the response
+  MHD_Response *response = nullptr;
+#if (MHD_VERSION >= 0x00095000)
+  response = MHD_create_response_from_fd_at_offset64(length, fd, offset);
+#else
+  // the 64 bit variant isn't available in all older versions, which take a size_t length and an off_t offset
+  if (length <= std::numeric_limits<size_t>::max() && offset <= static_cast<uint64_t>(std::numeric_limits<off_t>::max()))
+    response = MHD_create_response_from_fd_at_offset(static_cast<size_t>(length), fd, static_cast<off_t>(offset));
+#endif
+  if (response == nullptr)
+    close(fd);
+
+  return response;
+}
+#endif
+
 int CWebServer::AskForAuthentication(struct MHD_Connection *connection) const
 {
   struct MHD_Response *response = create_response(0, nullptr, MHD_NO, MHD_NO);
@@ -498,6 +532,10 @@ int CWebServer::HandleRequest(const std::shared_ptr<IHTTPRequestHandler>& handle
       ret = CreateMemoryDownloadResponse(handler, response);
       break;
 
+    case HTTPStreamDownload:
+      ret = CreateStreamDownloadResponse(handler, response);
+      break;
+
     case HTTPError:
       ret = CreateErrorResponse(request.connection, responseDetails.status, request.method, response);
       break;
@@ -846,18 +884,29 @@ int CWebServer::CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHan
     // set the initial write position
     context->ranges.GetFirstPosition(context->writePosition);
 
+    response = nullptr;
+#if defined(TARGET_POSIX) && (MHD_VERSION >= 0x00094000)
+    // a single range of a local file is sent straight from the file descriptor
+    // which lets MHD use sendfile() instead of copying it through ContentReaderCallback
+    if (context->rangeCountTotal == 1)
+      response = create_local_file_response(filePath, context->writePosition, totalLength);
+#endif
+
     // create the response object
-    response = MHD_create_response_from_callback(totalLength, 2048,
-                                                  &CWebServer::ContentReaderCallback,
-                                                  context.get(),
-                                                  &CWebServer::ContentReaderFreeCallback);
     if (response == nullptr)
     {
-      CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP response for %s to be filled from %s", m_port, request.pathUrl.c_str(), filePath.c_str());
-      return MHD_NO;
-    }
+      response = MHD_create_response_from_callback(totalLength, 2048,
+                                                    &CWebServer::ContentReaderCallback,
+                                                    context.get(),
+                                                    &CWebServer::ContentReaderFreeCallback);
+      if (response == nullptr)
+      {
+        CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP response for %s to be filled from %s", m_port, request.pathUrl.c_str(), filePath.c_str());
+        return MHD_NO;
+      }
 
-    context.release(); // ownership was passed to mhd
+      context.release(); // ownership was passed to mhd
+    }
 
     // add Content-Range header
     if (ranged)
@@ -882,6 +931,50 @@ int CWebServer::CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHan
   return MHD_YES;
 }
 
+int CWebServer::CreateStreamDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response *&response) const
+{
+  if (handler == nullptr)
+    return MHD_NO;
+
+  const HTTPRequest &request = handler->GetRequest();
+
+  // there's nothing to send for a HEAD request
+  if (request.method == HEAD)
+    return CreateMemoryDownloadResponse(request.connection, nullptr, 0, false, false, response);
+
+#ifdef MHD_SIZE_UNKNOWN
+  // the response data is pulled from the request handler while it is sent
+  // so the handler has to stay alive until MHD is done with the response
+  std::unique_ptr<std::shared_ptr<IHTTPRequestHandler>> context(new std::shared_ptr<IHTTPRequestHandler>(handler));
+  response = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN, STREAM_BLOCK_SIZE,
+                                                &CWebServer::StreamReaderCallback,
+                                                context.get(),
+                                                &CWebServer::StreamReaderFreeCallback);
+  if (response == nullptr)
+  {
+    CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP response for %s to be streamed", m_port, request.pathUrl.c_str());
+    return MHD_NO;
+  }
+
+  context.release(); // ownership was passed to mhd
+  return MHD_YES;
+#else
+  // responses of unknown length aren't supported so collect the whole response data
+  std::string data;
+  std::vector<char> buffer(STREAM_BLOCK_SIZE);
+  size_t written = 0;
+  do
+  {
+    if (!handler->ReadResponseData(buffer.data(), buffer.size(), written))
+      return MHD_NO;
+
+    data.append(buffer.data(), written);
+  } while (written > 0);
+
+  return CreateMemoryDownloadResponse(request.connection, data.c_str(), data.size(), false, true, response);
+#endif
+}
+
 int CWebServer::CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response) const
 {
   size_t payloadSize = 0;
@@ -1083,6 +1176,48 @@ void CWebServer::ContentReaderFreeCallback(void *cls)
     CLog::Log(LOGDEBUG, "CWebServer [OUT] done");
 }
 
+#if (MHD_VERSION >= 0x00090200)
+ssize_t CWebServer::StreamReaderCallback(void *cls, uint64_t pos, char *buf, size_t max)
+#elif (MHD_VERSION >= 0x00040001)
+int CWebServer::StreamReaderCallback(void *cls, uint64_t pos, char *buf, int max)
+#else   //libmicrohttpd < 0.4.0
+int CWebServer::StreamReaderCallback(void *cls, size_t pos, char *buf, int max)
+#endif
+{
+  std::shared_ptr<IHTTPRequestHandler> *handler = static_cast<std::shared_ptr<IHTTPRequestHandler>*>(cls);
+  if (handler == nullptr || *handler == nullptr || max <= 0)
+    return -1;
+
+  size_t written = 0;
+  if (!(*handler)->ReadResponseData(buf, static_cast<size_t>(max), written))
+  {
+    CLog::Log(LOGERROR, "CWebServer: failed to stream the HTTP response for %s", (*handler)->GetRequest().pathUrl.c_str());
+#ifdef MHD_CONTENT_READER_END_WITH_ERROR
+    return MHD_CONTENT_READER_END_WITH_ERROR;
+#else
+    return -1;
+#endif
+  }
+
+  if (g_advancedSettings.CanLogComponent(LOGWEBSERVER))
+    CLog::Log(LOGDEBUG, "CWebServer [OUT] streamed %zu bytes from %" PRIu64, written, static_cast<uint64_t>(pos));
+
+  // all of the response data has been sent
+  if (written == 0)
+    return -1;
+
+  return written;
+}
+
+void CWebServer::StreamReaderFreeCallback(void *cls)
+{
+  std::shared_ptr<IHTTPRequestHandler> *handler = static_cast<std::shared_ptr<IHTTPRequestHandler>*>(cls);
+  delete handler;
+
+  if (g_advancedSettings.CanLogComponent(LOGWEBSERVER))
+    CLog::Log(LOGDEBUG, "CWebServer [OUT] done");
+}
+
 // local helper
 static void panicHandlerForMHD(void* unused, const char* file, unsigned int line, const char *reason)
 {
@@ -1120,8 +1255,35 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
   MHD_set_panic_func(&panicHandlerForMHD, nullptr);
 #endif
 
+#if (MHD_VERSION >= 0x00094000)
+  // with a thread pool all connections are served by a fixed number of threads
+  // waiting for events on their sockets, instead of one thread per connection
+  unsigned int threadPoolSize = g_advancedSettings.m_webserverThreadPoolSize;
+  struct MHD_OptionItem poolOptions[] = {
+    { threadPoolSize > 0 ? MHD_OPTION_THREAD_POOL_SIZE : MHD_OPTION_END, static_cast<intptr_t>(threadPoolSize), nullptr },
+    { MHD_OPTION_END, 0, nullptr }
+  };
+
+  if (threadPoolSize > 0)
+  {
+    flags |= MHD_USE_SELECT_INTERNALLY;
+#if defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+#if (MHD_VERSION >= 0x00095300)
+    flags |= MHD_USE_EPOLL;
+#else
+    flags |= MHD_USE_EPOLL_LINUX_ONLY;
+#endif
+#endif
+  }
+  else
+    flags |= MHD_USE_THREAD_PER_CONNECTION;
+#endif
+
   return MHD_start_daemon(flags |
-#if (MHD_VERSION >= 0x00040002) && (MHD_VERSION < 0x00090B01)
+#if (MHD_VERSION >= 0x00094000)
+                          // threading model chosen above
+                          0
+#elif (MHD_VERSION >= 0x00040002) && (MHD_VERSION < 0x00090B01)
                           // use main thread for each connection, can only handle one request at a
                           // time [unless you set the thread pool size]
                           MHD_USE_SELECT_INTERNALLY
@@ -1141,7 +1303,9 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
                           &CWebServer::AnswerToConnection,
                           this,
 
-#if (MHD_VERSION >= 0x00040002) && (MHD_VERSION < 0x00090B01)
+#if (MHD_VERSION >= 0x00094000)
+                          MHD_OPTION_ARRAY, poolOptions,
+#elif (MHD_VERSION >= 0x00040002) && (MHD_VERSION < 0x00090B01)
                           MHD_OPTION_THREAD_POOL_SIZE, 4,
 #endif
                           MHD_OPTION_CONNECTION_LIMIT, 512,
@@ -19,6 +19,10 @@
  */
 
 #include "HTTPJsonRpcHandler.h"
+
+#include <algorithm>
+#include <cstring>
+
 #include "URL.h"
 #include "filesystem/File.h"
 #include "interfaces/json-rpc/JSONRPC.h"
@@ -26,7 +30,7 @@
 #include "interfaces/json-rpc/JSONUtils.h"
 #include "network/WebServer.h"
 #include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
-#include "utils/JSONVariantWriter.h"
+#include "settings/AdvancedSettings.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
 
@@ -82,19 +86,43 @@ int CHTTPJsonRpcHandler::HandleRequest()
       jsonpCallback = argument->second;
   }
 
+  m_responseParts.clear();
+  m_responsePart = 0;
+  m_responseOffset = 0;
+  m_responseWriter.reset();
+
   if (isRequest)
   {
-    m_responseData = JSONRPC::CJSONRPC::MethodCall(m_requestData, &m_transportLayer, &client);
+    m_compact = g_advancedSettings.m_jsonOutputCompact;
 
     if (!jsonpCallback.empty())
-      m_responseData = jsonpCallback + "(" + m_responseData + ");";
+      AddResponseText(jsonpCallback + "(");
+
+    bool batch = false;
+    std::vector<CVariant> responses;
+    if (JSONRPC::CJSONRPC::HandleCall(m_requestData, &m_transportLayer, &client, responses, batch))
+    {
+      for (std::vector<CVariant>::iterator response = responses.begin(); response != responses.end(); ++response)
+      {
+        if (batch)
+          AddResponseText(response == responses.begin() ? "[" : ",");
+        AddResponseValue(std::move(*response));
+      }
+
+      if (batch)
+        AddResponseText("]");
+    }
+
+    if (!jsonpCallback.empty())
+      AddResponseText(");");
   }
   else if (jsonpCallback.empty())
   {
     // get the whole output of JSONRPC.Introspect
     CVariant result;
     JSONRPC::CJSONServiceDescription::Print(result, &m_transportLayer, &client);
-    m_responseData = CJSONVariantWriter::Write(result, false);
+    m_compact = false;
+    AddResponseValue(std::move(result));
   }
   else
   {
@@ -106,22 +134,68 @@ int CHTTPJsonRpcHandler::HandleRequest()
 
   m_requestData.clear();
 
-  m_responseRange.SetData(m_responseData.c_str(), m_responseData.size());
-
-  m_response.type = HTTPMemoryDownloadNoFreeCopy;
+  // the length of the response isn't known until it has been serialized
+  m_response.type = HTTPStreamDownload;
   m_response.status = MHD_HTTP_OK;
   m_response.contentType = "application/json";
-  m_response.totalLength = m_responseData.size();
+  m_response.totalLength = 0;
 
   return MHD_YES;
 }
 
-HttpResponseRanges CHTTPJsonRpcHandler::GetResponseData() const
+bool CHTTPJsonRpcHandler::ReadResponseData(char *buffer, size_t size, size_t &written)
 {
-  HttpResponseRanges ranges;
-  ranges.push_back(m_responseRange);
+  written = 0;
 
-  return ranges;
+  while (written < size && m_responsePart < m_responseParts.size())
+  {
+    const CResponsePart &part = m_responseParts[m_responsePart];
+    if (!part.text.empty())
+    {
+      size_t count = std::min(size - written, part.text.size() - m_responseOffset);
+      memcpy(buffer + written, part.text.c_str() + m_responseOffset, count);
+      written += count;
+      m_responseOffset += count;
+
+      if (m_responseOffset < part.text.size())
+        continue;
+    }
+    else
+    {
+      if (m_responseWriter == nullptr)
+        m_responseWriter.reset(new CJSONVariantStreamWriter(part.value, m_compact));
+
+      size_t count = 0;
+      if (!m_responseWriter->Write(buffer + written, size - written, count))
+        return false;
+
+      written += count;
+      if (count > 0)
+        continue;
+
+      m_responseWriter.reset();
+    }
+
+    // the current part has been written completely
+    m_responsePart++;
+    m_responseOffset = 0;
+  }
+
+  return true;
+}
+
+void CHTTPJsonRpcHandler::AddResponseText(const std::string &text)
+{
+  CResponsePart part;
+  part.text = text;
+  m_responseParts.push_back(std::move(part));
+}
+
+void CHTTPJsonRpcHandler::AddResponseValue(CVariant &&value)
+{
+  CResponsePart part;
+  part.value = std::move(value);
+  m_responseParts.push_back(std::move(part));
 }
 
 #if (MHD_VERSION >= 0x00040001)
@@ -19,11 +19,15 @@
  *
  */
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "interfaces/json-rpc/IClient.h"
 #include "interfaces/json-rpc/ITransportLayer.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/Variant.h"
 
 class CHTTPJsonRpcHandler : public IHTTPRequestHandler
 {
@@ -37,13 +41,16 @@ public:
 
   virtual int HandleRequest();
 
-  virtual HttpResponseRanges GetResponseData() const;
+  virtual bool ReadResponseData(char *buffer, size_t size, size_t &written);
 
   virtual int GetPriority() const { return 5; }
 
 protected:
   explicit CHTTPJsonRpcHandler(const HTTPRequest &request)
-    : IHTTPRequestHandler(request)
+    : IHTTPRequestHandler(request),
+      m_compact(true),
+      m_responsePart(0),
+      m_responseOffset(0)
   { }
 
 #if (MHD_VERSION >= 0x00040001)
@@ -53,9 +60,22 @@ protected:
 #endif
 
 private:
+  void AddResponseText(const std::string &text);
+  void AddResponseValue(CVariant &&value);
+
   std::string m_requestData;
-  std::string m_responseData;
-  CHttpResponseRange m_responseRange;
+
+  // the response is only serialized while it is being sent
+  struct CResponsePart
+  {
+    std::string text;
+    CVariant value; // only used if text is empty
+  };
+  std::vector<CResponsePart> m_responseParts;
+  bool m_compact;
+  size_t m_responsePart;
+  size_t m_responseOffset;
+  std::unique_ptr<CJSONVariantStreamWriter> m_responseWriter;
 
   class CHTTPTransportLayer : public JSONRPC::ITransportLayer
   {
@@ -65,7 +65,10 @@ typedef enum HTTPResponseType
   HTTPMemoryDownloadFreeNoCopy,
   // creates a HTTP response from a buffer by copying followed by freeing the buffer
   // the buffer must have been malloc'ed and not new'ed
-  HTTPMemoryDownloadFreeCopy
+  HTTPMemoryDownloadFreeCopy,
+  // creates a HTTP response of unknown length whose content is pulled from the
+  // request handler while it is being sent
+  HTTPStreamDownload
 } HTTPResponseType;
 
 typedef struct HTTPRequest
@@ -158,6 +161,18 @@ public:
    */
   virtual HttpResponseRanges GetResponseData() const { return HttpResponseRanges(); };
 
+  /*!
+   * \brief Writes the next part of the response data into the given buffer.
+   *
+   * \details This is only used if the response type is HTTPStreamDownload.
+   *
+   * \param buffer Buffer to write the response data to
+   * \param size Size of the buffer
+   * \param written Number of bytes written, 0 once all of the response data has been written
+   * \return False if the response data could not be provided, otherwise true.
+   */
+  virtual bool ReadResponseData(char *buffer, size_t size, size_t &written) { return false; }
+
   /*!
   * \brief Returns the URL to which the request should be redirected.
   *
@@ -0,0 +1,87 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "network/TCPServer.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+using namespace ANNOUNCEMENT;
+using namespace JSONRPC;
+
+namespace
+{
+CVariant PlayerData(int playerid)
+{
+  CVariant data;
+  data["player"]["playerid"] = playerid;
+  return data;
+}
+
+CVariant UpdateData(int id, bool playcount, bool added)
+{
+  CVariant data;
+  data["item"]["id"] = id;
+  data["item"]["type"] = "movie";
+  if (playcount)
+    data["playcount"] = 1;
+  if (added)
+    data["added"] = true;
+  return data;
+}
+}
+
+TEST(TestTCPServer, CoalesceSeekPerPlayer)
+{
+  std::string key = CTCPServer::GetCoalescingKey(Player, "OnSeek", PlayerData(1));
+  EXPECT_FALSE(key.empty());
+  EXPECT_EQ(key, CTCPServer::GetCoalescingKey(Player, "OnSeek", PlayerData(1)));
+  EXPECT_NE(key, CTCPServer::GetCoalescingKey(Player, "OnSeek", PlayerData(2)));
+  EXPECT_NE(key, CTCPServer::GetCoalescingKey(Player, "OnSpeedChanged", PlayerData(1)));
+
+  EXPECT_TRUE(CTCPServer::GetCoalescingKey(Player, "OnPlay", PlayerData(1)).empty());
+  EXPECT_TRUE(CTCPServer::GetCoalescingKey(Player, "OnStop", PlayerData(1)).empty());
+}
+
+TEST(TestTCPServer, CoalesceLibraryUpdates)
+{
+  std::string key = CTCPServer::GetCoalescingKey(VideoLibrary, "OnUpdate", UpdateData(1, false, false));
+  EXPECT_FALSE(key.empty());
+  EXPECT_EQ(key, CTCPServer::GetCoalescingKey(VideoLibrary, "OnUpdate", UpdateData(1, false, false)));
+  EXPECT_NE(key, CTCPServer::GetCoalescingKey(VideoLibrary, "OnUpdate", UpdateData(2, false, false)));
+  EXPECT_NE(key, CTCPServer::GetCoalescingKey(AudioLibrary, "OnUpdate", UpdateData(1, false, false)));
+
+  // updates with a playcount only replace other updates with a playcount
+  std::string playcountKey = CTCPServer::GetCoalescingKey(VideoLibrary, "OnUpdate", UpdateData(1, true, false));
+  EXPECT_FALSE(playcountKey.empty());
+  EXPECT_NE(key, playcountKey);
+  EXPECT_EQ(playcountKey, CTCPServer::GetCoalescingKey(VideoLibrary, "OnUpdate", UpdateData(1, true, false)));
+}
+
+TEST(TestTCPServer, AddedItemsAreNotCoalesced)
+{
+  EXPECT_TRUE(CTCPServer::GetCoalescingKey(VideoLibrary, "OnUpdate", UpdateData(1, false, true)).empty());
+  EXPECT_TRUE(CTCPServer::GetCoalescingKey(AudioLibrary, "OnUpdate", UpdateData(1, true, true)).empty());
+
+  CVariant noId;
+  noId["item"]["type"] = "movie";
+  EXPECT_TRUE(CTCPServer::GetCoalescingKey(VideoLibrary, "OnUpdate", noId).empty());
+  EXPECT_TRUE(CTCPServer::GetCoalescingKey(VideoLibrary, "OnRemove", UpdateData(1, false, false)).empty());
+}
@@ -21,6 +21,9 @@
 #include <errno.h>
 #include <stdlib.h>
 
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include "system.h"
 #include "URL.h"
@@ -32,12 +35,14 @@
 #ifdef HAS_JSONRPC
 #include "network/httprequesthandler/HTTPJsonRpcHandler.h"
 #endif // HAS_JSONRPC
+#include "settings/AdvancedSettings.h"
 #include "settings/MediaSourceSettings.h"
 #include "test/TestUtils.h"
 #include "utils/JSONVariantParser.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
+#include "utils/auto_buffer.h"
 
 using namespace XFILE;
 
@@ -50,6 +55,7 @@ using namespace XFILE;
 #define TEST_FILES_DATA_RANGES  "range1;range2;range3"
 #define TEST_FILES_HTML         TEST_FILES_DATA ".html"
 #define TEST_FILES_RANGES       TEST_FILES_DATA "-ranges.txt"
+#define TEST_FILES_BINARY       TEST_FILES_DATA ".png"
 
 class TestWebServer : public testing::Test
 {
@@ -339,6 +345,16 @@ protected:
     return StringUtils::Format("bytes=%u-%u", start, end);
   }
 
+  std::string LoadTestFile(const std::string& testFile)
+  {
+    XUTILS::auto_buffer buffer;
+    CFile file;
+    if (file.LoadFile(URIUtils::AddFileToFolder(sourcePath, testFile), buffer) <= 0)
+      return "";
+
+    return std::string(buffer.get(), buffer.size());
+  }
+
   CWebServer webserver;
   CHTTPJsonRpcHandler m_jsonRpcHandler;
   CHTTPVfsHandler m_vfsHandler;
@@ -405,6 +421,61 @@ TEST_F(TestWebServer, CanGetJsonRpcResponse)
   JSONRPC::CJSONRPC::Cleanup();
 }
 
+TEST_F(TestWebServer, CanGetJsonRpcBatchResponse)
+{
+  // initialized JSON-RPC
+  JSONRPC::CJSONRPC::Initialize();
+
+  std::string result;
+  CCurlFile curl;
+  curl.SetMimeType("application/json");
+  ASSERT_TRUE(curl.Post(GetUrl(TEST_URL_JSONRPC), "[ { \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Version\", \"id\": 1 },"
+                                                  "  { \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Ping\" },"
+                                                  "  { \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Ping\", \"id\": 2 } ]", result));
+  ASSERT_FALSE(result.empty());
+
+  // parse the JSON-RPC response which doesn't contain the notification
+  CVariant resultObj = CJSONVariantParser::Parse(reinterpret_cast<const unsigned char*>(result.c_str()), result.size());
+  ASSERT_TRUE(resultObj.isArray());
+  ASSERT_EQ(2U, resultObj.size());
+  EXPECT_EQ(1, resultObj[0]["id"].asInteger());
+  EXPECT_TRUE(resultObj[0]["result"].isObject());
+  EXPECT_EQ(2, resultObj[1]["id"].asInteger());
+  EXPECT_STREQ("pong", resultObj[1]["result"].asString().c_str());
+
+  // the response is streamed so its length isn't known up front
+  const CHttpHeader& httpHeader = curl.GetHttpHeader();
+  EXPECT_STREQ("application/json", httpHeader.GetMimeType().c_str());
+  EXPECT_TRUE(httpHeader.GetValue(MHD_HTTP_HEADER_CONTENT_LENGTH).empty());
+  EXPECT_STREQ("chunked", httpHeader.GetValue(MHD_HTTP_HEADER_TRANSFER_ENCODING).c_str());
+
+  // uninitialize JSON-RPC
+  JSONRPC::CJSONRPC::Cleanup();
+}
+
+TEST_F(TestWebServer, CanGetJsonRpcJsonpResponse)
+{
+  // initialized JSON-RPC
+  JSONRPC::CJSONRPC::Initialize();
+
+  std::string result;
+  CCurlFile curl;
+  ASSERT_TRUE(curl.Get(GetUrl(TEST_URL_JSONRPC) + "?jsonp=callback&request=" +
+                       CURL::Encode("{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Ping\", \"id\": 1 }")), result));
+
+  // the JSON-RPC response is wrapped in a call of the given callback
+  ASSERT_TRUE(StringUtils::StartsWith(result, "callback("));
+  ASSERT_TRUE(StringUtils::EndsWith(result, ");"));
+
+  std::string response = result.substr(9, result.size() - 11);
+  CVariant resultObj = CJSONVariantParser::Parse(reinterpret_cast<const unsigned char*>(response.c_str()), response.size());
+  ASSERT_TRUE(resultObj.isObject());
+  EXPECT_STREQ("pong", resultObj["result"].asString().c_str());
+
+  // uninitialize JSON-RPC
+  JSONRPC::CJSONRPC::Cleanup();
+}
+
 TEST_F(TestWebServer, CanNotHeadNonExistingFile)
 {
   CCurlFile curl;
@@ -787,4 +858,114 @@ TEST_F(TestWebServer, CanGetCachedRangedFileWithNewerIfRange)
   curl.SetRequestHeader(MHD_HTTP_HEADER_IF_RANGE, lastModifiedNewer.GetAsRFC1123DateTime());
   ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
   CheckRangesTestFileResponse(curl, result, ranges);
-}
\ No newline at end of file
+}
+
+TEST_F(TestWebServer, CanGetBinaryFile)
+{
+  // local files are sent straight from their file descriptor
+  const std::string content = LoadTestFile(TEST_FILES_BINARY);
+  ASSERT_FALSE(content.empty());
+
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, "");
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_BINARY), result));
+  EXPECT_EQ(content.size(), result.size());
+  EXPECT_TRUE(content == result);
+  EXPECT_STREQ(StringUtils::Format("%zu", content.size()).c_str(), curl.GetHttpHeader().GetValue(MHD_HTTP_HEADER_CONTENT_LENGTH).c_str());
+}
+
+TEST_F(TestWebServer, CanGetRangedBinaryFileAtOffset)
+{
+  const std::string content = LoadTestFile(TEST_FILES_BINARY);
+  ASSERT_GT(content.size(), 1100U);
+
+  // a single range is sent from the file descriptor starting at its offset
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, GenerateRangeHeaderValue(100, 1099));
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_BINARY), result));
+
+  const CHttpHeader& httpHeader = curl.GetHttpHeader();
+  EXPECT_TRUE(httpHeader.GetProtoLine().find(StringUtils::Format(" %d ", MHD_HTTP_PARTIAL_CONTENT)) != std::string::npos);
+  EXPECT_STREQ(StringUtils::Format("bytes 100-1099/%zu", content.size()).c_str(), httpHeader.GetValue(MHD_HTTP_HEADER_CONTENT_RANGE).c_str());
+  EXPECT_EQ(1000U, result.size());
+  EXPECT_TRUE(content.substr(100, 1000) == result);
+}
+
+class TestWebServerThreadPool : public TestWebServer
+{
+protected:
+  virtual void SetUp()
+  {
+    g_advancedSettings.m_webserverThreadPoolSize = 2;
+    TestWebServer::SetUp();
+  }
+
+  virtual void TearDown()
+  {
+    TestWebServer::TearDown();
+    g_advancedSettings.m_webserverThreadPoolSize = 0;
+  }
+};
+
+TEST_F(TestWebServerThreadPool, IsStarted)
+{
+  ASSERT_TRUE(webserver.IsStarted());
+}
+
+TEST_F(TestWebServerThreadPool, CanGetFile)
+{
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, "");
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_HTML), result));
+  ASSERT_STREQ(TEST_FILES_DATA, result.c_str());
+
+  CheckHtmlTestFileResponse(curl);
+}
+
+TEST_F(TestWebServerThreadPool, CanGetRangedFile)
+{
+  const std::string rangedFileContent = TEST_FILES_DATA_RANGES;
+  std::vector<std::string> rangedContent = StringUtils::Split(TEST_FILES_DATA_RANGES, ";");
+  const std::string range = GenerateRangeHeaderValue(rangedContent.front().size() + 1, rangedContent.front().size() + 1 + rangedContent.at(2).size() - 1);
+
+  CHttpRanges ranges;
+  ASSERT_TRUE(ranges.Parse(range, rangedFileContent.size()));
+
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, range);
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  CheckRangesTestFileResponse(curl, result, ranges);
+}
+
+TEST_F(TestWebServerThreadPool, ServesMoreConnectionsThanThreads)
+{
+  const std::string content = LoadTestFile(TEST_FILES_BINARY);
+  ASSERT_FALSE(content.empty());
+
+  // every client keeps its connection open for several requests
+  const int clients = 8;
+  const int requests = 4;
+  std::vector<int> received(clients, 0);
+  std::vector<std::thread> threads;
+  for (int client = 0; client < clients; ++client)
+  {
+    threads.emplace_back([&, client]() {
+      CCurlFile curl;
+      for (int request = 0; request < requests; ++request)
+      {
+        std::string result;
+        if (curl.Get(GetUrlOfTestFile(TEST_FILES_BINARY), result) && result == content)
+          received[client]++;
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  for (int client = 0; client < clients; ++client)
+    EXPECT_EQ(requests, received[client]) << "client " << client;
+}
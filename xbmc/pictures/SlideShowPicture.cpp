@@ -916,6 +916,7 @@ void CSlideShowPic::Render(float *x, float *y, CBaseTexture* pTexture, color_t c
 
   glEnd();
 #elif defined(HAS_GLES)
+  g_Windowing.FlushGUIQuads();
   if (pTexture)
   {
     pTexture->LoadToGPU();
@@ -32,6 +32,8 @@ CRenderSystemBase::CRenderSystemBase()
   m_renderCaps = 0;
   m_renderQuirks = 0;
   m_minDXTPitch = 0;
+  m_drawCalls = 0;
+  m_lastDrawCalls = 0;
 }
 
 CRenderSystemBase::~CRenderSystemBase()
@@ -147,7 +147,22 @@ public:
   unsigned int GetMinDXTPitch() const { return m_minDXTPitch; }
   unsigned int GetRenderQuirks() const { return m_renderQuirks; }
 
+  /*!
+   \brief Account for one draw call submitted by the GUI renderer
+   */
+  void CountDrawCall() { m_drawCalls++; }
+
+  /*!
+   \brief Number of GUI draw calls submitted during the last presented frame
+   */
+  unsigned int GetDrawCalls() const { return m_lastDrawCalls; }
+
 protected:
+  /*!
+   \brief Latch the draw call counter at the end of a frame
+   */
+  void LatchDrawCalls() { m_lastDrawCalls = m_drawCalls; m_drawCalls = 0; }
+
   bool                m_bRenderCreated;
   RenderingSystemType m_enumRenderingSystem;
   bool                m_bVSync;
@@ -163,6 +178,8 @@ protected:
   unsigned int m_renderQuirks;
   RENDER_STEREO_VIEW m_stereoView;
   RENDER_STEREO_MODE m_stereoMode;
+  unsigned int m_drawCalls;
+  unsigned int m_lastDrawCalls;
 };
 
 #endif // RENDER_SYSTEM_H
@@ -297,6 +297,7 @@ void CRenderSystemGL::PresentRender(bool rendered, bool videoLayer)
     return;
 
   PresentRenderImpl(rendered);
+  LatchDrawCalls();
 
   if (!rendered)
     Sleep(40);
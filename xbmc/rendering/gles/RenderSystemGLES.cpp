@@ -35,6 +35,9 @@
 #include "utils/MathUtils.h"
 #ifdef TARGET_POSIX
 #include "XTimeUtils.h"
+
+#include <cstddef>
+#include <cstring>
 #endif
 
 static const char* ShaderNames[SM_ESHADERCOUNT] =
@@ -189,6 +192,9 @@ bool CRenderSystemGLES::DestroyRenderSystem()
     m_pGUIshader = NULL;
   }
 
+  m_batchVertices.clear();
+  m_batchIndices.clear();
+
   ResetScissors();
   CDirtyRegionList dirtyRegions;
   CDirtyRegion dirtyWindow(g_graphicsContext.GetViewWindow());
@@ -216,6 +222,8 @@ bool CRenderSystemGLES::EndRender()
   if (!m_bRenderCreated)
     return false;
 
+  FlushGUIQuads();
+
   return true;
 }
 
@@ -224,6 +232,8 @@ bool CRenderSystemGLES::ClearBuffers(color_t color)
   if (!m_bRenderCreated)
     return false;
 
+  FlushGUIQuads();
+
   float r = GET_R(color) / 255.0f;
   float g = GET_G(color) / 255.0f;
   float b = GET_B(color) / 255.0f;
@@ -274,7 +284,9 @@ void CRenderSystemGLES::PresentRender(bool rendered, bool videoLayer)
   if (!m_bRenderCreated)
     return;
 
+  FlushGUIQuads();
   PresentRenderImpl(rendered);
+  LatchDrawCalls();
 
   // if video is rendered to a separate layer, we should not block this thread
   if (!rendered && !videoLayer)
@@ -315,6 +327,8 @@ void CRenderSystemGLES::CaptureStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  FlushGUIQuads();
+
   glMatrixProject.Push();
   glMatrixModview.Push();
   glMatrixTexture.Push();
@@ -330,6 +344,8 @@ void CRenderSystemGLES::ApplyStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  FlushGUIQuads();
+
   glMatrixProject.PopLoad();
   glMatrixModview.PopLoad();
   glMatrixTexture.PopLoad();
@@ -343,7 +359,9 @@ void CRenderSystemGLES::SetCameraPosition(const CPoint &camera, int screenWidth,
 { 
   if (!m_bRenderCreated)
     return;
-  
+
+  FlushGUIQuads();
+
   CPoint offset = camera - CPoint(screenWidth*0.5f, screenHeight*0.5f);
   
   float w = (float)m_viewPort[2]*0.5f;
@@ -420,6 +438,8 @@ void CRenderSystemGLES::ApplyHardwareTransform(const TransformMatrix &finalMatri
   if (!m_bRenderCreated)
     return;
 
+  FlushGUIQuads();
+
   glMatrixModview.Push();
   GLfloat matrix[4][4];
 
@@ -441,6 +461,8 @@ void CRenderSystemGLES::RestoreHardwareTransform()
   if (!m_bRenderCreated)
     return;
 
+  FlushGUIQuads();
+
   glMatrixModview.PopLoad();
 }
 
@@ -467,6 +489,8 @@ void CRenderSystemGLES::SetViewPort(CRect& viewPort)
   if (!m_bRenderCreated)
     return;
 
+  FlushGUIQuads();
+
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   m_viewPort[0] = viewPort.x1;
@@ -501,6 +525,8 @@ void CRenderSystemGLES::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+
+  FlushGUIQuads();
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
@@ -552,6 +578,8 @@ void CRenderSystemGLES::InitialiseGUIShader()
 
 void CRenderSystemGLES::EnableGUIShader(ESHADERMETHOD method)
 {
+  FlushGUIQuads();
+
   m_method = method;
   if (m_pGUIshader[m_method])
   {
@@ -572,6 +600,110 @@ void CRenderSystemGLES::DisableGUIShader()
   m_method = SM_DEFAULT;
 }
 
+bool GUIBatchState::operator==(const GUIBatchState &right) const
+{
+  return method == right.method &&
+         texture == right.texture &&
+         diffuse == right.diffuse &&
+         blend == right.blend &&
+         memcmp(color, right.color, sizeof(color)) == 0;
+}
+
+void CRenderSystemGLES::AddGUIQuads(const GUIBatchState &state, const PackedVertices &vertices)
+{
+  if (vertices.empty())
+    return;
+
+  // indices are 16 bit, so a single draw can address at most 64k vertices
+  if (!m_batchVertices.empty() &&
+      (m_batchState != state || m_batchVertices.size() + vertices.size() > 65536))
+    FlushGUIQuads();
+
+  m_batchState = state;
+  m_batchVertices.insert(m_batchVertices.end(), vertices.begin(), vertices.end());
+}
+
+void CRenderSystemGLES::FlushGUIQuads()
+{
+  if (m_batchVertices.empty())
+    return;
+
+  CGUIShader *shader = m_pGUIshader ? m_pGUIshader[m_batchState.method] : nullptr;
+  if (!shader)
+  {
+    CLog::Log(LOGERROR, "Invalid GUI Shader selected - [%s]", ShaderNames[(int)m_batchState.method]);
+    m_batchVertices.clear();
+    return;
+  }
+
+  // quads are stored as TL, TR, BR, BL, the index list only ever grows
+  size_t quads = m_batchVertices.size() / 4;
+  for (size_t i = m_batchIndices.size() / 6; i < quads; i++)
+  {
+    GLushort base = static_cast<GLushort>(i * 4);
+    m_batchIndices.push_back(base + 0);
+    m_batchIndices.push_back(base + 1);
+    m_batchIndices.push_back(base + 2);
+    m_batchIndices.push_back(base + 2);
+    m_batchIndices.push_back(base + 3);
+    m_batchIndices.push_back(base + 0);
+  }
+
+  m_method = m_batchState.method;
+  shader->Enable();
+
+  if (m_batchState.diffuse)
+  {
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, m_batchState.diffuse);
+  }
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, m_batchState.texture);
+
+  if (m_batchState.blend)
+  {
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
+    glEnable(GL_BLEND);
+  }
+  else
+  {
+    glDisable(GL_BLEND);
+  }
+
+  GLint posLoc  = shader->GetPosLoc();
+  GLint tex0Loc = shader->GetCord0Loc();
+  GLint tex1Loc = shader->GetCord1Loc();
+  GLint uniColLoc = shader->GetUniColLoc();
+
+  if (uniColLoc >= 0)
+    glUniform4fv(uniColLoc, 1, m_batchState.color);
+
+  const char *base = reinterpret_cast<const char*>(m_batchVertices.data());
+  if (m_batchState.diffuse)
+  {
+    glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), base + offsetof(PackedVertex, u2));
+    glEnableVertexAttribArray(tex1Loc);
+  }
+  glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), base + offsetof(PackedVertex, x));
+  glEnableVertexAttribArray(posLoc);
+  glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), base + offsetof(PackedVertex, u1));
+  glEnableVertexAttribArray(tex0Loc);
+
+  glDrawElements(GL_TRIANGLES, quads * 6, GL_UNSIGNED_SHORT, m_batchIndices.data());
+  CountDrawCall();
+
+  if (m_batchState.diffuse)
+    glDisableVertexAttribArray(tex1Loc);
+  glDisableVertexAttribArray(posLoc);
+  glDisableVertexAttribArray(tex0Loc);
+
+  glEnable(GL_BLEND);
+  shader->Disable();
+  m_method = SM_DEFAULT;
+
+  m_batchVertices.clear();
+}
+
 GLint CRenderSystemGLES::GUIShaderGetPos()
 {
   if (m_pGUIshader[m_method])
@@ -28,6 +28,8 @@
 #include "rendering/RenderSystem.h"
 #include "xbmc/guilib/GUIShader.h"
 
+#include <vector>
+
 enum ESHADERMETHOD
 {
   SM_DEFAULT,
@@ -44,6 +46,29 @@ enum ESHADERMETHOD
   SM_ESHADERCOUNT
 };
 
+struct PackedVertex
+{
+  float x, y, z;
+  float u1, v1;
+  float u2, v2;
+};
+typedef std::vector<PackedVertex> PackedVertices;
+
+/*!
+ \brief State shared by all quads of a GUI draw batch
+ */
+struct GUIBatchState
+{
+  ESHADERMETHOD method;
+  GLuint texture;
+  GLuint diffuse;
+  bool blend;
+  GLfloat color[4];
+
+  bool operator==(const GUIBatchState &right) const;
+  bool operator!=(const GUIBatchState &right) const { return !(*this == right); }
+};
+
 class CRenderSystemGLES : public CRenderSystemBase
 {
 public:
@@ -88,6 +113,21 @@ public:
   void EnableGUIShader(ESHADERMETHOD method);
   void DisableGUIShader();
 
+  /*!
+   \brief Queue textured quads for drawing with the given state
+   Consecutive quads sharing shader, textures, blending and colour are merged
+   and submitted with a single draw call by FlushGUIQuads(). Anything that
+   changes GL state outside of the batch must flush it first.
+   \param state shader, textures, blending and colour of the quads
+   \param vertices four vertices per quad in TL, TR, BR, BL order
+   */
+  void AddGUIQuads(const GUIBatchState &state, const PackedVertices &vertices);
+
+  /*!
+   \brief Submit all queued GUI quads to the GPU
+   */
+  void FlushGUIQuads();
+
   GLint GUIShaderGetPos();
   GLint GUIShaderGetCol();
   GLint GUIShaderGetCoord0();
@@ -117,6 +157,10 @@ protected:
   ESHADERMETHOD m_method = SM_DEFAULT; // Current GUI Shader method
 
   GLint      m_viewPort[4];
+
+  GUIBatchState m_batchState;
+  PackedVertices m_batchVertices;
+  std::vector<GLushort> m_batchIndices;
 };
 
 #endif // RENDER_SYSTEM_H
@@ -371,6 +371,10 @@ void CAdvancedSettings::Initialize()
 #endif
 
   m_cacheBufferMode = CACHE_BUFFER_MODE_INTERNET; // Default (buffer all internet streams/filesystems)
+  m_cacheBlocks = false; // keep read blocks of seekable audio/video files cached after seeking
+
+  m_dirCacheMemorySize = 1024 * 1024 * 16;
+  m_dirCacheDiskSize = 1024 * 1024 * 64;
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_cacheReadFactor = 4.0f;
@@ -379,6 +383,10 @@ void CAdvancedSettings::Initialize()
 
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
+  m_jsonNotificationWindow = 0;
+  m_jsonBatchNotifications = false;
+
+  m_webserverThreadPoolSize = 0;
 
   m_enableMultimediaKeys = false;
 
@@ -389,12 +397,18 @@ void CAdvancedSettings::Initialize()
 #endif
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 3;
+  m_guiTextureAtlas = false; // pages are 2048x2048 and only freed with their last image
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
 
   m_databaseMusic.Reset();
   m_databaseVideo.Reset();
 
+  m_sqliteWAL = false;
+  m_sqliteCacheSize = 0;
+  m_sqliteMmapSize = 0;
+  m_sqlitePoolSize = 0;
+
   m_pictureExtensions = ".png|.jpg|.jpeg|.bmp|.gif|.ico|.tif|.tiff|.tga|.pcx|.cbz|.zip|.cbr|.rar|.rss|.webp|.jp2|.apng";
   m_musicExtensions = ".nsv|.m4a|.flac|.aac|.strm|.pls|.rm|.rma|.mpa|.wav|.wma|.ogg|.mp3|.mp2|.m3u|.gdm|.imf|.m15|.sfx|.uni|.ac3|.dts|.cue|.aif|.aiff|.wpl|.ape|.mac|.mpc|.mp+|.mpp|.shn|.zip|.rar|.wv|.dsp|.xsp|.xwav|.waa|.wvs|.wam|.gcm|.idsp|.mpdsp|.mss|.spt|.rsd|.sap|.cmc|.cmr|.dmc|.mpt|.mpd|.rmt|.tmc|.tm8|.tm2|.oga|.url|.pxml|.tta|.rss|.wtv|.mka|.tak|.opus|.dff|.dsf|.m4b";
   m_videoExtensions = ".m4v|.3g2|.3gp|.nsv|.tp|.ts|.ty|.strm|.pls|.rm|.rmvb|.mpd|.m3u|.m3u8|.ifo|.mov|.qt|.divx|.xvid|.bivx|.vob|.nrg|.img|.iso|.pva|.wmv|.asf|.asx|.ogm|.m2v|.avi|.bin|.dat|.mpg|.mpeg|.mp4|.mkv|.mk3d|.avc|.vp3|.svq3|.nuv|.viv|.dv|.fli|.flv|.rar|.001|.wpl|.zip|.vdr|.dvr-ms|.xsp|.mts|.m2t|.m2ts|.evo|.ogv|.sdp|.avs|.rec|.url|.pxml|.vc1|.h264|.rcv|.rss|.mpls|.webm|.bdmv|.wtv|.ssif";
@@ -819,6 +833,14 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "memorysize", m_cacheMemSize);
     XMLUtils::GetUInt(pElement, "buffermode", m_cacheBufferMode, 0, 4);
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
+    XMLUtils::GetBoolean(pElement, "blockcache", m_cacheBlocks);
+  }
+
+  pElement = pRootElement->FirstChildElement("directorycache");
+  if (pElement)
+  {
+    XMLUtils::GetUInt(pElement, "memorysize", m_dirCacheMemorySize);
+    XMLUtils::GetUInt(pElement, "disksize", m_dirCacheDiskSize);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -826,8 +848,14 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   {
     XMLUtils::GetBoolean(pElement, "compactoutput", m_jsonOutputCompact);
     XMLUtils::GetUInt(pElement, "tcpport", m_jsonTcpPort);
+    XMLUtils::GetUInt(pElement, "notificationwindow", m_jsonNotificationWindow, 0, 5000);
+    XMLUtils::GetBoolean(pElement, "batchnotifications", m_jsonBatchNotifications);
   }
 
+  pElement = pRootElement->FirstChildElement("webserver");
+  if (pElement)
+    XMLUtils::GetUInt(pElement, "threadpoolsize", m_webserverThreadPoolSize, 0, 64);
+
   pElement = pRootElement->FirstChildElement("samba");
   if (pElement)
   {
@@ -1199,6 +1227,15 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pDatabase, "compression", m_databaseSavestates.compression);
   }
 
+  pElement = pRootElement->FirstChildElement("sqlite");
+  if (pElement)
+  {
+    XMLUtils::GetBoolean(pElement, "wal", m_sqliteWAL);
+    XMLUtils::GetInt(pElement, "cachesize", m_sqliteCacheSize, 0, 1048576);
+    XMLUtils::GetInt(pElement, "mmapsize", m_sqliteMmapSize, 0, 2097152);
+    XMLUtils::GetInt(pElement, "poolsize", m_sqlitePoolSize, 0, 16);
+  }
+
   pElement = pRootElement->FirstChildElement("enablemultimediakeys");
   if (pElement)
   {
@@ -1210,6 +1247,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   {
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
+    XMLUtils::GetBoolean(pElement, "textureatlas", m_guiTextureAtlas);
   }
 
   std::string seekSteps;
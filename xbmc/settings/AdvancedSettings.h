@@ -340,18 +340,32 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     DatabaseSettings m_databaseADSP;  /*!< advanced audio dsp database setup */
     DatabaseSettings m_databaseSavestates; /*!< advanced savestate database setup */
 
+    bool m_sqliteWAL;      /*!< use write-ahead logging for the local sqlite databases, not safe on network shares */
+    int m_sqliteCacheSize; /*!< page cache of each sqlite connection in KiB, 0 keeps 4096 pages */
+    int m_sqliteMmapSize;  /*!< memory mapped I/O of each sqlite connection in KiB, 0 disables it */
+    int m_sqlitePoolSize;  /*!< idle sqlite connections kept open for reuse per database file, 0 disables pooling */
+
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
+    bool m_guiTextureAtlas;
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemSize;
     unsigned int m_cacheBufferMode;
     float m_cacheReadFactor;
+    bool m_cacheBlocks;
+
+    unsigned int m_dirCacheMemorySize;
+    unsigned int m_dirCacheDiskSize;
 
     unsigned int m_libAssCache;
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
+    unsigned int m_jsonNotificationWindow;
+    bool m_jsonBatchNotifications;
+
+    unsigned int m_webserverThreadPoolSize;
 
     bool m_enableMultimediaKeys;
     std::vector<std::string> m_settingsFiles;
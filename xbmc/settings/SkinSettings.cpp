@@ -60,6 +60,8 @@ const std::string& CSkinSettings::GetString(int setting) const
 void CSkinSettings::SetString(int setting, const std::string &label)
 {
   g_SkinInfo->SetString(setting, label);
+
+  g_infoManager.ResetCache();
 }
 
 int CSkinSettings::TranslateBool(const std::string &setting)
@@ -75,11 +77,15 @@ bool CSkinSettings::GetBool(int setting) const
 void CSkinSettings::SetBool(int setting, bool set)
 {
   g_SkinInfo->SetBool(setting, set);
+
+  g_infoManager.ResetCache();
 }
 
 void CSkinSettings::Reset(const std::string &setting)
 {
   g_SkinInfo->Reset(setting);
+
+  g_infoManager.ResetCache();
 }
 
 void CSkinSettings::Reset()
@@ -65,19 +65,21 @@ CVariant CJSONVariantParser::Parse(const std::string& json)
 CVariant CJSONVariantParser::Parse(const unsigned char *json, unsigned int length)
 {
   CSimpleParseCallback callback;
-  CJSONVariantParser parser(&callback);
-
-  parser.push_buffer(json, length);
+  {
+    // yajl only knows that a top-level number has ended once parsing has been
+    // completed, which happens when the parser is destroyed
+    CJSONVariantParser parser(&callback);
+    parser.push_buffer(json, length);
+  }
 
-  return callback.GetOutput();
+  return std::move(callback.GetOutput());
 }
 
 int CJSONVariantParser::ParseNull(void * ctx)
 {
   CJSONVariantParser *parser = (CJSONVariantParser *)ctx;
 
-  parser->PushObject(CVariant::VariantTypeNull);
-  parser->PopObject();
+  parser->AddValue(CVariant::VariantTypeNull);
 
   return 1;
 }
@@ -86,8 +88,7 @@ int CJSONVariantParser::ParseBoolean(void * ctx, int boolean)
 {
   CJSONVariantParser *parser = (CJSONVariantParser *)ctx;
 
-  parser->PushObject(CVariant(boolean != 0));
-  parser->PopObject();
+  parser->AddValue(CVariant(boolean != 0));
 
   return 1;
 }
@@ -96,8 +97,7 @@ int CJSONVariantParser::ParseInteger(void * ctx, long long integerVal)
 {
   CJSONVariantParser *parser = (CJSONVariantParser *)ctx;
 
-  parser->PushObject(CVariant((int64_t)integerVal));
-  parser->PopObject();
+  parser->AddValue(CVariant((int64_t)integerVal));
 
   return 1;
 }
@@ -106,8 +106,7 @@ int CJSONVariantParser::ParseDouble(void * ctx, double doubleVal)
 {
   CJSONVariantParser *parser = (CJSONVariantParser *)ctx;
 
-  parser->PushObject(CVariant((float)doubleVal));
-  parser->PopObject();
+  parser->AddValue(CVariant((float)doubleVal));
 
   return 1;
 }
@@ -116,8 +115,7 @@ int CJSONVariantParser::ParseString(void * ctx, const unsigned char * stringVal,
 {
   CJSONVariantParser *parser = (CJSONVariantParser *)ctx;
 
-  parser->PushObject(CVariant((const char *)stringVal, stringLen));
-  parser->PopObject();
+  parser->AddValue(CVariant((const char *)stringVal, stringLen));
 
   return 1;
 }
@@ -135,7 +133,7 @@ int CJSONVariantParser::ParseMapKey(void * ctx, const unsigned char * stringVal,
 {
   CJSONVariantParser *parser = (CJSONVariantParser *)ctx;
 
-  parser->m_key = std::string((const char *)stringVal, 0, stringLen);
+  parser->m_key.assign((const char *)stringVal, stringLen);
 
   return 1;
 }
@@ -167,32 +165,49 @@ int CJSONVariantParser::ParseArrayEnd(void * ctx)
   return 1;
 }
 
-void CJSONVariantParser::PushObject(CVariant variant)
+void CJSONVariantParser::PushObject(CVariant &&variant)
 {
+  CVariant::VariantType type = variant.type();
+
   if (m_status == ParseObject)
   {
-    (*m_parse[m_parse.size() - 1])[m_key] = variant;
-    m_parse.push_back(&(*m_parse[m_parse.size() - 1])[m_key]);
+    CVariant &member = (*m_parse.back())[m_key];
+    member = std::move(variant);
+    m_parse.push_back(&member);
   }
   else if (m_status == ParseArray)
   {
-    CVariant *temp = m_parse[m_parse.size() - 1];
-    temp->push_back(variant);
+    CVariant *temp = m_parse.back();
+    temp->push_back(std::move(variant));
     m_parse.push_back(&(*temp)[temp->size() - 1]);
   }
   else if (m_parse.empty())
   {
-    m_parse.push_back(new CVariant(variant));
+    m_parse.push_back(new CVariant(std::move(variant)));
   }
 
-  if (variant.isObject())
+  if (type == CVariant::VariantTypeObject)
     m_status = ParseObject;
-  else if (variant.isArray())
+  else if (type == CVariant::VariantTypeArray)
     m_status = ParseArray;
   else
     m_status = ParseVariable;
 }
 
+void CJSONVariantParser::AddValue(CVariant &&variant)
+{
+  // scalar values can be stored in their container right away
+  if (m_status == ParseObject)
+    (*m_parse.back())[m_key] = std::move(variant);
+  else if (m_status == ParseArray)
+    m_parse.back()->push_back(std::move(variant));
+  else
+  {
+    PushObject(std::move(variant));
+    PopObject();
+  }
+}
+
 void CJSONVariantParser::PopObject()
 {
   CVariant *variant = m_parse[m_parse.size() - 1];
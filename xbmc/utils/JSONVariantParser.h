@@ -37,7 +37,7 @@ public:
 class CSimpleParseCallback : public IParseCallback
 {
 public:
-  virtual void onParsed(CVariant *variant) { m_parsed = *variant; }
+  virtual void onParsed(CVariant *variant) { m_parsed = std::move(*variant); }
   CVariant &GetOutput() { return m_parsed; }
 
 private:
@@ -68,8 +68,9 @@ private:
   static int ParseArrayStart(void * ctx);
   static int ParseArrayEnd(void * ctx);
 
-  void PushObject(CVariant variant);
+  void PushObject(CVariant &&variant);
   void PopObject();
+  void AddValue(CVariant &&variant);
 
   static yajl_callbacks callbacks;
 
@@ -18,88 +18,165 @@
  *
  */
 
+#include <algorithm>
+#include <cstring>
 #include <locale>
 
 #include "JSONVariantWriter.h"
-#include "utils/Variant.h"
 
-std::string CJSONVariantWriter::Write(const CVariant &value, bool compact)
+#define STREAM_CHUNK_SIZE (64 * 1024)
+
+namespace
 {
-  std::string output;
+// Sets the locale to classic ("C") to ensure valid JSON numbers while yajl
+// is used and restores the previous one afterwards
+class CClassicNumericLocale
+{
+public:
+  CClassicNumericLocale()
+  {
+#ifndef TARGET_WINDOWS
+    const char *currentLocale = setlocale(LC_NUMERIC, NULL);
+    if (currentLocale != NULL && (currentLocale[0] != 'C' || currentLocale[1] != 0))
+    {
+      m_backupLocale = currentLocale;
+      setlocale(LC_NUMERIC, "C");
+    }
+#else  // TARGET_WINDOWS
+    const wchar_t* const currentLocale = _wsetlocale(LC_NUMERIC, NULL);
+    if (currentLocale != NULL && (currentLocale[0] != L'C' || currentLocale[1] != 0))
+    {
+      m_backupLocale = currentLocale;
+      _wsetlocale(LC_NUMERIC, L"C");
+    }
+#endif // TARGET_WINDOWS
+  }
+
+  ~CClassicNumericLocale()
+  {
+#ifndef TARGET_WINDOWS
+    if (!m_backupLocale.empty())
+      setlocale(LC_NUMERIC, m_backupLocale.c_str());
+#else  // TARGET_WINDOWS
+    if (!m_backupLocale.empty())
+      _wsetlocale(LC_NUMERIC, m_backupLocale.c_str());
+#endif // TARGET_WINDOWS
+  }
+
+private:
+#ifndef TARGET_WINDOWS
+  std::string m_backupLocale;
+#else  // TARGET_WINDOWS
+  std::wstring m_backupLocale;
+#endif // TARGET_WINDOWS
+};
 
+yajl_gen CreateGenerator(bool compact)
+{
   yajl_gen g = yajl_gen_alloc(NULL);
   yajl_gen_config(g, yajl_gen_beautify, compact ? 0 : 1);
   yajl_gen_config(g, yajl_gen_indent_string, "\t");
 
-  // Set locale to classic ("C") to ensure valid JSON numbers
-#ifndef TARGET_WINDOWS
-  const char *currentLocale = setlocale(LC_NUMERIC, NULL);
-  std::string backupLocale;
-  if (currentLocale != NULL && (currentLocale[0] != 'C' || currentLocale[1] != 0))
+  return g;
+}
+
+bool WriteScalar(yajl_gen g, const CVariant &value)
+{
+  switch (value.type())
   {
-    backupLocale = currentLocale;
-    setlocale(LC_NUMERIC, "C");
+  case CVariant::VariantTypeInteger:
+    return yajl_gen_status_ok == yajl_gen_integer(g, (long long int)value.asInteger());
+  case CVariant::VariantTypeUnsignedInteger:
+    return yajl_gen_status_ok == yajl_gen_integer(g, (long long int)value.asUnsignedInteger());
+  case CVariant::VariantTypeDouble:
+    return yajl_gen_status_ok == yajl_gen_double(g, value.asDouble());
+  case CVariant::VariantTypeBoolean:
+    return yajl_gen_status_ok == yajl_gen_bool(g, value.asBoolean() ? 1 : 0);
+  case CVariant::VariantTypeString:
+    return yajl_gen_status_ok == yajl_gen_string(g, (const unsigned char*)value.c_str(), (size_t)value.size());
+  case CVariant::VariantTypeConstNull:
+  case CVariant::VariantTypeNull:
+  default:
+    return yajl_gen_status_ok == yajl_gen_null(g);
   }
-#else  // TARGET_WINDOWS
-  const wchar_t* const currentLocale = _wsetlocale(LC_NUMERIC, NULL);
-  std::wstring backupLocale;
-  if (currentLocale != NULL && (currentLocale[0] != L'C' || currentLocale[1] != 0))
+}
+}
+
+std::string CJSONVariantWriter::Write(const CVariant &value, bool compact)
+{
+  std::string output;
+
+  yajl_gen g = CreateGenerator(compact);
+
   {
-    backupLocale = currentLocale;
-    _wsetlocale(LC_NUMERIC, L"C");
+    CClassicNumericLocale locale;
+
+    if (InternalWrite(g, value))
+    {
+      const unsigned char * buffer;
+
+      size_t length;
+      yajl_gen_get_buf(g, &buffer, &length);
+      output = std::string((const char *)buffer, length);
+    }
   }
-#endif // TARGET_WINDOWS
 
-  if (InternalWrite(g, value))
+  yajl_gen_clear(g);
+  yajl_gen_free(g);
+
+  return output;
+}
+
+bool CJSONVariantWriter::Write(const CVariant &value, const StreamCallback &callback, bool compact)
+{
+  bool success;
+
+  yajl_gen g = CreateGenerator(compact);
+
   {
-    const unsigned char * buffer;
+    CClassicNumericLocale locale;
 
-    size_t length;
-    yajl_gen_get_buf(g, &buffer, &length);
-    output = std::string((const char *)buffer, length);
+    success = InternalWrite(g, value, &callback) && Flush(g, &callback, true);
   }
 
-  // Re-set locale to what it was before using yajl
-#ifndef TARGET_WINDOWS
-  if (!backupLocale.empty())
-    setlocale(LC_NUMERIC, backupLocale.c_str());
-#else  // TARGET_WINDOWS
-  if (!backupLocale.empty())
-    _wsetlocale(LC_NUMERIC, backupLocale.c_str());
-#endif // TARGET_WINDOWS
-
   yajl_gen_clear(g);
   yajl_gen_free(g);
 
-  return output;
+  return success;
+}
+
+bool CJSONVariantWriter::Flush(yajl_gen g, const StreamCallback *callback, bool force)
+{
+  if (callback == nullptr)
+    return true;
+
+  const unsigned char *buffer;
+  size_t length;
+  if (yajl_gen_get_buf(g, &buffer, &length) != yajl_gen_status_ok)
+    return false;
+
+  // hand out the generated output in chunks to keep yajl's buffer small
+  if (length == 0 || (!force && length < STREAM_CHUNK_SIZE))
+    return true;
+
+  if (!(*callback)(reinterpret_cast<const char*>(buffer), length))
+    return false;
+
+  yajl_gen_clear(g);
+  return true;
 }
 
-bool CJSONVariantWriter::InternalWrite(yajl_gen g, const CVariant &value)
+bool CJSONVariantWriter::InternalWrite(yajl_gen g, const CVariant &value, const StreamCallback *callback /* = nullptr */)
 {
   bool success = false;
 
   switch (value.type())
   {
-  case CVariant::VariantTypeInteger:
-    success = yajl_gen_status_ok == yajl_gen_integer(g, (long long int)value.asInteger());
-    break;
-  case CVariant::VariantTypeUnsignedInteger:
-    success = yajl_gen_status_ok == yajl_gen_integer(g, (long long int)value.asUnsignedInteger());
-    break;
-  case CVariant::VariantTypeDouble:
-    success = yajl_gen_status_ok == yajl_gen_double(g, value.asDouble());
-    break;
-  case CVariant::VariantTypeBoolean:
-    success = yajl_gen_status_ok == yajl_gen_bool(g, value.asBoolean() ? 1 : 0);
-    break;
-  case CVariant::VariantTypeString:
-    success = yajl_gen_status_ok == yajl_gen_string(g, (const unsigned char*)value.c_str(), (size_t)value.size());
-    break;
   case CVariant::VariantTypeArray:
     success = yajl_gen_status_ok == yajl_gen_array_open(g);
 
     for (CVariant::const_iterator_array itr = value.begin_array(); itr != value.end_array() && success; ++itr)
-      success &= InternalWrite(g, *itr);
+      success &= InternalWrite(g, *itr, callback) && Flush(g, callback, false);
 
     if (success)
       success = yajl_gen_status_ok == yajl_gen_array_close(g);
@@ -112,19 +189,116 @@ bool CJSONVariantWriter::InternalWrite(yajl_gen g, const CVariant &value)
     {
       success &= yajl_gen_status_ok == yajl_gen_string(g, (const unsigned char*)itr->first.c_str(), (size_t)itr->first.length());
       if (success)
-        success &= InternalWrite(g, itr->second);
+        success &= InternalWrite(g, itr->second, callback) && Flush(g, callback, false);
     }
 
     if (success)
       success &= yajl_gen_status_ok == yajl_gen_map_close(g);
 
     break;
-  case CVariant::VariantTypeConstNull:
-  case CVariant::VariantTypeNull:
   default:
-    success = yajl_gen_status_ok == yajl_gen_null(g);
+    success = WriteScalar(g, value);
     break;
   }
 
   return success;
 }
+
+CJSONVariantStreamWriter::CJSONVariantStreamWriter(const CVariant &value, bool compact)
+  : m_generator(CreateGenerator(compact)),
+    m_value(&value),
+    m_offset(0)
+{ }
+
+CJSONVariantStreamWriter::~CJSONVariantStreamWriter()
+{
+  yajl_gen_clear(m_generator);
+  yajl_gen_free(m_generator);
+}
+
+bool CJSONVariantStreamWriter::Write(char *buffer, size_t size, size_t &written)
+{
+  written = 0;
+
+  CClassicNumericLocale locale;
+
+  while (written < size)
+  {
+    const unsigned char *data;
+    size_t length;
+    if (yajl_gen_get_buf(m_generator, &data, &length) != yajl_gen_status_ok)
+      return false;
+
+    // hand out what has been generated but not written yet
+    if (m_offset < length)
+    {
+      size_t count = std::min(size - written, length - m_offset);
+      memcpy(buffer + written, data + m_offset, count);
+      written += count;
+      m_offset += count;
+      continue;
+    }
+
+    yajl_gen_clear(m_generator);
+    m_offset = 0;
+
+    if (m_value == nullptr && m_containers.empty())
+      break;
+
+    if (!WriteNext())
+      return false;
+  }
+
+  return true;
+}
+
+bool CJSONVariantStreamWriter::WriteNext()
+{
+  // start the next value, either the root value or the next item of the
+  // innermost container
+  const CVariant *value = m_value;
+  m_value = nullptr;
+
+  if (value == nullptr)
+  {
+    Container &container = m_containers.back();
+    if (container.value->isArray())
+    {
+      if (container.arrayItr == container.value->end_array())
+      {
+        m_containers.pop_back();
+        return yajl_gen_status_ok == yajl_gen_array_close(m_generator);
+      }
+
+      value = &*container.arrayItr++;
+    }
+    else
+    {
+      if (container.mapItr == container.value->end_map())
+      {
+        m_containers.pop_back();
+        return yajl_gen_status_ok == yajl_gen_map_close(m_generator);
+      }
+
+      const std::string &key = container.mapItr->first;
+      if (yajl_gen_status_ok != yajl_gen_string(m_generator, (const unsigned char*)key.c_str(), key.length()))
+        return false;
+
+      value = &(container.mapItr++)->second;
+    }
+  }
+
+  if (value->isArray())
+  {
+    m_containers.push_back({ value, value->begin_array(), CVariant::const_iterator_map() });
+    return yajl_gen_status_ok == yajl_gen_array_open(m_generator);
+  }
+
+  if (value->isObject())
+  {
+    m_containers.push_back({ value, CVariant::const_iterator_array(), value->begin_map() });
+    return yajl_gen_status_ok == yajl_gen_map_open(m_generator);
+  }
+
+  return WriteScalar(m_generator, *value);
+}
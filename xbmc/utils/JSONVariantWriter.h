@@ -20,14 +20,76 @@
  */
 
 #include <yajl/yajl_gen.h>
+#include <functional>
 #include <string>
+#include <vector>
 
-class CVariant;
+#include "utils/Variant.h"
 
 class CJSONVariantWriter
 {
 public:
+  /*!
+   \brief Receives consecutive chunks of serialized JSON
+   \return false to abort writing
+   */
+  typedef std::function<bool(const char *data, size_t length)> StreamCallback;
+
   static std::string Write(const CVariant &value, bool compact);
+
+  /*!
+   \brief Serializes the given value and hands the output to the callback in
+   chunks instead of building the whole document in memory
+   \param value Value to serialize
+   \param callback Callback receiving the serialized chunks
+   \param compact Whether to omit whitespace and indentation
+   \return true if the complete value was written, false otherwise
+   */
+  static bool Write(const CVariant &value, const StreamCallback &callback, bool compact);
+
 private:
-  static bool InternalWrite(yajl_gen g, const CVariant &value);
+  static bool InternalWrite(yajl_gen g, const CVariant &value, const StreamCallback *callback = nullptr);
+  static bool Flush(yajl_gen g, const StreamCallback *callback, bool force);
+};
+
+/*!
+ \brief Serializes a value piece by piece into buffers provided by the caller
+
+ Unlike CJSONVariantWriter::Write() the caller pulls the output whenever it
+ is ready to take more, e.g. the webserver while sending the response.
+ The value must stay unchanged until the writer is done.
+ */
+class CJSONVariantStreamWriter
+{
+public:
+  CJSONVariantStreamWriter(const CVariant &value, bool compact);
+  ~CJSONVariantStreamWriter();
+
+  /*!
+   \brief Writes the next part of the serialized value
+   \param buffer Buffer to write to
+   \param size Size of the buffer
+   \param written Receives the number of bytes written, 0 once the whole value has been written
+   \return false if serializing the value failed, true otherwise
+   */
+  bool Write(char *buffer, size_t size, size_t &written);
+
+private:
+  CJSONVariantStreamWriter(const CJSONVariantStreamWriter&) = delete;
+  CJSONVariantStreamWriter& operator=(const CJSONVariantStreamWriter&) = delete;
+
+  bool WriteNext();
+
+  // an array or object which is currently being serialized
+  struct Container
+  {
+    const CVariant *value;
+    CVariant::const_iterator_array arrayItr;
+    CVariant::const_iterator_map mapItr;
+  };
+
+  yajl_gen m_generator;
+  const CVariant *m_value;
+  std::vector<Container> m_containers;
+  size_t m_offset;
 };
@@ -23,13 +23,19 @@
 #include <functional>
 #include <stdexcept>
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
+#include "utils/TraceProfiler.h"
 #ifdef TARGET_POSIX
 #include "linux/XTimeUtils.h"
 #endif
 
 #include "system.h"
 
+// jobs that have been waiting this long are promoted by one priority level, so that a constant
+// stream of higher priority work (e.g. a library scan) can't starve them indefinitely.
+static const unsigned int JOB_STARVATION_TIMEOUT_MS = 10000;
+
 bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
 {
   if (m_callback)
@@ -66,6 +72,7 @@ void CJobWorker::Process()
     bool success = false;
     try
     {
+      TRACE_SCOPE(*job->GetType() ? job->GetType() : "CJob::DoWork");
       success = job->DoWork();
     }
     catch (...)
@@ -184,6 +191,11 @@ CJobManager::CJobManager()
   m_jobCounter = 0;
   m_running = true;
   m_pauseJobs = false;
+  m_starvationTimeout = JOB_STARVATION_TIMEOUT_MS;
+
+  // these jobs hit the disk/network hard, don't let them occupy every worker
+  m_typeLimits[kJobTypeMediaFlags] = 1;
+  m_typeLimits[kJobTypeDDSCompress] = 1;
 }
 
 void CJobManager::Restart()
@@ -238,6 +250,7 @@ unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORI
 
   // create a work item for this job
   CWorkItem work(job, m_jobCounter, priority, callback);
+  work.m_queued = XbmcThreads::SystemClockMillis();
   m_jobQueue[priority].push_back(work);
 
   StartWorkers(priority);
@@ -284,9 +297,65 @@ void CJobManager::StartWorkers(CJob::PRIORITY priority)
   m_workers.push_back(new CJobWorker(this));
 }
 
+CJobManager::JobQueue::iterator CJobManager::FindRunnableJob(JobQueue &queue)
+{
+  if (m_typeLimits.empty())
+    return queue.begin();
+
+  for (JobQueue::iterator it = queue.begin(); it != queue.end(); ++it)
+  {
+    TypeCounts::const_iterator limit = m_typeLimits.find(it->m_job->GetType());
+    if (limit == m_typeLimits.end() || m_typeProcessing[limit->first] < limit->second)
+      return it;
+  }
+  return queue.end();
+}
+
+CJob *CJobManager::StartJob(JobQueue &queue, JobQueue::iterator it)
+{
+  // pop the job off the queue
+  CWorkItem job = *it;
+  queue.erase(it);
+
+  // account for limited job types
+  std::string type = job.m_job->GetType();
+  if (m_typeLimits.find(type) != m_typeLimits.end())
+    m_typeProcessing[type]++;
+
+  // add to the processing vector
+  m_processing.push_back(job);
+  job.m_job->m_callback = this;
+  return job.m_job;
+}
+
+void CJobManager::PromoteStarvedJobs()
+{
+  // move jobs that have been waiting too long up a single level, to the back of the next
+  // queue, so they still only run when no job of their new priority is ahead of them.
+  // a promoted job counts as a job of its new priority from then on, both for the
+  // worker limits and IsProcessing().
+  // pausable jobs are left alone, so pausing them keeps them out of the way.
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  for (int priority = CJob::PRIORITY_NORMAL; priority >= CJob::PRIORITY_LOW; --priority)
+  {
+    JobQueue &queue = m_jobQueue[priority];
+    while (!queue.empty() && now - queue.front().m_queued >= m_starvationTimeout)
+    {
+      CWorkItem work = queue.front();
+      queue.pop_front();
+      work.m_queued = now;
+      work.m_priority = CJob::PRIORITY(priority + 1);
+      m_jobQueue[priority + 1].push_back(work);
+    }
+  }
+}
+
 CJob *CJobManager::PopJob()
 {
   CSingleLock lock(m_section);
+
+  PromoteStarvedJobs();
+
   for (int priority = CJob::PRIORITY_DEDICATED; priority >= CJob::PRIORITY_LOW_PAUSABLE; --priority)
   {
     // Check whether we're pausing pausable jobs
@@ -295,19 +364,20 @@ CJob *CJobManager::PopJob()
 
     if (m_jobQueue[priority].size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
     {
-      // pop the job off the queue
-      CWorkItem job = m_jobQueue[priority].front();
-      m_jobQueue[priority].pop_front();
-
-      // add to the processing vector
-      m_processing.push_back(job);
-      job.m_job->m_callback = this;
-      return job.m_job;
+      JobQueue::iterator it = FindRunnableJob(m_jobQueue[priority]);
+      if (it != m_jobQueue[priority].end())
+        return StartJob(m_jobQueue[priority], it);
     }
   }
   return NULL;
 }
 
+void CJobManager::SetStarvationTimeout(unsigned int timeout)
+{
+  CSingleLock lock(m_section);
+  m_starvationTimeout = timeout;
+}
+
 void CJobManager::PauseJobs()
 {
   CSingleLock lock(m_section);
@@ -320,6 +390,39 @@ void CJobManager::UnPauseJobs()
   m_pauseJobs = false;
 }
 
+void CJobManager::SetMaxConcurrentJobs(const std::string &type, unsigned int maxJobs)
+{
+  CSingleLock lock(m_section);
+  if (maxJobs)
+    m_typeLimits[type] = maxJobs;
+  else
+    m_typeLimits.erase(type);
+
+  // recount the jobs of this type that are already processing
+  unsigned int processing = 0;
+  for (Processing::const_iterator it = m_processing.begin(); it != m_processing.end(); ++it)
+  {
+    if (type == it->m_job->GetType())
+      processing++;
+  }
+  if (maxJobs)
+    m_typeProcessing[type] = processing;
+  else
+    m_typeProcessing.erase(type);
+
+  // the new limit may allow queued jobs to be picked up
+  m_jobEvent.Set();
+}
+
+unsigned int CJobManager::GetMaxConcurrentJobs(const std::string &type) const
+{
+  CSingleLock lock(m_section);
+  TypeCounts::const_iterator it = m_typeLimits.find(type);
+  if (it != m_typeLimits.end())
+    return it->second;
+  return 0;
+}
+
 bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
 {
   CSingleLock lock(m_section);
@@ -417,8 +520,17 @@ void CJobManager::OnJobComplete(bool success, CJob *job)
     lock.Enter();
     Processing::iterator j = find(m_processing.begin(), m_processing.end(), job);
     if (j != m_processing.end())
+    {
+      TypeCounts::iterator count = m_typeProcessing.find(item.m_job->GetType());
+      if (count != m_typeProcessing.end() && count->second > 0)
+        count->second--;
       m_processing.erase(j);
+    }
+    bool wakeWorker = !m_typeLimits.empty();
     lock.Leave();
+    // a job of a limited type may be waiting for this one to finish
+    if (wakeWorker)
+      m_jobEvent.Set();
     item.FreeJob();
   }
 }
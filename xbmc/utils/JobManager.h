@@ -19,6 +19,7 @@
  *
  */
 
+#include <map>
 #include <queue>
 #include <vector>
 #include <string>
@@ -183,6 +184,7 @@ class CJobManager
       m_id = id;
       m_callback = callback;
       m_priority = priority;
+      m_queued = 0;
     }
     bool operator==(unsigned int jobID) const
     {
@@ -205,6 +207,7 @@ class CJobManager
     unsigned int  m_id;
     IJobCallback *m_callback;
     CJob::PRIORITY m_priority;
+    unsigned int  m_queued; ///< time (in ms) at which the job was queued, used for aging
   };
 
   template<typename F>
@@ -297,6 +300,32 @@ public:
    */
   bool IsProcessing(const CJob::PRIORITY &priority) const;
 
+  /*!
+   \brief Limit the number of jobs of a specific type that may be processed at once.
+   Queued jobs of a type that has reached its limit are skipped over, so that other jobs of the
+   same priority can be picked up by the remaining workers instead of waiting behind them.
+   \param type Job type to limit
+   \param maxJobs maximum number of concurrent jobs of this type, 0 to remove the limit
+   \sa GetMaxConcurrentJobs()
+   */
+  void SetMaxConcurrentJobs(const std::string &type, unsigned int maxJobs);
+
+  /*!
+   \brief Retrieve the concurrency limit for a specific type of job.
+   \param type Job type to look up
+   \return the maximum number of concurrent jobs of this type, 0 if unlimited
+   \sa SetMaxConcurrentJobs()
+   */
+  unsigned int GetMaxConcurrentJobs(const std::string &type) const;
+
+  /*!
+   \brief Set how long a queued job may wait before it is promoted to the next priority level.
+   Promotion only moves a job up by one level at a time, so higher priority jobs are still
+   served first.
+   \param timeout time in milliseconds
+   */
+  void SetStarvationTimeout(unsigned int timeout);
+
 protected:
   friend class CJobWorker;
   friend class CJob;
@@ -335,25 +364,45 @@ private:
   CJobManager const& operator=(CJobManager const&);
   virtual ~CJobManager();
 
+  typedef std::deque<CWorkItem>    JobQueue;
+  typedef std::vector<CWorkItem>   Processing;
+  typedef std::vector<CJobWorker*> Workers;
+  typedef std::map<std::string, unsigned int> TypeCounts;
+
   /*! \brief Pop a job off the job queue and add to the processing queue ready to process
    \return the job to process, NULL if no jobs are available
    */
   CJob *PopJob();
 
+  /*! \brief Find the first job in the given queue that may be processed now, honouring the
+   per-type concurrency limits.
+   \return an iterator to the job, or the end of the queue if no job may be processed
+   */
+  JobQueue::iterator FindRunnableJob(JobQueue &queue);
+
+  /*! \brief Move a job from the given queue to the processing vector.
+   \return the job to process
+   */
+  CJob *StartJob(JobQueue &queue, JobQueue::iterator it);
+
+  /*! \brief Promote jobs that have been queued for longer than the starvation timeout by one
+   priority level.
+   */
+  void PromoteStarvedJobs();
+
   void StartWorkers(CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker *worker);
   static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
 
   unsigned int m_jobCounter;
 
-  typedef std::deque<CWorkItem>    JobQueue;
-  typedef std::vector<CWorkItem>   Processing;
-  typedef std::vector<CJobWorker*> Workers;
-
   JobQueue   m_jobQueue[CJob::PRIORITY_DEDICATED + 1];
   bool       m_pauseJobs;
   Processing m_processing;
   Workers    m_workers;
+  TypeCounts m_typeLimits;     ///< maximum number of concurrent jobs per job type
+  TypeCounts m_typeProcessing; ///< number of jobs currently processing per limited job type
+  unsigned int m_starvationTimeout; ///< time (in ms) after which a queued job is promoted
 
   CCriticalSection m_section;
   CEvent           m_jobEvent;
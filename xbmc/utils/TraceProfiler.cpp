@@ -0,0 +1,252 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TraceProfiler.h"
+
+#include <algorithm>
+#include <map>
+
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+
+#define TRACE_BUFFER_SIZE 8192 ///< events kept per thread
+
+namespace
+{
+int64_t Percentile(std::vector<int64_t> &durations, double percentile)
+{
+  size_t n = std::min(durations.size() - 1, static_cast<size_t>(percentile / 100.0 * durations.size()));
+  std::nth_element(durations.begin(), durations.begin() + n, durations.end());
+  return durations[n];
+}
+
+std::string EscapeName(const char *name)
+{
+  std::string escaped;
+  for (const char *c = name; *c; c++)
+  {
+    if (*c == '"' || *c == '\\')
+      escaped += '\\';
+    escaped += *c;
+  }
+  return escaped;
+}
+}
+
+std::atomic<bool> CTraceProfiler::m_running(false);
+thread_local CTraceProfiler::BufferOwner CTraceProfiler::m_threadBuffer;
+
+CTraceProfiler::BufferOwner::~BufferOwner()
+{
+  if (buffer)
+    CTraceProfiler::Instance().ReleaseBuffer(buffer);
+}
+
+CTraceProfiler::CTraceProfiler()
+: m_maxFrameCount(600),
+  m_frameCount(0),
+  m_startTime(0),
+  m_frameStart(0)
+{
+}
+
+CTraceProfiler &CTraceProfiler::Instance()
+{
+  static CTraceProfiler profiler;
+  return profiler;
+}
+
+void CTraceProfiler::Start()
+{
+  CSingleLock lock(m_critSection);
+  // release the events of the previous run
+  for (auto &buffer : m_buffers)
+  {
+    CSingleLock bufferLock(buffer->critSection);
+    buffer->count = 0;
+    std::vector<Event>().swap(buffer->events);
+  }
+  m_frameCount = 0;
+  m_startTime = CurrentHostCounter();
+  m_frameStart = m_startTime;
+  m_running = true;
+}
+
+void CTraceProfiler::Stop()
+{
+  m_running = false;
+}
+
+void CTraceProfiler::EndFrame()
+{
+  {
+    CSingleLock lock(m_critSection);
+    if (!m_running)
+      return;
+
+    int64_t now = CurrentHostCounter();
+    Record("Frame", m_frameStart, now);
+    m_frameStart = now;
+
+    // only the thread ending the last frame stops the run and saves the results
+    if (++m_frameCount < m_maxFrameCount)
+      return;
+
+    Stop();
+  }
+
+  LogPercentiles();
+  if (!m_outputFile.empty() && !SaveResults())
+    CLog::Log(LOGERROR, "CTraceProfiler: unable to save trace to %s", m_outputFile.c_str());
+}
+
+CTraceProfiler::Buffer *CTraceProfiler::GetBuffer()
+{
+  Buffer *buffer = m_threadBuffer.buffer;
+  if (!buffer)
+  {
+    CSingleLock lock(m_critSection);
+    // reuse the buffer of a thread that exited, its events stay part of the trace
+    auto it = std::find_if(m_buffers.begin(), m_buffers.end(),
+                           [](const std::unique_ptr<Buffer> &buffer) { return !buffer->inUse; });
+    if (it != m_buffers.end())
+    {
+      buffer = it->get();
+      buffer->inUse = true;
+    }
+    else
+    {
+      m_buffers.emplace_back(new Buffer(m_buffers.size()));
+      buffer = m_buffers.back().get();
+    }
+    m_threadBuffer.buffer = buffer;
+  }
+  return buffer;
+}
+
+void CTraceProfiler::ReleaseBuffer(Buffer *buffer)
+{
+  CSingleLock lock(m_critSection);
+  buffer->inUse = false;
+}
+
+void CTraceProfiler::Record(const char *name, int64_t start, int64_t end)
+{
+  Buffer *buffer = GetBuffer();
+
+  CSingleLock lock(buffer->critSection);
+  if (buffer->events.empty())
+    buffer->events.resize(TRACE_BUFFER_SIZE);
+  buffer->events[buffer->count++ % buffer->events.size()] = { name, start, end };
+}
+
+std::vector<CTraceProfiler::Event> CTraceProfiler::GetEvents(Buffer &buffer)
+{
+  CSingleLock lock(buffer.critSection);
+  std::vector<Event> events;
+  if (buffer.count <= buffer.events.size())
+    events.assign(buffer.events.begin(), buffer.events.begin() + buffer.count);
+  else
+  {
+    // the ring wrapped, the oldest event is the one to be overwritten next
+    size_t head = buffer.count % buffer.events.size();
+    events.assign(buffer.events.begin() + head, buffer.events.end());
+    events.insert(events.end(), buffer.events.begin(), buffer.events.begin() + head);
+  }
+  return events;
+}
+
+double CTraceProfiler::GetPercentile(const std::string &name, double percentile) const
+{
+  std::vector<int64_t> durations;
+  {
+    CSingleLock lock(m_critSection);
+    for (const auto &buffer : m_buffers)
+    {
+      for (const auto &event : GetEvents(*buffer))
+      {
+        if (name == event.name)
+          durations.push_back(event.end - event.start);
+      }
+    }
+  }
+  if (durations.empty())
+    return 0.0;
+
+  return Percentile(durations, percentile) * 1000.0 / CurrentHostFrequency();
+}
+
+void CTraceProfiler::LogPercentiles() const
+{
+  std::map<std::string, std::vector<int64_t>> durations;
+  {
+    CSingleLock lock(m_critSection);
+    for (const auto &buffer : m_buffers)
+    {
+      for (const auto &event : GetEvents(*buffer))
+        durations[event.name].push_back(event.end - event.start);
+    }
+  }
+
+  double scale = 1000.0 / CurrentHostFrequency();
+  CLog::Log(LOGNOTICE, "CTraceProfiler: %d frames, durations in ms (p50 / p95 / p99 / max)", m_frameCount);
+  for (auto &it : durations)
+  {
+    std::vector<int64_t> &samples = it.second;
+    CLog::Log(LOGNOTICE, "  %-40s %6u: %7.2f / %7.2f / %7.2f / %7.2f", it.first.c_str(), (unsigned int)samples.size(),
+              Percentile(samples, 50) * scale, Percentile(samples, 95) * scale, Percentile(samples, 99) * scale,
+              *std::max_element(samples.begin(), samples.end()) * scale);
+  }
+}
+
+bool CTraceProfiler::SaveResults() const
+{
+  XFILE::CFile file;
+  if (!file.OpenForWrite(m_outputFile, true))
+    return false;
+
+  // Chrome trace event format, timestamps and durations are in microseconds
+  double scale = 1000000.0 / CurrentHostFrequency();
+  std::string json = "{\"traceEvents\":[";
+  bool first = true;
+
+  CSingleLock lock(m_critSection);
+  for (const auto &buffer : m_buffers)
+  {
+    for (const auto &event : GetEvents(*buffer))
+    {
+      json += first ? "\n" : ",\n";
+      first = false;
+      json += StringUtils::Format("{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.1f,\"dur\":%.1f}",
+                                  EscapeName(event.name).c_str(), buffer->id,
+                                  (event.start - m_startTime) * scale, (event.end - event.start) * scale);
+      if (json.size() > 65536)
+      {
+        if (file.Write(json.c_str(), json.size()) != static_cast<ssize_t>(json.size()))
+          return false;
+        json.clear();
+      }
+    }
+  }
+  json += "\n]}\n";
+  return file.Write(json.c_str(), json.size()) == static_cast<ssize_t>(json.size());
+}
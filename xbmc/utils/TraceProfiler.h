@@ -0,0 +1,146 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "utils/TimeUtils.h"
+
+/*!
+ \brief Low overhead tracing of scoped events, e.g. the stages of the render loop.
+
+ Every thread records into its own ring buffer, so threads do not contend while recording.
+ The buffer of a thread that exits is handed to the next new thread.
+ After the configured number of frames the recorded events are saved in the Chrome trace
+ event format (load them in chrome://tracing) and the duration percentiles of every
+ event are logged.
+
+ \sa TRACE_SCOPE
+ */
+class CTraceProfiler
+{
+public:
+  static CTraceProfiler &Instance();
+  static bool IsRunning() { return m_running.load(std::memory_order_relaxed); }
+
+  void Start();
+  void Stop();
+  void EndFrame();
+
+  /*! \brief Record an event of the calling thread
+   \param name name of the event, has to stay valid until the next Start()
+   \param start counter value the event started, from CurrentHostCounter()
+   \param end counter value the event ended
+   */
+  void Record(const char *name, int64_t start, int64_t end);
+
+  /*! \brief Get a percentile of the duration of the recorded events with a given name
+   \param name name of the event
+   \param percentile the percentile from 0 to 100
+   \return the duration in milliseconds, 0 if no event was recorded
+   */
+  double GetPercentile(const std::string &name, double percentile) const;
+
+  int GetMaxFrameCount() const { return m_maxFrameCount; }
+  void SetMaxFrameCount(int maxFrameCount) { m_maxFrameCount = maxFrameCount; }
+  void SetOutputFile(const std::string &outputFile) { m_outputFile = outputFile; }
+  const std::string &GetOutputFile() const { return m_outputFile; }
+  bool SaveResults() const;
+
+private:
+  CTraceProfiler();
+  CTraceProfiler(const CTraceProfiler&) = delete;
+  CTraceProfiler& operator=(const CTraceProfiler&) = delete;
+
+  struct Event
+  {
+    const char *name;
+    int64_t start;
+    int64_t end;
+  };
+
+  struct Buffer
+  {
+    explicit Buffer(unsigned int id) : id(id) {}
+    unsigned int id;            ///< thread id used in the trace
+    uint64_t count = 0;         ///< number of events recorded, the buffer holds the last ones
+    std::vector<Event> events;  ///< allocated on the first event
+    bool inUse = true;          ///< owned by a running thread
+    CCriticalSection critSection;
+  };
+
+  /*! \brief Returns the buffer of the thread to the profiler when the thread exits */
+  struct BufferOwner
+  {
+    ~BufferOwner();
+    Buffer *buffer = nullptr;
+  };
+
+  Buffer *GetBuffer();
+  void ReleaseBuffer(Buffer *buffer);
+  static std::vector<Event> GetEvents(Buffer &buffer);
+  void LogPercentiles() const;
+
+  static std::atomic<bool> m_running;
+  static thread_local BufferOwner m_threadBuffer;
+  mutable CCriticalSection m_critSection;
+  std::vector<std::unique_ptr<Buffer>> m_buffers;
+  std::string m_outputFile;
+  int m_maxFrameCount;
+  int m_frameCount;
+  int64_t m_startTime;
+  int64_t m_frameStart;
+};
+
+/*!
+ \brief Records the lifetime of the scope as an event while the trace profiler is running.
+ */
+class CTraceScope
+{
+public:
+  explicit CTraceScope(const char *name)
+  : m_name(CTraceProfiler::IsRunning() ? name : nullptr),
+    m_start(m_name ? CurrentHostCounter() : 0)
+  {
+  }
+
+  ~CTraceScope()
+  {
+    if (m_name)
+      CTraceProfiler::Instance().Record(m_name, m_start, CurrentHostCounter());
+  }
+
+private:
+  CTraceScope(const CTraceScope&) = delete;
+  CTraceScope& operator=(const CTraceScope&) = delete;
+
+  const char *m_name;
+  int64_t m_start;
+};
+
+#define TRACE_SCOPE_CONCAT2(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT2(a, b)
+#define TRACE_SCOPE(name) CTraceScope TRACE_SCOPE_CONCAT(traceScope, __LINE__)(name)
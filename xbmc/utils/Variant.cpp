@@ -155,7 +155,7 @@ CVariant::CVariant(VariantType type)
       m_data.dvalue = 0.0;
       break;
     case VariantTypeString:
-      m_data.string = new std::string();
+      setString("", 0);
       break;
     case VariantTypeWideString:
       m_data.wstring = new std::wstring();
@@ -217,25 +217,25 @@ CVariant::CVariant(bool boolean)
 CVariant::CVariant(const char *str)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(str);
+  setString(str, strlen(str));
 }
 
 CVariant::CVariant(const char *str, unsigned int length)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(str, length);
+  setString(str, length);
 }
 
 CVariant::CVariant(const std::string &str)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(str);
+  setString(str.c_str(), str.size());
 }
 
 CVariant::CVariant(std::string &&str)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(std::move(str));
+  setString(std::move(str));
 }
 
 CVariant::CVariant(const wchar_t *str)
@@ -310,8 +310,11 @@ void CVariant::cleanup()
   switch (m_type)
   {
   case VariantTypeString:
-    delete m_data.string;
-    m_data.string = nullptr;
+    if (m_shortStringSize == LONG_STRING)
+    {
+      delete m_data.string;
+      m_data.string = nullptr;
+    }
     break;
 
   case VariantTypeWideString:
@@ -395,7 +398,10 @@ int64_t CVariant::asInteger(int64_t fallback) const
     case VariantTypeDouble:
       return (int64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2int64(*m_data.string, fallback);
+    {
+      std::string buffer;
+      return str2int64(stringValue(buffer), fallback);
+    }
     case VariantTypeWideString:
       return str2int64(*m_data.wstring, fallback);
     default:
@@ -416,7 +422,10 @@ uint64_t CVariant::asUnsignedInteger(uint64_t fallback) const
     case VariantTypeDouble:
       return (uint64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2uint64(*m_data.string, fallback);
+    {
+      std::string buffer;
+      return str2uint64(stringValue(buffer), fallback);
+    }
     case VariantTypeWideString:
       return str2uint64(*m_data.wstring, fallback);
     default:
@@ -437,7 +446,10 @@ double CVariant::asDouble(double fallback) const
     case VariantTypeUnsignedInteger:
       return (double)m_data.unsignedinteger;
     case VariantTypeString:
-      return str2double(*m_data.string, fallback);
+    {
+      std::string buffer;
+      return str2double(stringValue(buffer), fallback);
+    }
     case VariantTypeWideString:
       return str2double(*m_data.wstring, fallback);
     default:
@@ -458,7 +470,10 @@ float CVariant::asFloat(float fallback) const
     case VariantTypeUnsignedInteger:
       return (float)m_data.unsignedinteger;
     case VariantTypeString:
-      return (float)str2double(*m_data.string, fallback);
+    {
+      std::string buffer;
+      return (float)str2double(stringValue(buffer), fallback);
+    }
     case VariantTypeWideString:
       return (float)str2double(*m_data.wstring, fallback);
     default:
@@ -481,9 +496,13 @@ bool CVariant::asBoolean(bool fallback) const
     case VariantTypeDouble:
       return (m_data.dvalue != 0);
     case VariantTypeString:
-      if (m_data.string->empty() || m_data.string->compare("0") == 0 || m_data.string->compare("false") == 0)
+    {
+      std::string buffer;
+      const std::string &str = stringValue(buffer);
+      if (str.empty() || str.compare("0") == 0 || str.compare("false") == 0)
         return false;
       return true;
+    }
     case VariantTypeWideString:
       if (m_data.wstring->empty() || m_data.wstring->compare(L"0") == 0 || m_data.wstring->compare(L"false") == 0)
         return false;
@@ -500,7 +519,7 @@ std::string CVariant::asString(const std::string &fallback /* = "" */) const
   switch (m_type)
   {
     case VariantTypeString:
-      return *m_data.string;
+      return std::string(stringData(), stringSize());
     case VariantTypeBoolean:
       return m_data.boolean ? "true" : "false";
     case VariantTypeInteger:
@@ -614,7 +633,7 @@ CVariant &CVariant::operator=(const CVariant &rhs)
     m_data.dvalue = rhs.m_data.dvalue;
     break;
   case VariantTypeString:
-    m_data.string = new std::string(*rhs.m_data.string);
+    setString(rhs.stringData(), rhs.stringSize());
     break;
   case VariantTypeWideString:
     m_data.wstring = new std::wstring(*rhs.m_data.wstring);
@@ -642,6 +661,7 @@ CVariant& CVariant::operator=(CVariant&& rhs)
     cleanup();
 
   m_type = rhs.m_type;
+  m_shortStringSize = rhs.m_shortStringSize;
   m_data = std::move(rhs.m_data);
 
   //Should be enough to just set m_type here
@@ -675,7 +695,7 @@ bool CVariant::operator==(const CVariant &rhs) const
     case VariantTypeDouble:
       return m_data.dvalue == rhs.m_data.dvalue;
     case VariantTypeString:
-      return *m_data.string == *rhs.m_data.string;
+      return stringSize() == rhs.stringSize() && memcmp(stringData(), rhs.stringData(), stringSize()) == 0;
     case VariantTypeWideString:
       return *m_data.wstring == *rhs.m_data.wstring;
     case VariantTypeArray:
@@ -727,7 +747,7 @@ void CVariant::append(CVariant&& variant)
 const char *CVariant::c_str() const
 {
   if (m_type == VariantTypeString)
-    return m_data.string->c_str();
+    return stringData();
   else
     return NULL;
 }
@@ -735,12 +755,15 @@ const char *CVariant::c_str() const
 void CVariant::swap(CVariant &rhs)
 {
   VariantType  temp_type = m_type;
+  unsigned char temp_size = m_shortStringSize;
   VariantUnion temp_data = m_data;
 
   m_type = rhs.m_type;
+  m_shortStringSize = rhs.m_shortStringSize;
   m_data = rhs.m_data;
 
   rhs.m_type = temp_type;
+  rhs.m_shortStringSize = temp_size;
   rhs.m_data = temp_data;
 }
 
@@ -815,7 +838,7 @@ unsigned int CVariant::size() const
   else if (m_type == VariantTypeArray)
     return m_data.array->size();
   else if (m_type == VariantTypeString)
-    return m_data.string->size();
+    return stringSize();
   else if (m_type == VariantTypeWideString)
     return m_data.wstring->size();
   else
@@ -829,7 +852,7 @@ bool CVariant::empty() const
   else if (m_type == VariantTypeArray)
     return m_data.array->empty();
   else if (m_type == VariantTypeString)
-    return m_data.string->empty();
+    return stringSize() == 0;
   else if (m_type == VariantTypeWideString)
     return m_data.wstring->empty();
   else if (m_type == VariantTypeNull)
@@ -845,7 +868,12 @@ void CVariant::clear()
   else if (m_type == VariantTypeArray)
     m_data.array->clear();
   else if (m_type == VariantTypeString)
-    m_data.string->clear();
+  {
+    if (m_shortStringSize == LONG_STRING)
+      m_data.string->clear();
+    else
+      setString("", 0);
+  }
   else if (m_type == VariantTypeWideString)
     m_data.wstring->clear();
 }
@@ -880,3 +908,48 @@ bool CVariant::isMember(const std::string &key) const
 
   return false;
 }
+
+void CVariant::setString(const char *str, size_t length)
+{
+  if (length < SHORT_STRING_SIZE)
+  {
+    memcpy(m_data.shortstring, str, length);
+    m_data.shortstring[length] = '\0';
+    m_shortStringSize = (unsigned char)length;
+  }
+  else
+  {
+    m_data.string = new std::string(str, length);
+    m_shortStringSize = LONG_STRING;
+  }
+}
+
+void CVariant::setString(std::string &&str)
+{
+  if (str.size() < SHORT_STRING_SIZE)
+    setString(str.c_str(), str.size());
+  else
+  {
+    m_data.string = new std::string(std::move(str));
+    m_shortStringSize = LONG_STRING;
+  }
+}
+
+const char *CVariant::stringData() const
+{
+  return m_shortStringSize == LONG_STRING ? m_data.string->c_str() : m_data.shortstring;
+}
+
+size_t CVariant::stringSize() const
+{
+  return m_shortStringSize == LONG_STRING ? m_data.string->size() : m_shortStringSize;
+}
+
+const std::string &CVariant::stringValue(std::string &buffer) const
+{
+  if (m_shortStringSize == LONG_STRING)
+    return *m_data.string;
+
+  buffer.assign(m_data.shortstring, m_shortStringSize);
+  return buffer;
+}
@@ -109,8 +109,15 @@ public:
   void append(const CVariant &variant);
   void append(CVariant &&variant);
 
+  /*
+   Short strings are stored inside the variant itself, so the pointer
+   returned by c_str() is invalidated when the variant is moved from,
+   swapped, assigned or destroyed, even if the string stays the same.
+   Keep a copy from asString() if the string has to outlive that.
+   */
   const char *c_str() const;
 
+  // invalidates pointers returned by c_str() of both variants
   void swap(CVariant &rhs);
 
 private:
@@ -146,6 +153,21 @@ public:
 
 private:
   void cleanup();
+  void setString(const char *str, size_t length);
+  void setString(std::string &&str);
+  const char *stringData() const;
+  size_t stringSize() const;
+  const std::string &stringValue(std::string &buffer) const;
+
+  /*
+   Narrow strings of up to SHORT_STRING_SIZE - 1 characters are stored in
+   shortstring instead of a separately allocated std::string, keeping the
+   union pointer sized. m_shortStringSize holds their length, or
+   LONG_STRING for strings stored in string.
+   */
+  static const size_t SHORT_STRING_SIZE = 8;
+  static const unsigned char LONG_STRING = 0xFF;
+
   union VariantUnion
   {
     int64_t integer;
@@ -156,8 +178,10 @@ private:
     std::wstring *wstring;
     VariantArray *array;
     VariantMap *map;
+    char shortstring[SHORT_STRING_SIZE];
   };
 
   VariantType m_type;
+  unsigned char m_shortStringSize = LONG_STRING;
   VariantUnion m_data;
 };
@@ -32,3 +32,74 @@ TEST(TestJSONVariantParser, Parse)
   variant = CJSONVariantParser::Parse(buf, sizeof(buf));
   EXPECT_TRUE(variant.isNull());
 }
+
+TEST(TestJSONVariantParser, ParseNested)
+{
+  CVariant variant = CJSONVariantParser::Parse("{\"a\":[1,\"x\",{\"b\":true,\"c\":[[2.5],[]]}],\"d\":null,\"e\":{\"f\":{\"g\":\"h\"}}}");
+
+  ASSERT_TRUE(variant.isObject());
+  EXPECT_EQ(3U, variant.size());
+
+  ASSERT_TRUE(variant["a"].isArray());
+  ASSERT_EQ(3U, variant["a"].size());
+  EXPECT_EQ(1, variant["a"][0].asInteger());
+  EXPECT_STREQ("x", variant["a"][1].c_str());
+  ASSERT_TRUE(variant["a"][2].isObject());
+  EXPECT_TRUE(variant["a"][2]["b"].asBoolean());
+  ASSERT_EQ(2U, variant["a"][2]["c"].size());
+  EXPECT_DOUBLE_EQ(2.5, variant["a"][2]["c"][0][0].asDouble());
+  EXPECT_TRUE(variant["a"][2]["c"][1].isArray());
+  EXPECT_TRUE(variant["a"][2]["c"][1].empty());
+
+  EXPECT_TRUE(variant.isMember("d"));
+  EXPECT_TRUE(variant["d"].isNull());
+  EXPECT_STREQ("h", variant["e"]["f"]["g"].c_str());
+}
+
+TEST(TestJSONVariantParser, ParseEmpty)
+{
+  CVariant variant = CJSONVariantParser::Parse("{}");
+  EXPECT_TRUE(variant.isObject());
+  EXPECT_TRUE(variant.empty());
+
+  variant = CJSONVariantParser::Parse("[]");
+  EXPECT_TRUE(variant.isArray());
+  EXPECT_TRUE(variant.empty());
+
+  variant = CJSONVariantParser::Parse("[{},[],\"\"]");
+  ASSERT_TRUE(variant.isArray());
+  ASSERT_EQ(3U, variant.size());
+  EXPECT_TRUE(variant[0].isObject());
+  EXPECT_TRUE(variant[0].empty());
+  EXPECT_TRUE(variant[1].isArray());
+  EXPECT_TRUE(variant[1].empty());
+  EXPECT_TRUE(variant[2].isString());
+  EXPECT_TRUE(variant[2].empty());
+
+  variant = CJSONVariantParser::Parse("{\"a\":{},\"b\":[]}");
+  ASSERT_TRUE(variant.isObject());
+  EXPECT_TRUE(variant["a"].isObject());
+  EXPECT_TRUE(variant["b"].isArray());
+}
+
+TEST(TestJSONVariantParser, ParseScalar)
+{
+  CVariant variant = CJSONVariantParser::Parse("42");
+  EXPECT_TRUE(variant.isInteger());
+  EXPECT_EQ(42, variant.asInteger());
+
+  variant = CJSONVariantParser::Parse("-1.5");
+  EXPECT_TRUE(variant.isDouble());
+  EXPECT_DOUBLE_EQ(-1.5, variant.asDouble());
+
+  variant = CJSONVariantParser::Parse("\"text\"");
+  EXPECT_TRUE(variant.isString());
+  EXPECT_STREQ("text", variant.c_str());
+
+  variant = CJSONVariantParser::Parse("true");
+  EXPECT_TRUE(variant.isBoolean());
+  EXPECT_TRUE(variant.asBoolean());
+
+  variant = CJSONVariantParser::Parse("null");
+  EXPECT_TRUE(variant.isNull());
+}
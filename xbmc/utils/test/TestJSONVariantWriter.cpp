@@ -21,6 +21,8 @@
 #include "utils/JSONVariantWriter.h"
 #include "utils/Variant.h"
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 TEST(TestJSONVariantWriter, Write)
@@ -31,3 +33,93 @@ TEST(TestJSONVariantWriter, Write)
   str = CJSONVariantWriter::Write(variant, false);
   EXPECT_STREQ("null\n", str.c_str());
 }
+
+TEST(TestJSONVariantWriter, WriteStream)
+{
+  CVariant variant;
+  variant["title"] = "test";
+  // large enough to be handed out in several chunks of 64 KiB
+  for (int i = 0; i < 50000; i++)
+    variant["items"].push_back(i);
+
+  std::string streamed;
+  unsigned int chunks = 0;
+  EXPECT_TRUE(CJSONVariantWriter::Write(variant, [&](const char *data, size_t length)
+  {
+    streamed.append(data, length);
+    chunks++;
+    return true;
+  }, true));
+
+  EXPECT_GT(streamed.size(), 64U * 1024U);
+  EXPECT_STREQ(CJSONVariantWriter::Write(variant, true).c_str(), streamed.c_str());
+  EXPECT_GT(chunks, 1U);
+
+  EXPECT_FALSE(CJSONVariantWriter::Write(variant, [](const char *data, size_t length) { return false; }, true));
+}
+
+namespace
+{
+std::string WriteInParts(const CVariant &variant, size_t size, bool compact, unsigned int &parts)
+{
+  CJSONVariantStreamWriter writer(variant, compact);
+  std::string output;
+  std::vector<char> buffer(size);
+  size_t written = 0;
+
+  parts = 0;
+  while (writer.Write(buffer.data(), buffer.size(), written) && written > 0)
+  {
+    output.append(buffer.data(), written);
+    parts++;
+  }
+
+  return output;
+}
+}
+
+TEST(TestJSONVariantStreamWriter, Write)
+{
+  unsigned int parts;
+
+  EXPECT_STREQ(CJSONVariantWriter::Write(CVariant(), false).c_str(), WriteInParts(CVariant(), 1, false, parts).c_str());
+  EXPECT_STREQ(CJSONVariantWriter::Write(CVariant("test"), true).c_str(), WriteInParts(CVariant("test"), 2, true, parts).c_str());
+  EXPECT_STREQ(CJSONVariantWriter::Write(CVariant(CVariant::VariantTypeArray), true).c_str(),
+               WriteInParts(CVariant(CVariant::VariantTypeArray), 16, true, parts).c_str());
+  EXPECT_STREQ(CJSONVariantWriter::Write(CVariant(CVariant::VariantTypeObject), false).c_str(),
+               WriteInParts(CVariant(CVariant::VariantTypeObject), 16, false, parts).c_str());
+}
+
+TEST(TestJSONVariantStreamWriter, WriteNested)
+{
+  CVariant variant;
+  variant["title"] = "test";
+  variant["rating"] = 7.5;
+  variant["watched"] = false;
+  variant["empty"] = CVariant(CVariant::VariantTypeArray);
+  variant["items"].push_back(1);
+  variant["items"].push_back(CVariant());
+  variant["items"][2]["label"] = "item";
+  variant["items"][2]["ids"].push_back(-1);
+  variant["items"][2]["ids"].push_back(static_cast<uint64_t>(2));
+
+  unsigned int parts;
+  for (size_t size : { 1, 3, 7, 4096 })
+  {
+    EXPECT_STREQ(CJSONVariantWriter::Write(variant, true).c_str(), WriteInParts(variant, size, true, parts).c_str());
+    EXPECT_STREQ(CJSONVariantWriter::Write(variant, false).c_str(), WriteInParts(variant, size, false, parts).c_str());
+  }
+}
+
+TEST(TestJSONVariantStreamWriter, WriteLarge)
+{
+  CVariant variant;
+  for (int i = 0; i < 50000; i++)
+    variant["items"].push_back(i);
+
+  unsigned int parts;
+  std::string streamed = WriteInParts(variant, 64 * 1024, true, parts);
+
+  EXPECT_STREQ(CJSONVariantWriter::Write(variant, true).c_str(), streamed.c_str());
+  EXPECT_EQ((streamed.size() + 64 * 1024 - 1) / (64 * 1024), parts);
+}
@@ -22,6 +22,7 @@
 #include "utils/JobManager.h"
 #include "settings/Settings.h"
 #include "utils/SystemInfo.h"
+#include "threads/SystemClock.h"
 
 #include "gtest/gtest.h"
 
@@ -142,6 +143,16 @@ private:
   bool m_finish;
 };
 
+// Waits for the job of the package to start, gives up after 5 seconds
+bool WaitForJobToStart(JobControlPackage &package)
+{
+  XbmcThreads::EndTime timeout(5000);
+  while (!package.ready && !timeout.IsTimePast())
+    package.jobCreatedCond.wait(package.jobCreatedMutex, timeout.MillisLeft());
+
+  return package.ready;
+}
+
 BroadcastingJob *
 WaitForJobToStartProcessing(CJob::PRIORITY priority, JobControlPackage &package)
 {
@@ -149,8 +160,7 @@ WaitForJobToStartProcessing(CJob::PRIORITY priority, JobControlPackage &package)
   CJobManager::GetInstance().AddJob(job, NULL, priority);
 
   // We're now ready to wait, wait and then unblock once ready
-  while (!package.ready)
-    package.jobCreatedCond.wait(package.jobCreatedMutex);
+  EXPECT_TRUE(WaitForJobToStart(package));
 
   return job;
 }
@@ -179,3 +189,71 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+TEST_F(TestJobManager, MaxConcurrentJobs)
+{
+  CJobManager::GetInstance().SetMaxConcurrentJobs("BroadcastingJob", 1);
+  EXPECT_EQ(1U, CJobManager::GetInstance().GetMaxConcurrentJobs("BroadcastingJob"));
+
+  JobControlPackage package;
+  BroadcastingJob *job (WaitForJobToStartProcessing(CJob::PRIORITY_HIGH, package));
+
+  JobControlPackage blockedPackage;
+  BroadcastingJob *blockedJob = new BroadcastingJob(blockedPackage);
+  CJobManager::GetInstance().AddJob(blockedJob, NULL, CJob::PRIORITY_HIGH);
+
+  EXPECT_EQ(1, CJobManager::GetInstance().IsProcessing("BroadcastingJob"));
+  EXPECT_FALSE(blockedPackage.ready);
+
+  // finishing the first job lets the queued one run
+  job->FinishAndStopBlocking();
+  ASSERT_TRUE(WaitForJobToStart(blockedPackage));
+  EXPECT_EQ(1, CJobManager::GetInstance().IsProcessing("BroadcastingJob"));
+
+  blockedJob->FinishAndStopBlocking();
+  CJobManager::GetInstance().SetMaxConcurrentJobs("BroadcastingJob", 0);
+  EXPECT_EQ(0U, CJobManager::GetInstance().GetMaxConcurrentJobs("BroadcastingJob"));
+}
+
+TEST_F(TestJobManager, HighPriorityWinsOverStarvedJobs)
+{
+  // only one job of this type may run, so the others queue up behind the first one
+  CJobManager::GetInstance().SetMaxConcurrentJobs("BroadcastingJob", 1);
+
+  JobControlPackage package;
+  BroadcastingJob *job (WaitForJobToStartProcessing(CJob::PRIORITY_HIGH, package));
+
+  JobControlPackage highPackage;
+  BroadcastingJob *highJob = new BroadcastingJob(highPackage);
+  CJobManager::GetInstance().AddJob(highJob, NULL, CJob::PRIORITY_HIGH);
+
+  // every queued low priority job counts as starved from now on
+  CJobManager::GetInstance().SetStarvationTimeout(0);
+
+  JobControlPackage lowPackage[2];
+  BroadcastingJob *lowJob[2];
+  for (int i = 0; i < 2; i++)
+  {
+    lowJob[i] = new BroadcastingJob(lowPackage[i]);
+    CJobManager::GetInstance().AddJob(lowJob[i], NULL, CJob::PRIORITY_LOW);
+  }
+
+  // promoted jobs go to the back of the higher queue, so the waiting high priority job runs first
+  job->FinishAndStopBlocking();
+  ASSERT_TRUE(WaitForJobToStart(highPackage));
+  EXPECT_TRUE(CJobManager::GetInstance().IsProcessing(CJob::PRIORITY_HIGH));
+  EXPECT_FALSE(lowPackage[0].ready);
+  EXPECT_FALSE(lowPackage[1].ready);
+
+  highJob->FinishAndStopBlocking();
+  for (int i = 0; i < 2; i++)
+  {
+    ASSERT_TRUE(WaitForJobToStart(lowPackage[i]));
+    // the promoted job runs as a job of its new priority
+    EXPECT_FALSE(CJobManager::GetInstance().IsProcessing(CJob::PRIORITY_LOW));
+    lowJob[i]->FinishAndStopBlocking();
+  }
+
+  CJobManager::GetInstance().SetStarvationTimeout(10000);
+  CJobManager::GetInstance().SetMaxConcurrentJobs("BroadcastingJob", 0);
+}
@@ -0,0 +1,222 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "threads/Thread.h"
+#include "utils/auto_buffer.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/TraceProfiler.h"
+#include "utils/Variant.h"
+
+#include <chrono>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+class CTestTraceThread : public CThread
+{
+public:
+  CTestTraceThread() : CThread("TestTraceProfiler") {}
+
+protected:
+  void Process() override
+  {
+    for (int i = 0; i < 100; i++)
+      TRACE_SCOPE("worker");
+  }
+};
+
+class TestTraceProfiler : public testing::Test
+{
+protected:
+  TestTraceProfiler()
+  {
+    CTraceProfiler::Instance().SetMaxFrameCount(1000);
+    CTraceProfiler::Instance().SetOutputFile("");
+  }
+  ~TestTraceProfiler()
+  {
+    CTraceProfiler::Instance().Stop();
+    CTraceProfiler::Instance().SetMaxFrameCount(600);
+  }
+
+  /*! \brief Save the trace and return its events */
+  CVariant SaveTrace()
+  {
+    XFILE::CFile *tmpfile = XBMC_CREATETEMPFILE(".json");
+    if (!tmpfile)
+      return CVariant::VariantTypeNull;
+    std::string path = XBMC_TEMPFILEPATH(tmpfile);
+    tmpfile->Close();
+
+    CTraceProfiler::Instance().SetOutputFile(path);
+    CVariant trace;
+    XFILE::CFile file;
+    XUTILS::auto_buffer buffer;
+    if (CTraceProfiler::Instance().SaveResults() && file.LoadFile(path, buffer) > 0)
+      trace = CJSONVariantParser::Parse(std::string(buffer.get(), buffer.size()))["traceEvents"];
+    CTraceProfiler::Instance().SetOutputFile("");
+    XBMC_DELETETEMPFILE(tmpfile);
+    return trace;
+  }
+};
+
+TEST_F(TestTraceProfiler, NotRunning)
+{
+  CTraceProfiler::Instance().Start();
+  CTraceProfiler::Instance().Stop();
+  {
+    TRACE_SCOPE("stopped");
+  }
+  EXPECT_EQ(0.0, CTraceProfiler::Instance().GetPercentile("stopped", 50));
+}
+
+TEST_F(TestTraceProfiler, Percentiles)
+{
+  CTraceProfiler::Instance().Start();
+  for (int i = 0; i < 10; i++)
+  {
+    TRACE_SCOPE("sleep");
+    std::this_thread::sleep_for(std::chrono::milliseconds(i == 9 ? 50 : 1));
+  }
+  EXPECT_GE(CTraceProfiler::Instance().GetPercentile("sleep", 50), 1.0);
+  EXPECT_LT(CTraceProfiler::Instance().GetPercentile("sleep", 50), 50.0);
+  EXPECT_GE(CTraceProfiler::Instance().GetPercentile("sleep", 100), 50.0);
+}
+
+TEST_F(TestTraceProfiler, RingBuffer)
+{
+  CTraceProfiler::Instance().Start();
+  {
+    TRACE_SCOPE("oldest");
+  }
+  // overwrite the oldest event, the latest ones are kept
+  for (int i = 0; i < 10000; i++)
+    TRACE_SCOPE("newest");
+  EXPECT_EQ(0.0, CTraceProfiler::Instance().GetPercentile("oldest", 50));
+  EXPECT_GT(CTraceProfiler::Instance().GetPercentile("newest", 100), 0.0);
+}
+
+TEST_F(TestTraceProfiler, SaveResults)
+{
+  XFILE::CFile *tmpfile;
+  ASSERT_NE(nullptr, (tmpfile = XBMC_CREATETEMPFILE(".json")));
+  std::string path = XBMC_TEMPFILEPATH(tmpfile);
+  tmpfile->Close();
+
+  CTraceProfiler::Instance().Start();
+  CTestTraceThread thread;
+  thread.Create();
+  {
+    TRACE_SCOPE("main");
+  }
+  thread.StopThread(true);
+  CTraceProfiler::Instance().EndFrame();
+  CTraceProfiler::Instance().Stop();
+
+  CTraceProfiler::Instance().SetOutputFile(path);
+  EXPECT_TRUE(CTraceProfiler::Instance().SaveResults());
+
+  XFILE::CFile file;
+  XUTILS::auto_buffer buffer;
+  ASSERT_GT(file.LoadFile(path, buffer), 0);
+  CVariant trace = CJSONVariantParser::Parse(std::string(buffer.get(), buffer.size()));
+  ASSERT_TRUE(trace["traceEvents"].isArray());
+
+  int worker = 0, main = 0, frame = 0;
+  for (auto it = trace["traceEvents"].begin_array(); it != trace["traceEvents"].end_array(); ++it)
+  {
+    EXPECT_EQ("X", (*it)["ph"].asString());
+    EXPECT_GE((*it)["dur"].asDouble(), 0.0);
+    if ((*it)["name"].asString() == "worker")
+      worker++;
+    else if ((*it)["name"].asString() == "main")
+      main++;
+    else if ((*it)["name"].asString() == "Frame")
+      frame++;
+  }
+  EXPECT_EQ(100, worker);
+  EXPECT_EQ(1, main);
+  EXPECT_EQ(1, frame);
+
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(tmpfile));
+}
+
+TEST_F(TestTraceProfiler, ReusesBufferOfExitedThread)
+{
+  CTraceProfiler::Instance().Start();
+  for (int i = 0; i < 2; i++)
+  {
+    CTestTraceThread thread;
+    thread.Create();
+    thread.StopThread(true);
+  }
+  CTraceProfiler::Instance().Stop();
+
+  CVariant trace = SaveTrace();
+  ASSERT_TRUE(trace.isArray());
+
+  // the second thread records into the buffer the first one left, keeping its events
+  int worker = 0;
+  std::set<unsigned int> threads;
+  for (auto it = trace.begin_array(); it != trace.end_array(); ++it)
+  {
+    if ((*it)["name"].asString() == "worker")
+    {
+      worker++;
+      threads.insert((*it)["tid"].asUnsignedInteger());
+    }
+  }
+  EXPECT_EQ(200, worker);
+  EXPECT_EQ(1U, threads.size());
+}
+
+TEST_F(TestTraceProfiler, EndFrameFromSeveralThreads)
+{
+  CTraceProfiler::Instance().SetMaxFrameCount(100);
+  CTraceProfiler::Instance().Start();
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++)
+  {
+    threads.emplace_back([]()
+    {
+      for (int j = 0; j < 50; j++)
+        CTraceProfiler::Instance().EndFrame();
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  // the run stops after exactly the configured number of frames
+  EXPECT_FALSE(CTraceProfiler::IsRunning());
+  CVariant trace = SaveTrace();
+  ASSERT_TRUE(trace.isArray());
+  int frame = 0;
+  for (auto it = trace.begin_array(); it != trace.end_array(); ++it)
+  {
+    if ((*it)["name"].asString() == "Frame")
+      frame++;
+  }
+  EXPECT_EQ(100, frame);
+}
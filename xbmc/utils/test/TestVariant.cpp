@@ -18,8 +18,12 @@
  *
  */
 
+#include "threads/SystemClock.h"
 #include "utils/Variant.h"
 
+#include <cstring>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 TEST(TestVariant, VariantTypeInteger)
@@ -348,3 +352,133 @@ TEST(TestVariant, isMember)
   EXPECT_TRUE(a.isMember("key1"));
   EXPECT_FALSE(a.isMember("key2"));
 }
+
+TEST(TestVariant, stringsMoveAndSwap)
+{
+  std::string longString(100, 'x');
+  CVariant a("short"), b(longString), c(L"wide");
+
+  CVariant d(std::move(b));
+  EXPECT_TRUE(b.isNull());
+  EXPECT_STREQ(longString.c_str(), d.c_str());
+
+  a.swap(d);
+  EXPECT_STREQ(longString.c_str(), a.c_str());
+  EXPECT_STREQ("short", d.c_str());
+
+  c.swap(d);
+  EXPECT_STREQ("short", c.c_str());
+  EXPECT_TRUE(d.isWideString());
+  EXPECT_TRUE(d.asWideString() == L"wide");
+
+  CVariant e;
+  e = a;
+  a = d;
+  EXPECT_STREQ(longString.c_str(), e.c_str());
+  EXPECT_TRUE(a.asWideString() == L"wide");
+
+  e = 5;
+  EXPECT_EQ(5, e.asInteger());
+}
+
+TEST(TestVariant, nestedStrings)
+{
+  CVariant a;
+  for (int i = 0; i < 100; i++)
+    a["items"].push_back(CVariant(std::string(i, 'a')));
+
+  CVariant b = a;
+  a.clear();
+  ASSERT_EQ(100U, b["items"].size());
+  EXPECT_EQ(42U, b["items"][42].size());
+  EXPECT_STREQ(std::string(99, 'a').c_str(), b["items"][99].c_str());
+}
+
+TEST(TestVariant, shortStrings)
+{
+  // a variant stays as small as a pointer plus its type
+  EXPECT_LE(sizeof(CVariant), 2 * sizeof(uint64_t));
+
+  for (size_t length = 0; length < 12; length++)
+  {
+    std::string str(length, 'b');
+    CVariant a(str), b(str.c_str()), c{std::string(str)};
+    EXPECT_STREQ(str.c_str(), a.c_str());
+    EXPECT_EQ(str, b.asString());
+    EXPECT_EQ(length, c.size());
+    EXPECT_EQ(length == 0, c.empty());
+    EXPECT_TRUE(a == b);
+    EXPECT_TRUE(a == c);
+
+    CVariant d(a);
+    a.clear();
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(str, d.asString());
+  }
+
+  CVariant withNul(std::string("a\0b", 3));
+  EXPECT_EQ(3U, withNul.size());
+  EXPECT_TRUE(withNul.asString() == std::string("a\0b", 3));
+  EXPECT_FALSE(withNul == CVariant("a"));
+
+  EXPECT_EQ(1234567, CVariant("1234567").asInteger());
+  EXPECT_EQ(123456789U, CVariant("123456789").asUnsignedInteger());
+  EXPECT_FALSE(CVariant("false").asBoolean());
+  EXPECT_TRUE(CVariant("true").asBoolean());
+}
+
+TEST(TestVariant, shortStringThroughput)
+{
+  // copies of short strings stay inside the variants
+  const unsigned int strings = 1000000;
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  std::vector<CVariant> values;
+  values.reserve(strings);
+  for (unsigned int i = 0; i < strings; i++)
+    values.push_back(CVariant("movie"));
+
+  std::vector<CVariant> copies(values);
+  size_t length = 0;
+  for (std::vector<CVariant>::const_iterator value = copies.begin(); value != copies.end(); ++value)
+    length += value->size();
+  unsigned int elapsed = XbmcThreads::SystemClockMillis() - start;
+
+  EXPECT_EQ(strings * 5, length);
+
+  // allocating every string on the heap took about three times as long
+  RecordProperty("elapsed_ms", elapsed);
+  EXPECT_LT(elapsed, 1000U);
+}
+
+TEST(TestVariant, listingThroughput)
+{
+  // listings are mostly made of short keys and values like the ones of a
+  // JSON-RPC response, which are copied around before being written
+  const unsigned int items = 50000;
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  CVariant list(CVariant::VariantTypeArray);
+  for (unsigned int i = 0; i < items; i++)
+  {
+    CVariant item;
+    item["label"] = "Item";
+    item["type"] = "movie";
+    item["playcount"] = i % 3;
+    item["genre"].push_back("Drama");
+    item["genre"].push_back("Comedy");
+    list.push_back(std::move(item));
+  }
+
+  CVariant copy(list);
+  size_t length = 0;
+  for (CVariant::const_iterator_array item = copy.begin_array(); item != copy.end_array(); ++item)
+    length += strlen((*item)["type"].c_str()) + strlen((*item)["genre"][1].c_str());
+  unsigned int elapsed = XbmcThreads::SystemClockMillis() - start;
+
+  EXPECT_EQ(items * 11, length);
+
+  // leaves plenty of room for debug builds
+  RecordProperty("elapsed_ms", elapsed);
+  EXPECT_LT(elapsed, 2000U);
+}
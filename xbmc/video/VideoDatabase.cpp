@@ -77,8 +77,99 @@ using namespace VIDEO;
 using namespace ADDON;
 using namespace KODI::MESSAGING;
 
+namespace
+{
+std::string VideoField(int column)
+{
+  return StringUtils::Format("c%02d", column);
+}
+
+// navigation nodes whose item counts are kept in the navsummary table
+const char *NavSummaryLinks[] = { "genre", "country", "studio", "tag" };
+
+// media types counted per navigation node and the navsummary columns holding them
+struct NavSummaryMedia
+{
+  const char *mediaType;
+  const char *idField;
+  const char *totalField;
+  const char *watchedField; // nullptr if the watched state isn't needed for the node
+};
+
+const NavSummaryMedia NavSummaryMediaTypes[] = {
+  { MediaTypeMovie,      "idMovie",  "movies",      "movies_watched" },
+  { MediaTypeTvShow,     "idShow",   "tvshows",     nullptr },
+  { MediaTypeMusicVideo, "idMVideo", "musicvideos", "musicvideos_watched" },
+};
+
+// trigger statement counting a row inserted into or deleted from a link table.
+// Watched items only count while the item itself still exists, deleting a
+// movie or music video takes care of its watched counts before its links go.
+std::string NavSummaryLinkSQL(const char *link, bool insert)
+{
+  const char *row = insert ? "new" : "old";
+  const char *op = insert ? "+" : "-";
+  std::string sql = "UPDATE navsummary SET ";
+  for (const auto &media : NavSummaryMediaTypes)
+  {
+    if (&media != NavSummaryMediaTypes)
+      sql += ", ";
+    sql += StringUtils::Format("%s=%s%s(%s.media_type='%s')", media.totalField, media.totalField, op, row, media.mediaType);
+    if (media.watchedField)
+      sql += StringUtils::Format(", %s=%s%s(%s.media_type='%s' AND EXISTS (SELECT 1 FROM %s JOIN files ON files.idFile=%s.idFile "
+                                 "WHERE %s.%s=%s.media_id AND files.playCount IS NOT NULL))",
+                                 media.watchedField, media.watchedField, op, row, media.mediaType, media.mediaType, media.mediaType,
+                                 media.mediaType, media.idField, row);
+  }
+  sql += StringUtils::Format(" WHERE link_type='%s' AND link_id=%s.%s_id; ", link, row, link);
+  return sql;
+}
+
+// trigger statements removing a deleted movie or music video from the watched counts
+std::string NavSummaryMediaDeleteSQL(const NavSummaryMedia &media)
+{
+  std::string sql;
+  for (const char *link : NavSummaryLinks)
+    sql += StringUtils::Format("UPDATE navsummary SET %s=%s-1 WHERE link_type='%s' "
+                               "AND link_id IN (SELECT %s_id FROM %s_link WHERE media_id=old.%s AND media_type='%s') "
+                               "AND EXISTS (SELECT 1 FROM files WHERE files.idFile=old.idFile AND files.playCount IS NOT NULL); ",
+                               media.watchedField, media.watchedField, link,
+                               link, link, media.idField, media.mediaType);
+  return sql;
+}
+
+// trigger statements following the watched state of an updated or deleted file
+std::string NavSummaryFileSQL(bool update)
+{
+  std::string sql;
+  for (const auto &media : NavSummaryMediaTypes)
+  {
+    if (!media.watchedField)
+      continue;
+
+    for (const char *link : NavSummaryLinks)
+    {
+      std::string items = StringUtils::Format("link_type='%s' AND link_id IN (SELECT %s_link.%s_id FROM %s_link "
+                                              "JOIN %s ON %s.%s=%s_link.media_id WHERE %s_link.media_type='%s' AND %s.idFile=%s.idFile)",
+                                              link, link, link, link,
+                                              media.mediaType, media.mediaType, media.idField, link, link, media.mediaType,
+                                              media.mediaType, update ? "new" : "old");
+      if (update)
+        sql += StringUtils::Format("UPDATE navsummary SET %s=%s+(new.playCount IS NOT NULL)-(old.playCount IS NOT NULL) "
+                                   "WHERE (new.playCount IS NULL)<>(old.playCount IS NULL) AND %s; ",
+                                   media.watchedField, media.watchedField, items.c_str());
+      else
+        sql += StringUtils::Format("UPDATE navsummary SET %s=%s-1 WHERE old.playCount IS NOT NULL AND %s; ",
+                                   media.watchedField, media.watchedField, items.c_str());
+    }
+  }
+  return sql;
+}
+}
+
 //********************************************************************************************************************************
 CVideoDatabase::CVideoDatabase(void)
+  : m_deferLibraryFlags(false)
 {
 }
 
@@ -203,6 +294,12 @@ void CVideoDatabase::CreateTables()
 
   CLog::Log(LOGINFO, "create uniqueid table");
   m_pDS->exec("CREATE TABLE uniqueid (uniqueid_id INTEGER PRIMARY KEY, media_id INTEGER, media_type TEXT, value TEXT, type TEXT)");
+
+  CLog::Log(LOGINFO, "create navsummary table");
+  m_pDS->exec("CREATE TABLE navsummary (link_type TEXT, link_id INTEGER, movies INTEGER, movies_watched INTEGER, tvshows INTEGER, musicvideos INTEGER, musicvideos_watched INTEGER)");
+
+  CLog::Log(LOGINFO, "create pathfingerprint table");
+  m_pDS->exec("CREATE TABLE pathfingerprint (idFingerprint INTEGER PRIMARY KEY, strPath TEXT, iTime INTEGER, strSubPaths TEXT, strHash TEXT)");
 }
 
 void CVideoDatabase::CreateLinkIndex(const char *table)
@@ -282,8 +379,12 @@ void CVideoDatabase::CreateAnalytics()
   CreateLinkIndex("genre");
   CreateLinkIndex("country");
 
+  m_pDS->exec("CREATE UNIQUE INDEX ix_navsummary ON navsummary (link_type(20), link_id)");
+  m_pDS->exec("CREATE INDEX ix_pathfingerprint ON pathfingerprint (strPath(255))");
+
   CLog::Log(LOGINFO, "%s - creating triggers", __FUNCTION__);
-  m_pDS->exec("CREATE TRIGGER delete_movie AFTER DELETE ON movie FOR EACH ROW BEGIN "
+  m_pDS->exec("CREATE TRIGGER delete_movie AFTER DELETE ON movie FOR EACH ROW BEGIN " +
+              NavSummaryMediaDeleteSQL(NavSummaryMediaTypes[0]) +
               "DELETE FROM genre_link WHERE media_id=old.idMovie AND media_type='movie'; "
               "DELETE FROM actor_link WHERE media_id=old.idMovie AND media_type='movie'; "
               "DELETE FROM director_link WHERE media_id=old.idMovie AND media_type='movie'; "
@@ -309,7 +410,8 @@ void CVideoDatabase::CreateAnalytics()
               "DELETE FROM rating WHERE media_id=old.idShow AND media_type='tvshow'; "
               "DELETE FROM uniqueid WHERE media_id=old.idShow AND media_type='tvshow'; "
               "END");
-  m_pDS->exec("CREATE TRIGGER delete_musicvideo AFTER DELETE ON musicvideo FOR EACH ROW BEGIN "
+  m_pDS->exec("CREATE TRIGGER delete_musicvideo AFTER DELETE ON musicvideo FOR EACH ROW BEGIN " +
+              NavSummaryMediaDeleteSQL(NavSummaryMediaTypes[2]) +
               "DELETE FROM actor_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
               "DELETE FROM director_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
               "DELETE FROM genre_link WHERE media_id=old.idMVideo AND media_type='musicvideo'; "
@@ -334,19 +436,78 @@ void CVideoDatabase::CreateAnalytics()
   m_pDS->exec("CREATE TRIGGER delete_person AFTER DELETE ON actor FOR EACH ROW BEGIN "
               "DELETE FROM art WHERE media_id=old.actor_id AND media_type IN ('actor','artist','writer','director'); "
               "END");
-  m_pDS->exec("CREATE TRIGGER delete_tag AFTER DELETE ON tag_link FOR EACH ROW BEGIN "
+  m_pDS->exec("CREATE TRIGGER delete_tag AFTER DELETE ON tag_link FOR EACH ROW BEGIN " +
+              NavSummaryLinkSQL("tag", false) +
               "DELETE FROM tag WHERE tag_id=old.tag_id AND tag_id NOT IN (SELECT DISTINCT tag_id FROM tag_link); "
               "END");
   m_pDS->exec("CREATE TRIGGER delete_file AFTER DELETE ON files FOR EACH ROW BEGIN "
               "DELETE FROM bookmark WHERE idFile=old.idFile; "
               "DELETE FROM settings WHERE idFile=old.idFile; "
               "DELETE FROM stacktimes WHERE idFile=old.idFile; "
-              "DELETE FROM streamdetails WHERE idFile=old.idFile; "
+              "DELETE FROM streamdetails WHERE idFile=old.idFile; " +
+              NavSummaryFileSQL(false) +
               "END");
 
+  CreateNavSummaryTriggers();
+
+  CLog::Log(LOGINFO, "%s - creating search indices", __FUNCTION__);
+  CreateSearchIndex("movie", "idMovie", { VideoField(VIDEODB_ID_TITLE), VideoField(VIDEODB_ID_PLOT), VideoField(VIDEODB_ID_PLOTOUTLINE), VideoField(VIDEODB_ID_TAGLINE) });
+  CreateSearchIndex("tvshow", "idShow", { VideoField(VIDEODB_ID_TV_TITLE) });
+  CreateSearchIndex("episode", "idEpisode", { VideoField(VIDEODB_ID_EPISODE_TITLE), VideoField(VIDEODB_ID_EPISODE_PLOT) });
+  CreateSearchIndex("musicvideo", "idMVideo", { VideoField(VIDEODB_ID_MUSICVIDEO_TITLE) });
+  CreateSearchIndex("actor", "actor_id", { "name" });
+
   CreateViews();
 }
 
+void CVideoDatabase::CreateNavSummaryTriggers()
+{
+  for (const char *link : NavSummaryLinks)
+  {
+    m_pDS->exec(PrepareSQL("CREATE TRIGGER navsummary_insert_%s AFTER INSERT ON %s FOR EACH ROW BEGIN "
+                           "INSERT INTO navsummary (link_type, link_id, movies, movies_watched, tvshows, musicvideos, musicvideos_watched) "
+                           "VALUES ('%s', new.%s_id, 0, 0, 0, 0, 0); "
+                           "END", link, link, link, link));
+    m_pDS->exec(PrepareSQL("CREATE TRIGGER navsummary_delete_%s AFTER DELETE ON %s FOR EACH ROW BEGIN "
+                           "DELETE FROM navsummary WHERE link_type='%s' AND link_id=old.%s_id; "
+                           "END", link, link, link, link));
+    m_pDS->exec(StringUtils::Format("CREATE TRIGGER navsummary_insert_%s_link AFTER INSERT ON %s_link FOR EACH ROW BEGIN ", link, link) +
+                NavSummaryLinkSQL(link, true) +
+                "END");
+    // deleting a tag link is already handled by the delete_tag trigger
+    if (std::string(link) != "tag")
+      m_pDS->exec(StringUtils::Format("CREATE TRIGGER navsummary_delete_%s_link AFTER DELETE ON %s_link FOR EACH ROW BEGIN ", link, link) +
+                  NavSummaryLinkSQL(link, false) +
+                  "END");
+  }
+  m_pDS->exec("CREATE TRIGGER navsummary_update_file AFTER UPDATE ON files FOR EACH ROW BEGIN " +
+              NavSummaryFileSQL(true) +
+              "END");
+}
+
+void CVideoDatabase::RebuildNavSummary()
+{
+  m_pDS->exec("DELETE FROM navsummary");
+  for (const char *link : NavSummaryLinks)
+  {
+    std::string columns;
+    for (const auto &media : NavSummaryMediaTypes)
+    {
+      std::string items = PrepareSQL("FROM %s_link JOIN %s ON %s.%s=%s_link.media_id WHERE %s_link.%s_id=%s.%s_id AND %s_link.media_type='%s'",
+                                     link, media.mediaType, media.mediaType, media.idField, link,
+                                     link, link, link, link, link, media.mediaType);
+      columns += ", (SELECT COUNT(1) " + items + ")";
+      if (media.watchedField)
+        columns += PrepareSQL(", (SELECT COUNT(files.playCount) FROM %s_link JOIN %s ON %s.%s=%s_link.media_id JOIN files ON files.idFile=%s.idFile "
+                              "WHERE %s_link.%s_id=%s.%s_id AND %s_link.media_type='%s')",
+                              link, media.mediaType, media.mediaType, media.idField, link, media.mediaType,
+                              link, link, link, link, link, media.mediaType);
+    }
+    m_pDS->exec(PrepareSQL("INSERT INTO navsummary (link_type, link_id, movies, movies_watched, tvshows, musicvideos, musicvideos_watched) "
+                           "SELECT '%s', %s.%s_id", link, link, link) + columns + PrepareSQL(" FROM %s", link));
+  }
+}
+
 void CVideoDatabase::CreateViews()
 {
   CLog::Log(LOGINFO, "create episode_view");
@@ -780,6 +941,96 @@ bool CVideoDatabase::GetPathHash(const std::string &path, std::string &hash)
   return false;
 }
 
+bool CVideoDatabase::GetPathFingerprint(const std::string &path, int64_t &time, std::vector<std::string> &subPaths, std::string &hash)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    std::string strSQL = PrepareSQL("SELECT iTime, strSubPaths, strHash FROM pathfingerprint WHERE strPath='%s'", path.c_str());
+    m_pDS->query(strSQL);
+    if (m_pDS->num_rows() == 0)
+    {
+      m_pDS->close();
+      return false;
+    }
+
+    time = m_pDS->fv(0).get_asInt64();
+    subPaths = StringUtils::Split(m_pDS->fv(1).get_asString(), "\n");
+    hash = m_pDS->fv(2).get_asString();
+    m_pDS->close();
+
+    // Split() returns a single empty string for an empty list
+    if (subPaths.size() == 1 && subPaths[0].empty())
+      subPaths.clear();
+
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, path.c_str());
+  }
+
+  return false;
+}
+
+bool CVideoDatabase::SetPathFingerprint(const std::string &path, int64_t time, const std::vector<std::string> &subPaths, const std::string &hash)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    std::string strSubPaths = StringUtils::Join(subPaths, "\n");
+    std::string strSQL = PrepareSQL("SELECT idFingerprint FROM pathfingerprint WHERE strPath='%s'", path.c_str());
+    m_pDS->query(strSQL);
+    if (m_pDS->num_rows() > 0)
+    {
+      int idFingerprint = m_pDS->fv(0).get_asInt();
+      m_pDS->close();
+      strSQL = PrepareSQL("UPDATE pathfingerprint SET iTime=%" PRId64", strSubPaths='%s', strHash='%s' WHERE idFingerprint=%i",
+                          time, strSubPaths.c_str(), hash.c_str(), idFingerprint);
+    }
+    else
+    {
+      m_pDS->close();
+      strSQL = PrepareSQL("INSERT INTO pathfingerprint (strPath, iTime, strSubPaths, strHash) VALUES ('%s', %" PRId64", '%s', '%s')",
+                          path.c_str(), time, strSubPaths.c_str(), hash.c_str());
+    }
+    m_pDS->exec(strSQL);
+
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, path.c_str());
+  }
+
+  return false;
+}
+
+bool CVideoDatabase::RemovePathFingerprints(const std::string &path)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    std::string strSQL = PrepareSQL("DELETE FROM pathfingerprint WHERE SUBSTR(strPath, 1, %i) = '%s'",
+                                    StringUtils::utf8_strlen(path.c_str()), path.c_str());
+    m_pDS->exec(strSQL);
+
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, path.c_str());
+  }
+
+  return false;
+}
+
 bool CVideoDatabase::GetSourcePath(const std::string &path, std::string &sourcePath)
 {
   SScanSettings dummy;
@@ -1435,6 +1686,88 @@ int CVideoDatabase::AddToTable(const std::string& table, const std::string& firs
   return -1;
 }
 
+std::vector<int> CVideoDatabase::AddToTable(const std::string& table, const std::vector<std::string>& values)
+{
+  std::vector<int> ids(values.size(), -1);
+  try
+  {
+    if (NULL == m_pDB.get()) return ids;
+    if (NULL == m_pDS.get()) return ids;
+
+    // ids aren't kept across calls, as values may be removed by cleanups or other writers
+    std::map<std::string, int> known;
+
+    std::vector<std::string> missing;
+    for (const auto &i : values)
+    {
+      std::string name = i.substr(0, 255);
+      if (!name.empty() && known.find(name) == known.end() &&
+          std::find(missing.begin(), missing.end(), name) == missing.end())
+        missing.push_back(name);
+    }
+
+    // look all values up at once, add the ones that weren't found and look those up again
+    for (int pass = 0; pass < 2 && !missing.empty(); ++pass)
+    {
+      if (pass > 0)
+      {
+        std::set<std::string> added;
+        std::vector<std::string> rows;
+        for (const auto &name : missing)
+        {
+          // names only differing in case would be matched by the LIKE below
+          std::string lower = name;
+          StringUtils::ToLower(lower);
+          if (added.insert(lower).second)
+            rows.push_back(PrepareSQL("NULL, '%s'", name.c_str()));
+        }
+        ExecuteInsertRows(PrepareSQL("INSERT INTO %s (%s_id, name)", table.c_str(), table.c_str()), rows);
+      }
+
+      // one SELECT per name keeps the LIKE matching of AddToTable() above, and
+      // tags every row with the name it belongs to
+      static const size_t namesPerQuery = 100;
+      for (size_t first = 0; first < missing.size(); first += namesPerQuery)
+      {
+        std::string sql;
+        size_t last = std::min(missing.size(), first + namesPerQuery);
+        for (size_t i = first; i < last; ++i)
+        {
+          if (!sql.empty())
+            sql += " UNION ALL ";
+          sql += PrepareSQL("SELECT %i, %s_id FROM %s WHERE name LIKE '%s'",
+                            static_cast<int>(i), table.c_str(), table.c_str(), missing[i].c_str());
+        }
+
+        m_pDS->query(sql);
+        while (!m_pDS->eof())
+        {
+          known.insert(std::make_pair(missing[m_pDS->fv(0).get_asInt()], m_pDS->fv(1).get_asInt()));
+          m_pDS->next();
+        }
+        m_pDS->close();
+      }
+
+      missing.erase(std::remove_if(missing.begin(), missing.end(),
+                                   [&known](const std::string &name) { return known.find(name) != known.end(); }),
+                    missing.end());
+    }
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      auto id = known.find(values[i].substr(0, 255));
+      if (id != known.end())
+        ids[i] = id->second;
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, table.c_str());
+  }
+
+  return ids;
+}
+
 int CVideoDatabase::UpdateRatings(int mediaId, const char *mediaType, const RatingMap& values, const std::string& defaultRating)
 {
   try
@@ -1600,73 +1933,49 @@ int CVideoDatabase::AddTag(const std::string& name)
   return AddToTable("tag", "tag_id", "name", name);
 }
 
-int CVideoDatabase::AddActor(const std::string& name, const std::string& thumbURLs, const std::string &thumb)
-{
-  try
-  {
-    if (NULL == m_pDB.get()) return -1;
-    if (NULL == m_pDS.get()) return -1;
-    int idActor = -1;
-
-    // ATTENTION: the trimming of actor names should really not be done here but after the scraping / NFO-parsing
-    std::string trimmedName = name.c_str();
-    StringUtils::Trim(trimmedName);
-
-    std::string strSQL=PrepareSQL("select actor_id from actor where name like '%s'", trimmedName.substr(0, 255).c_str());
-    m_pDS->query(strSQL);
-    if (m_pDS->num_rows() == 0)
-    {
-      m_pDS->close();
-      // doesnt exists, add it
-      strSQL=PrepareSQL("insert into actor (actor_id, name, art_urls) values(NULL, '%s', '%s')", trimmedName.substr(0,255).c_str(), thumbURLs.c_str());
-      m_pDS->exec(strSQL);
-      idActor = (int)m_pDS->lastinsertid();
-    }
-    else
-    {
-      idActor = m_pDS->fv(0).get_asInt();
-      m_pDS->close();
-      // update the thumb url's
-      if (!thumbURLs.empty())
-      {
-        strSQL=PrepareSQL("update actor set art_urls = '%s' where actor_id = %i", thumbURLs.c_str(), idActor);
-        m_pDS->exec(strSQL);
-      }
-    }
-    // add artwork
-    if (!thumb.empty())
-      SetArtForItem(idActor, "actor", "thumb", thumb);
-    return idActor;
-  }
-  catch (...)
-  {
-    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, name.c_str() );
-  }
-  return -1;
-}
-
-
-
-void CVideoDatabase::AddLinkToActor(int mediaId, const char *mediaType, int actorId, const std::string &role, int order)
+void CVideoDatabase::AddToLinkTable(int mediaId, const std::string& mediaType, const std::string& table, int valueId, const char *foreignKey)
 {
-  std::string sql=PrepareSQL("SELECT 1 FROM actor_link WHERE actor_id=%i AND media_id=%i AND media_type='%s'", actorId, mediaId, mediaType);
+  const char *key = foreignKey ? foreignKey : table.c_str();
+  std::string sql = PrepareSQL("SELECT 1 FROM %s_link WHERE %s_id=%i AND media_id=%i AND media_type='%s'", table.c_str(), key, valueId, mediaId, mediaType.c_str());
 
   if (GetSingleValue(sql).empty())
   { // doesnt exists, add it
-    sql = PrepareSQL("INSERT INTO actor_link (actor_id, media_id, media_type, role, cast_order) VALUES(%i,%i,'%s','%s',%i)", actorId, mediaId, mediaType, role.c_str(), order);
+    sql = PrepareSQL("INSERT INTO %s_link (%s_id,media_id,media_type) VALUES(%i,%i,'%s')", table.c_str(), key, valueId, mediaId, mediaType.c_str());
     ExecuteQuery(sql);
   }
 }
 
-void CVideoDatabase::AddToLinkTable(int mediaId, const std::string& mediaType, const std::string& table, int valueId, const char *foreignKey)
+void CVideoDatabase::AddToLinkTable(int mediaId, const std::string& mediaType, const std::string& table, const std::vector<int>& valueIds, const char *foreignKey)
 {
+  if (valueIds.empty())
+    return;
+
   const char *key = foreignKey ? foreignKey : table.c_str();
-  std::string sql = PrepareSQL("SELECT 1 FROM %s_link WHERE %s_id=%i AND media_id=%i AND media_type='%s'", table.c_str(), key, valueId, mediaId, mediaType.c_str());
+  try
+  {
+    if (NULL == m_pDB.get()) return;
+    if (NULL == m_pDS.get()) return;
 
-  if (GetSingleValue(sql).empty())
-  { // doesnt exists, add it
-    sql = PrepareSQL("INSERT INTO %s_link (%s_id,media_id,media_type) VALUES(%i,%i,'%s')", table.c_str(), key, valueId, mediaId, mediaType.c_str());
-    ExecuteQuery(sql);
+    std::set<int> linked;
+    m_pDS->query(PrepareSQL("SELECT %s_id FROM %s_link WHERE media_id=%i AND media_type='%s'", key, table.c_str(), mediaId, mediaType.c_str()));
+    while (!m_pDS->eof())
+    {
+      linked.insert(m_pDS->fv(0).get_asInt());
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    std::vector<std::string> rows;
+    for (const auto &i : valueIds)
+    {
+      if (i > -1 && linked.insert(i).second)
+        rows.push_back(PrepareSQL("%i,%i,'%s'", i, mediaId, mediaType.c_str()));
+    }
+    ExecuteInsertRows(PrepareSQL("INSERT INTO %s_link (%s_id,media_id,media_type)", table.c_str(), key), rows);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%i - %s - %s) failed", __FUNCTION__, mediaId, mediaType.c_str(), table.c_str());
   }
 }
 
@@ -1680,15 +1989,7 @@ void CVideoDatabase::RemoveFromLinkTable(int mediaId, const std::string& mediaTy
 
 void CVideoDatabase::AddLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
 {
-  for (const auto &i : values)
-  {
-    if (!i.empty())
-    {
-      int idValue = AddToTable(field, field + "_id", "name", i);
-      if (idValue > -1)
-        AddToLinkTable(mediaId, mediaType, field, idValue);
-    }
-  }
+  AddToLinkTable(mediaId, mediaType, field, AddToTable(field, values));
 }
 
 void CVideoDatabase::UpdateLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
@@ -1701,15 +2002,12 @@ void CVideoDatabase::UpdateLinksToItem(int mediaId, const std::string& mediaType
 
 void CVideoDatabase::AddActorLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
 {
-  for (const auto &i : values)
-  {
-    if (!i.empty())
-    {
-      int idValue = AddActor(i, "");
-      if (idValue > -1)
-        AddToLinkTable(mediaId, mediaType, field, idValue, "actor");
-    }
-  }
+  // ATTENTION: the trimming of actor names should really not be done here but after the scraping / NFO-parsing
+  std::vector<std::string> names(values);
+  for (auto &i : names)
+    StringUtils::Trim(i);
+
+  AddToLinkTable(mediaId, mediaType, field, AddToTable("actor", names), "actor");
 }
 
 void CVideoDatabase::UpdateActorLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
@@ -1751,11 +2049,50 @@ void CVideoDatabase::AddCast(int mediaId, const char *mediaType, const std::vect
   if (cast.empty())
     return;
 
-  int order = std::max_element(cast.begin(), cast.end())->order;
+  // ATTENTION: the trimming of actor names should really not be done here but after the scraping / NFO-parsing
+  std::vector<std::string> names;
   for (const auto &i : cast)
   {
-    int idActor = AddActor(i.strName, i.thumbUrl.m_xml, i.thumb);
-    AddLinkToActor(mediaId, mediaType, idActor, i.strRole, i.order >= 0 ? i.order : ++order);
+    names.push_back(i.strName);
+    StringUtils::Trim(names.back());
+  }
+  std::vector<int> ids = AddToTable("actor", names);
+
+  try
+  {
+    std::set<int> linked;
+    m_pDS->query(PrepareSQL("SELECT actor_id FROM actor_link WHERE media_id=%i AND media_type='%s'", mediaId, mediaType));
+    while (!m_pDS->eof())
+    {
+      linked.insert(m_pDS->fv(0).get_asInt());
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    std::vector<std::string> rows;
+    int order = std::max_element(cast.begin(), cast.end())->order;
+    for (size_t i = 0; i < cast.size(); ++i)
+    {
+      const SActorInfo &actor = cast[i];
+      int castOrder = actor.order >= 0 ? actor.order : ++order;
+      int idActor = ids[i];
+      if (idActor < 0)
+        continue;
+
+      // update the thumb url's
+      if (!actor.thumbUrl.m_xml.empty())
+        ExecuteQuery(PrepareSQL("UPDATE actor SET art_urls = '%s' WHERE actor_id = %i", actor.thumbUrl.m_xml.c_str(), idActor));
+      if (!actor.thumb.empty())
+        SetArtForItem(idActor, "actor", "thumb", actor.thumb);
+
+      if (linked.insert(idActor).second)
+        rows.push_back(PrepareSQL("%i,%i,'%s','%s',%i", idActor, mediaId, mediaType, actor.strRole.c_str(), castOrder));
+    }
+    ExecuteInsertRows("INSERT INTO actor_link (actor_id, media_id, media_type, role, cast_order)", rows);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%i - %s) failed", __FUNCTION__, mediaId, mediaType);
   }
 }
 
@@ -5161,11 +5498,20 @@ void CVideoDatabase::UpdateTables(int iVersion)
       pDS->close();
     }
   }
+
+  if (iVersion < 109)
+  {
+    m_pDS->exec("CREATE TABLE navsummary (link_type TEXT, link_id INTEGER, movies INTEGER, movies_watched INTEGER, tvshows INTEGER, musicvideos INTEGER, musicvideos_watched INTEGER)");
+    RebuildNavSummary();
+  }
+
+  if (iVersion < 111)
+    m_pDS->exec("CREATE TABLE pathfingerprint (idFingerprint INTEGER PRIMARY KEY, strPath TEXT, iTime INTEGER, strSubPaths TEXT, strHash TEXT)");
 }
 
 int CVideoDatabase::GetSchemaVersion() const
 {
-  return 108;
+  return 111;
 }
 
 bool CVideoDatabase::LookupByFolders(const std::string &path, bool shows)
@@ -5502,6 +5848,13 @@ bool CVideoDatabase::GetNavCommon(const std::string& strBaseDir, CFileItemList&
 
     std::string strSQL;
     Filter extFilter = filter;
+
+    // unfiltered nodes are listed from the precomputed navsummary counts
+    CVideoDbUrl navUrl;
+    bool useSummary = (filter.fields.empty() || filter.fields == "*") && filter.join.empty() && filter.where.empty() &&
+                      filter.group.empty() && filter.order.empty() && filter.limit.empty() &&
+                      navUrl.FromString(strBaseDir) && navUrl.GetOptions().empty();
+
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
     {
       std::string view, view_id, media_type, extraField, extraJoin;
@@ -5540,6 +5893,30 @@ bool CVideoDatabase::GetNavCommon(const std::string& strBaseDir, CFileItemList&
       extFilter.AppendJoin("JOIN path ON path.idPath = files.idPath");
       extFilter.AppendJoin(extraJoin);
     }
+    else if (useSummary)
+    {
+      std::string column, extraField;
+      if (idContent == VIDEODB_CONTENT_MOVIES)
+      {
+        column     = "movies";
+        extraField = "navsummary.movies, navsummary.movies_watched";
+      }
+      else if (idContent == VIDEODB_CONTENT_TVSHOWS)
+        column     = "tvshows";
+      else if (idContent == VIDEODB_CONTENT_MUSICVIDEOS)
+      {
+        column     = "musicvideos";
+        extraField = "navsummary.musicvideos, navsummary.musicvideos_watched";
+      }
+      else
+        return false;
+
+      strSQL = "SELECT %s " + PrepareSQL("FROM %s ", type);
+      extFilter.fields = PrepareSQL("%s.%s_id, %s.name", type, type, type);
+      extFilter.AppendField(extraField);
+      extFilter.AppendJoin(PrepareSQL("JOIN navsummary ON navsummary.link_type='%s' AND navsummary.link_id = %s.%s_id", type, type, type));
+      extFilter.AppendWhere(PrepareSQL("navsummary.%s > 0", column.c_str()));
+    }
     else
     {
       std::string view, view_id, media_type, extraField, extraJoin;
@@ -6649,6 +7026,56 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
+    auto addMovie = [&](const dbiplus::sql_record* const record)
+    {
+      CVideoInfoTag movie = GetDetailsForMovie(record, getDetails);
+      if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
+          g_passwordManager.bMasterUser                                   ||
+          g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
+      {
+        CFileItemPtr pItem(new CFileItem(movie));
+
+        CVideoDbUrl itemUrl = videoUrl;
+        std::string path = StringUtils::Format("%i", movie.m_iDbId);
+        itemUrl.AppendPath(path);
+        pItem->SetPath(itemUrl.ToString());
+
+        pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED,movie.GetPlayCount() > 0);
+        items.Add(pItem);
+        return StreamItems(items);
+      }
+      return true;
+    };
+
+    if (sortDescription.sortBy == SortByNone)
+    {
+      // the rows are already in their final order, so build the items while
+      // stepping through them instead of holding the whole result in memory
+      unsigned int time = XbmcThreads::SystemClockMillis();
+      if (!m_pDS->query_forward(strSQL))
+        return false;
+
+      int iRowsFound = 0;
+      while (!m_pDS->eof())
+      {
+        if (!addMovie(m_pDS->get_sql_record()))
+        {
+          m_pDS->close();
+          return false;
+        }
+        iRowsFound++;
+        m_pDS->next();
+      }
+      m_pDS->close();
+      CLog::Log(LOGDEBUG, "%s took %d ms for %d items query: %s", __FUNCTION__, XbmcThreads::SystemClockMillis() - time, iRowsFound, strSQL.c_str());
+
+      // store the total value of items as a property
+      if (total < iRowsFound)
+        total = iRowsFound;
+      items.SetProperty("total", total);
+      return true;
+    }
+
     int iRowsFound = RunQuery(strSQL);
     if (iRowsFound <= 0)
       return iRowsFound == 0;
@@ -6670,22 +7097,10 @@ bool CVideoDatabase::GetMoviesByWhere(const std::string& strBaseDir, const Filte
     for (const auto &i : results)
     {
       unsigned int targetRow = (unsigned int)i.at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
-
-      CVideoInfoTag movie = GetDetailsForMovie(record, getDetails);
-      if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
-          g_passwordManager.bMasterUser                                   ||
-          g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, *CMediaSourceSettings::GetInstance().GetSources("video")))
+      if (!addMovie(data.at(targetRow)))
       {
-        CFileItemPtr pItem(new CFileItem(movie));
-
-        CVideoDbUrl itemUrl = videoUrl;
-        std::string path = StringUtils::Format("%i", movie.m_iDbId);
-        itemUrl.AppendPath(path);
-        pItem->SetPath(itemUrl.ToString());
-
-        pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED,movie.GetPlayCount() > 0);
-        items.Add(pItem);
+        m_pDS->close();
+        return false;
       }
     }
 
@@ -6794,6 +7209,11 @@ bool CVideoDatabase::GetTvShowsByWhere(const std::string& strBaseDir, const Filt
 
         pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, (pItem->GetVideoInfoTag()->GetPlayCount() > 0) && (pItem->GetVideoInfoTag()->m_iEpisode > 0));
         items.Add(pItem);
+        if (!StreamItems(items))
+        {
+          m_pDS->close();
+          return false;
+        }
       }
     }
 
@@ -6929,6 +7349,11 @@ bool CVideoDatabase::GetEpisodesByWhere(const std::string& strBaseDir, const Fil
         pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, movie.GetPlayCount() > 0);
         pItem->m_dateTime = movie.m_firstAired;
         items.Add(pItem);
+        if (!StreamItems(items))
+        {
+          m_pDS->close();
+          return false;
+        }
       }
     }
 
@@ -7450,9 +7875,9 @@ void CVideoDatabase::GetMovieActorsByName(const std::string& strSearch, CFileIte
     if (NULL == m_pDS.get()) return;
 
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL=PrepareSQL("SELECT actor.actor_id, actor.name, path.strPath FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN movie ON actor_link.media_id=movie.idMovie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE actor_link.media_type='movie' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      strSQL=PrepareSQL("SELECT actor.actor_id, actor.name, path.strPath FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN movie ON actor_link.media_id=movie.idMovie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE actor_link.media_type='movie' AND ") + GetSearchCondition("actor", "actor.actor_id", strSearch, { "name" }, PrepareSQL("actor.name LIKE '%%%s%%'", strSearch.c_str()));
     else
-      strSQL=PrepareSQL("SELECT DISTINCT actor.actor_id, actor.name FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN movie ON actor_link.media_id=movie.idMovie WHERE actor_link.media_type='movie' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      strSQL=PrepareSQL("SELECT DISTINCT actor.actor_id, actor.name FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN movie ON actor_link.media_id=movie.idMovie WHERE actor_link.media_type='movie' AND ") + GetSearchCondition("actor", "actor.actor_id", strSearch, { "name" }, PrepareSQL("actor.name LIKE '%%%s%%'", strSearch.c_str()));
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -7489,9 +7914,9 @@ void CVideoDatabase::GetTvShowsActorsByName(const std::string& strSearch, CFileI
     if (NULL == m_pDS.get()) return;
 
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL=PrepareSQL("SELECT actor.actor_id, actor.name, path.strPath FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN tvshow ON actor_link.media_id=tvshow.idShow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idPath=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE actor_link.media_type='tvshow' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      strSQL=PrepareSQL("SELECT actor.actor_id, actor.name, path.strPath FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN tvshow ON actor_link.media_id=tvshow.idShow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idPath=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE actor_link.media_type='tvshow' AND ") + GetSearchCondition("actor", "actor.actor_id", strSearch, { "name" }, PrepareSQL("actor.name LIKE '%%%s%%'", strSearch.c_str()));
     else
-      strSQL=PrepareSQL("SELECT DISTINCT actor.actor_id, actor.name FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN tvshow ON actor_link.media_id=tvshow.idShow WHERE actor_link.media_type='tvshow' AND actor.name LIKE '%%%s%%'",strSearch.c_str());
+      strSQL=PrepareSQL("SELECT DISTINCT actor.actor_id, actor.name FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN tvshow ON actor_link.media_id=tvshow.idShow WHERE actor_link.media_type='tvshow' AND ") + GetSearchCondition("actor", "actor.actor_id", strSearch, { "name" }, PrepareSQL("actor.name LIKE '%%%s%%'", strSearch.c_str()));
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -7529,11 +7954,11 @@ void CVideoDatabase::GetMusicVideoArtistsByName(const std::string& strSearch, CF
 
     std::string strLike;
     if (!strSearch.empty())
-      strLike = "and actor.name like '%%%s%%'";
+      strLike = "and " + GetSearchCondition("actor", "actor.actor_id", strSearch, { "name" }, PrepareSQL("actor.name like '%%%s%%'", strSearch.c_str()));
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL=PrepareSQL("SELECT actor.actor_id, actor.name, path.strPath FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN musicvideo ON actor_link.media_id=musicvideo.idMVideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE actor_link.media_type='musicvideo' "+strLike, strSearch.c_str());
+      strSQL=PrepareSQL("SELECT actor.actor_id, actor.name, path.strPath FROM actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id INNER JOIN musicvideo ON actor_link.media_id=musicvideo.idMVideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE actor_link.media_type='musicvideo' ") + strLike;
     else
-      strSQL=PrepareSQL("SELECT DISTINCT actor.actor_id, actor.name from actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id WHERE actor_link.media_type='musicvideo' "+strLike,strSearch.c_str());
+      strSQL=PrepareSQL("SELECT DISTINCT actor.actor_id, actor.name from actor INNER JOIN actor_link ON actor_link.actor_id=actor.actor_id WHERE actor_link.media_type='musicvideo' ") + strLike;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -7760,6 +8185,11 @@ bool CVideoDatabase::GetMusicVideosByWhere(const std::string &baseDir, const Fil
 
         item->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED, musicvideo.GetPlayCount() > 0);
         items.Add(item);
+        if (!StreamItems(items))
+        {
+          m_pDS->close();
+          return false;
+        }
       }
     }
 
@@ -7900,10 +8330,12 @@ void CVideoDatabase::GetMoviesByName(const std::string& strSearch, CFileItemList
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    std::string where = GetSearchCondition("movie", "movie.idMovie", strSearch, { VideoField(VIDEODB_ID_TITLE) },
+                                           PrepareSQL("movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE, strSearch.c_str()));
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath, movie.idSet FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE, VIDEODB_ID_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d, path.strPath, movie.idSet FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_TITLE) + where;
     else
-      strSQL = PrepareSQL("select movie.idMovie,movie.c%02d, movie.idSet from movie where movie.c%02d like '%%%s%%'",VIDEODB_ID_TITLE,VIDEODB_ID_TITLE,strSearch.c_str());
+      strSQL = PrepareSQL("select movie.idMovie,movie.c%02d, movie.idSet from movie where ",VIDEODB_ID_TITLE) + where;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -7945,10 +8377,12 @@ void CVideoDatabase::GetTvShowsByName(const std::string& strSearch, CFileItemLis
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    std::string where = GetSearchCondition("tvshow", "tvshow.idShow", strSearch, { VideoField(VIDEODB_ID_TV_TITLE) },
+                                           PrepareSQL("tvshow.c%02d LIKE '%%%s%%'", VIDEODB_ID_TV_TITLE, strSearch.c_str()));
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE tvshow.c%02d LIKE '%%%s%%'", VIDEODB_ID_TV_TITLE, VIDEODB_ID_TV_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT tvshow.idShow, tvshow.c%02d, path.strPath FROM tvshow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE ", VIDEODB_ID_TV_TITLE) + where;
     else
-      strSQL = PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow where tvshow.c%02d like '%%%s%%'",VIDEODB_ID_TV_TITLE,VIDEODB_ID_TV_TITLE,strSearch.c_str());
+      strSQL = PrepareSQL("select tvshow.idShow,tvshow.c%02d from tvshow where ",VIDEODB_ID_TV_TITLE) + where;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -7986,10 +8420,12 @@ void CVideoDatabase::GetEpisodesByName(const std::string& strSearch, CFileItemLi
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    std::string where = GetSearchCondition("episode", "episode.idEpisode", strSearch, { VideoField(VIDEODB_ID_EPISODE_TITLE) },
+                                           PrepareSQL("episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, strSearch.c_str()));
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE) + where;
     else
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE episode.c%02d like '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE) + where;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8029,10 +8465,12 @@ void CVideoDatabase::GetMusicVideosByName(const std::string& strSearch, CFileIte
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    std::string where = GetSearchCondition("musicvideo", "musicvideo.idMVideo", strSearch, { VideoField(VIDEODB_ID_MUSICVIDEO_TITLE) },
+                                           PrepareSQL("musicvideo.c%02d LIKE '%%%s%%'", VIDEODB_ID_MUSICVIDEO_TITLE, strSearch.c_str()));
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT musicvideo.idMVideo, musicvideo.c%02d, path.strPath FROM musicvideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE musicvideo.c%02d LIKE '%%%s%%'", VIDEODB_ID_MUSICVIDEO_TITLE, VIDEODB_ID_MUSICVIDEO_TITLE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT musicvideo.idMVideo, musicvideo.c%02d, path.strPath FROM musicvideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_MUSICVIDEO_TITLE) + where;
     else
-      strSQL = PrepareSQL("select musicvideo.idMVideo,musicvideo.c%02d from musicvideo where musicvideo.c%02d like '%%%s%%'",VIDEODB_ID_MUSICVIDEO_TITLE,VIDEODB_ID_MUSICVIDEO_TITLE,strSearch.c_str());
+      strSQL = PrepareSQL("select musicvideo.idMVideo,musicvideo.c%02d from musicvideo where ",VIDEODB_ID_MUSICVIDEO_TITLE) + where;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8076,10 +8514,12 @@ void CVideoDatabase::GetEpisodesByPlot(const std::string& strSearch, CFileItemLi
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    std::string where = GetSearchCondition("episode", "episode.idEpisode", strSearch, { VideoField(VIDEODB_ID_EPISODE_PLOT) },
+                                           PrepareSQL("episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_PLOT, strSearch.c_str()));
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_PLOT, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d, path.strPath FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow INNER JOIN files ON files.idFile=episode.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE) + where;
     else
-      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE episode.c%02d LIKE '%%%s%%'", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE, VIDEODB_ID_EPISODE_PLOT, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT episode.idEpisode, episode.c%02d, episode.c%02d, episode.idShow, tvshow.c%02d FROM episode INNER JOIN tvshow ON tvshow.idShow=episode.idShow WHERE ", VIDEODB_ID_EPISODE_TITLE, VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_TV_TITLE) + where;
     m_pDS->query( strSQL );
 
     while (!m_pDS->eof())
@@ -8115,10 +8555,12 @@ void CVideoDatabase::GetMoviesByPlot(const std::string& strSearch, CFileItemList
     if (NULL == m_pDB.get()) return;
     if (NULL == m_pDS.get()) return;
 
+    std::string where = GetSearchCondition("movie", "movie.idMovie", strSearch, { VideoField(VIDEODB_ID_PLOT), VideoField(VIDEODB_ID_PLOTOUTLINE), VideoField(VIDEODB_ID_TAGLINE) },
+                                           PrepareSQL("(movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%')", VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE, strSearch.c_str()));
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("select movie.idMovie, movie.c%02d, path.strPath FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%'", VIDEODB_ID_TITLE,VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE,strSearch.c_str());
+      strSQL = PrepareSQL("select movie.idMovie, movie.c%02d, path.strPath FROM movie INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ", VIDEODB_ID_TITLE) + where;
     else
-      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d FROM movie WHERE (movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%' OR movie.c%02d LIKE '%%%s%%')", VIDEODB_ID_TITLE, VIDEODB_ID_PLOT, strSearch.c_str(), VIDEODB_ID_PLOTOUTLINE, strSearch.c_str(), VIDEODB_ID_TAGLINE, strSearch.c_str());
+      strSQL = PrepareSQL("SELECT movie.idMovie, movie.c%02d FROM movie WHERE ", VIDEODB_ID_TITLE) + where;
 
     m_pDS->query( strSQL );
 
@@ -8158,9 +8600,9 @@ void CVideoDatabase::GetMovieDirectorsByName(const std::string& strSearch, CFile
     if (NULL == m_pDS.get()) return;
 
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name, path.strPath FROM movie INNER JOIN director_link ON (director_link.media_id=movie.idMovie AND director_link.media_type='movie') INNER JOIN actor ON actor.actor_id=director_link.actor_id INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE actor.name LIKE '%%%s%%'", strSearch.c_str());
+      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name, path.strPath FROM movie INNER JOIN director_link ON (director_link.media_id=movie.idMovie AND director_link.media_type='movie') INNER JOIN actor ON actor.actor_id=director_link.actor_id INNER JOIN files ON files.idFile=movie.idFile INNER JOIN path ON path.idPath=files.idPath WHERE ") + GetSearchCondition("actor", "actor.actor_id", strSearch, { "name" }, PrepareSQL("actor.name LIKE '%%%s%%'", strSearch.c_str()));
     else
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN movie ON director_link.media_id=movie.idMovie WHERE director_link.media_type='movie' AND actor.name like '%%%s%%'", strSearch.c_str());
+      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN movie ON director_link.media_id=movie.idMovie WHERE director_link.media_type='movie' AND ") + GetSearchCondition("actor", "actor.actor_id", strSearch, { "name" }, PrepareSQL("actor.name LIKE '%%%s%%'", strSearch.c_str()));
 
     m_pDS->query( strSQL );
 
@@ -8199,9 +8641,9 @@ void CVideoDatabase::GetTvShowsDirectorsByName(const std::string& strSearch, CFi
     if (NULL == m_pDS.get()) return;
 
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name, path.strPath FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN tvshow ON director_link.media_id=tvshow.idShow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE director_link.media_type='tvshow' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name, path.strPath FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN tvshow ON director_link.media_id=tvshow.idShow INNER JOIN tvshowlinkpath ON tvshowlinkpath.idShow=tvshow.idShow INNER JOIN path ON path.idPath=tvshowlinkpath.idPath WHERE director_link.media_type='tvshow' AND ") + GetSearchCondition("actor", "actor.actor_id", strSearch, { "name" }, PrepareSQL("actor.name LIKE '%%%s%%'", strSearch.c_str()));
     else
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN tvshow ON director_link.media_id=tvshow.idShow WHERE director_link.media_type='tvshow' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN tvshow ON director_link.media_id=tvshow.idShow WHERE director_link.media_type='tvshow' AND ") + GetSearchCondition("actor", "actor.actor_id", strSearch, { "name" }, PrepareSQL("actor.name LIKE '%%%s%%'", strSearch.c_str()));
 
     m_pDS->query( strSQL );
 
@@ -8240,9 +8682,9 @@ void CVideoDatabase::GetMusicVideoDirectorsByName(const std::string& strSearch,
     if (NULL == m_pDS.get()) return;
 
     if (CProfilesManager::GetInstance().GetMasterProfile().getLockMode() != LOCK_MODE_EVERYONE && !g_passwordManager.bMasterUser)
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name, path.strPath FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN musicvideo ON director_link.media_id=musicvideo.idMVideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE director_link.media_type='musicvideo' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name, path.strPath FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN musicvideo ON director_link.media_id=musicvideo.idMVideo INNER JOIN files ON files.idFile=musicvideo.idFile INNER JOIN path ON path.idPath=files.idPath WHERE director_link.media_type='musicvideo' AND ") + GetSearchCondition("actor", "actor.actor_id", strSearch, { "name" }, PrepareSQL("actor.name LIKE '%%%s%%'", strSearch.c_str()));
     else
-      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN musicvideo ON director_link.media_id=musicvideo.idMVideo WHERE director_link.media_type='musicvideo' AND actor.name LIKE '%%%s%%'", strSearch.c_str());
+      strSQL = PrepareSQL("SELECT DISTINCT director_link.actor_id, actor.name FROM actor INNER JOIN director_link ON director_link.actor_id=actor.actor_id INNER JOIN musicvideo ON director_link.media_id=musicvideo.idMVideo WHERE director_link.media_type='musicvideo' AND ") + GetSearchCondition("actor", "actor.actor_id", strSearch, { "name" }, PrepareSQL("actor.name LIKE '%%%s%%'", strSearch.c_str()));
 
     m_pDS->query( strSQL );
 
@@ -8469,6 +8911,12 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const st
       m_pDS->exec(sql);
     }
 
+    CLog::Log(LOGDEBUG, "%s: Cleaning path fingerprints", __FUNCTION__);
+    sql = "DELETE FROM pathfingerprint "
+            "WHERE NOT EXISTS (SELECT 1 FROM tvshowlinkpath JOIN path ON path.idPath = tvshowlinkpath.idPath "
+                              "WHERE SUBSTR(pathfingerprint.strPath, 1, LENGTH(path.strPath)) = path.strPath)";
+    m_pDS->exec(sql);
+
     CLog::Log(LOGDEBUG, "%s: Cleaning tvshow table", __FUNCTION__);
 
     std::string tvshowsToDelete;
@@ -8539,6 +8987,9 @@ void CVideoDatabase::CleanDatabase(CGUIDialogProgressBarHandle* handle, const st
     sql = "DELETE FROM sets WHERE NOT EXISTS (SELECT 1 FROM movie WHERE movie.idSet = sets.idSet)";
     m_pDS->exec(sql);
 
+    CLog::Log(LOGDEBUG, "%s: Rebuilding navigation summary", __FUNCTION__);
+    RebuildNavSummary();
+
     CommitTransaction();
 
     if (handle)
@@ -9507,14 +9958,35 @@ bool CVideoDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
   { // number of items in the db has likely changed, so recalculate
-    g_infoManager.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
-    g_infoManager.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
-    g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSICVIDEOS, HasContent(VIDEODB_CONTENT_MUSICVIDEOS));
+    // (deferred to EndDeferLibraryFlags() during a scan)
+    if (!m_deferLibraryFlags)
+    {
+      g_infoManager.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
+      g_infoManager.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
+      g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSICVIDEOS, HasContent(VIDEODB_CONTENT_MUSICVIDEOS));
+    }
     return true;
   }
   return false;
 }
 
+void CVideoDatabase::BeginDeferLibraryFlags()
+{
+  m_deferLibraryFlags = true;
+}
+
+void CVideoDatabase::EndDeferLibraryFlags()
+{
+  if (!m_deferLibraryFlags)
+    return;
+
+  m_deferLibraryFlags = false;
+
+  g_infoManager.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
+  g_infoManager.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
+  g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSICVIDEOS, HasContent(VIDEODB_CONTENT_MUSICVIDEOS));
+}
+
 bool CVideoDatabase::SetSingleValue(VIDEODB_CONTENT_TYPE type, int dbId, int dbField, const std::string &strValue)
 {
   std::string strSQL;
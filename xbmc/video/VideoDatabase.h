@@ -19,6 +19,7 @@
  *
  */
 
+#include <map>
 #include <memory>
 #include <set>
 #include <utility>
@@ -430,6 +431,32 @@ public:
   virtual bool Open();
   virtual bool CommitTransaction();
 
+  /*! \brief Defer the updates of the LIBRARY_HAS_MOVIES, LIBRARY_HAS_TVSHOWS and
+   LIBRARY_HAS_MUSICVIDEOS flags, e.g. for the duration of a library scan.
+   They are otherwise recomputed after every committed transaction.
+   \sa EndDeferLibraryFlags, CDeferLibraryFlags
+   */
+  void BeginDeferLibraryFlags();
+
+  /*! \brief Recompute the library flags deferred since BeginDeferLibraryFlags()
+   \sa BeginDeferLibraryFlags
+   */
+  void EndDeferLibraryFlags();
+
+  /*! \brief Defers the library flag updates of a database for its lifetime */
+  class CDeferLibraryFlags
+  {
+  public:
+    explicit CDeferLibraryFlags(CVideoDatabase &db) : m_db(db) { m_db.BeginDeferLibraryFlags(); }
+    ~CDeferLibraryFlags() { m_db.EndDeferLibraryFlags(); }
+
+  private:
+    CDeferLibraryFlags(const CDeferLibraryFlags&) = delete;
+    CDeferLibraryFlags& operator=(const CDeferLibraryFlags&) = delete;
+
+    CVideoDatabase &m_db;
+  };
+
   int AddMovie(const std::string& strFilenameAndPath);
   int AddEpisode(int idShow, const std::string& strFilenameAndPath);
 
@@ -655,6 +682,23 @@ public:
   // scanning hashes and paths scanned
   bool SetPathHash(const std::string &path, const std::string &hash);
   bool GetPathHash(const std::string &path, std::string &hash);
+
+  /*! \brief Get the stored fingerprint of a directory.
+   \param path the directory.
+   \param time [out] the modification time of the directory when it was fingerprinted.
+   \param subPaths [out] the subdirectories of the directory at that time.
+   \param hash [out] the hash over the directory and all its subdirectories.
+   \return true if a fingerprint was found, false otherwise.
+   \sa CVideoInfoScanner::GetRecursiveFastHash
+   */
+  bool GetPathFingerprint(const std::string &path, int64_t &time, std::vector<std::string> &subPaths, std::string &hash);
+  bool SetPathFingerprint(const std::string &path, int64_t time, const std::vector<std::string> &subPaths, const std::string &hash);
+
+  /*! \brief Remove the fingerprints of a directory and all its subdirectories.
+   \param path the directory.
+   \return true on success, false otherwise.
+   */
+  bool RemovePathFingerprints(const std::string &path);
   bool GetPaths(std::set<std::string> &paths);
   bool GetPathsForTvShow(int idShow, std::set<int>& paths);
 
@@ -868,11 +912,19 @@ protected:
   int GetFileId(const std::string& url);
 
   int AddToTable(const std::string& table, const std::string& firstField, const std::string& secondField, const std::string& value);
+
+  /*! \brief Get the ids of a set of values of a lookup table, adding the ones that don't exist yet.
+   Looks all values up in a single query rather than one query per value.
+   \param table the table to look the values up in, e.g. "genre" or "actor".
+   \param values the names to look up. Empty names are skipped.
+   \return the ids in the order of values, -1 for names that were skipped or couldn't be added.
+   */
+  std::vector<int> AddToTable(const std::string& table, const std::vector<std::string>& values);
+
   int UpdateRatings(int mediaId, const char *mediaType, const RatingMap& values, const std::string& defaultRating);
   int AddRatings(int mediaId, const char *mediaType, const RatingMap& values, const std::string& defaultRating);
   int UpdateUniqueIDs(int mediaId, const char *mediaType, const CVideoInfoTag& details);
   int AddUniqueIDs(int mediaId, const char *mediaType, const CVideoInfoTag& details);
-  int AddActor(const std::string& strActor, const std::string& thumbURL, const std::string &thumb = "");
 
   int AddTvShow();
   int AddMusicVideo(const std::string& strFilenameAndPath);
@@ -894,8 +946,8 @@ protected:
   int GetMatchingTvShow(const CVideoInfoTag &show);
 
   // link functions - these two do all the work
-  void AddLinkToActor(int mediaId, const char *mediaType, int actorId, const std::string &role, int order);
   void AddToLinkTable(int mediaId, const std::string& mediaType, const std::string& table, int valueId, const char *foreignKey = NULL);
+  void AddToLinkTable(int mediaId, const std::string& mediaType, const std::string& table, const std::vector<int>& valueIds, const char *foreignKey = NULL);
   void RemoveFromLinkTable(int mediaId, const std::string& mediaType, const std::string& table, int valueId, const char *foreignKey = NULL);
 
   void AddLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values);
@@ -937,6 +989,19 @@ private:
    */
   virtual void CreateViews();
 
+  /*! \brief Create the triggers keeping the navsummary table up to date.
+   navsummary holds the number of movies, tvshows and music videos (and how
+   many of them are watched) linked to every genre, country, studio and tag
+   so their navigation nodes don't have to aggregate over the library views.
+   \sa RebuildNavSummary
+   */
+  void CreateNavSummaryTriggers();
+
+  /*! \brief Recompute the navsummary table from the link tables
+   \sa CreateNavSummaryTriggers
+   */
+  void RebuildNavSummary();
+
   /*! \brief Helper to get a database id given a query.
    Returns an integer, -1 if not found, and greater than 0 if found.
    \param query the SQL that will retrieve a database id.
@@ -988,4 +1053,6 @@ private:
 
   static void AnnounceRemove(std::string content, int id, bool scanning = false);
   static void AnnounceUpdate(std::string content, int id);
+
+  bool m_deferLibraryFlags; ///< \brief whether the library flag updates are deferred \sa BeginDeferLibraryFlags
 };
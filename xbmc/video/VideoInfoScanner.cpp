@@ -20,6 +20,7 @@
 
 #include "VideoInfoScanner.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "ServiceBroker.h"
@@ -29,6 +30,7 @@
 #include "events/EventLog.h"
 #include "events/MediaLibraryEvent.h"
 #include "FileItem.h"
+#include "filesystem/Directory.h"
 #include "filesystem/DirectoryCache.h"
 #include "filesystem/File.h"
 #include "filesystem/MultiPathDirectory.h"
@@ -115,6 +117,8 @@ namespace VIDEO
       unsigned int tick = XbmcThreads::SystemClockMillis();
 
       m_database.Open();
+      // the library flags are updated once the items are in, also if the scan throws
+      std::unique_ptr<CVideoDatabase::CDeferLibraryFlags> deferFlags(new CVideoDatabase::CDeferLibraryFlags(m_database));
 
       m_bCanInterrupt = true;
 
@@ -130,6 +134,9 @@ namespace VIDEO
       // result in unexpected behaviour.
       m_bCanInterrupt = false;
 
+      // list the folders of different sources and hosts in parallel, while they are scanned in order
+      m_prefetcher.reset(new CDirectoryPrefetcher(g_advancedSettings.m_videoExtensions));
+
       bool bCancelled = false;
       while (!bCancelled && !m_pathsToScan.empty())
       {
@@ -140,6 +147,11 @@ namespace VIDEO
          * occurs.
          */
         std::string directory = *m_pathsToScan.begin();
+
+        std::set<std::string>::const_iterator next = std::next(m_pathsToScan.begin());
+        if (next != m_pathsToScan.end() && !g_advancedSettings.m_bVideoLibraryUseFastHash)
+          m_prefetcher->Prefetch(*next);
+
         if (m_bStop)
         {
           bCancelled = true;
@@ -158,6 +170,9 @@ namespace VIDEO
           bCancelled = true;
       }
 
+      m_prefetcher.reset();
+      deferFlags.reset();
+
       if (!bCancelled)
       {
         if (m_bClean)
@@ -270,12 +285,12 @@ namespace VIDEO
     const std::vector<std::string> &regexps = content == CONTENT_TVSHOWS ? g_advancedSettings.m_tvshowExcludeFromScanRegExps
                                                          : g_advancedSettings.m_moviesExcludeFromScanRegExps;
 
-    if (IsExcluded(strDirectory, regexps))
-      return true;
-
     bool ignoreFolder = !m_scanAll && settings.noupdate;
-    if (content == CONTENT_NONE || ignoreFolder)
+    if (IsExcluded(strDirectory, regexps) || content == CONTENT_NONE || ignoreFolder)
+    {
+      m_prefetcher->Discard(strDirectory);
       return true;
+    }
 
     std::string hash, dbHash;
     if (content == CONTENT_MOVIES ||content == CONTENT_MUSICVIDEOS)
@@ -296,7 +311,9 @@ namespace VIDEO
       }
       else
       { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.m_videoExtensions);
+        m_prefetcher->GetDirectory(strDirectory, items);
+        if (settings.recurse > 0)
+          PrefetchSubFolders(items);
         items.Stack();
 
         // check whether to re-use previously computed fast hash
@@ -334,7 +351,7 @@ namespace VIDEO
 
       if (foundDirectly && !settings.parent_name_root)
       {
-        CDirectory::GetDirectory(strDirectory, items, g_advancedSettings.m_videoExtensions);
+        m_prefetcher->GetDirectory(strDirectory, items);
         items.SetPath(strDirectory);
         GetPathHash(items, hash);
         bSkip = true;
@@ -397,6 +414,9 @@ namespace VIDEO
         }
       }
     }
+
+    // drop the listings of subfolders that weren't scanned, e.g. stacked DVD/Blu-ray folders
+    m_prefetcher->Discard(strDirectory);
     return !m_bStop;
   }
 
@@ -1828,6 +1848,20 @@ namespace VIDEO
     return true;
   }
 
+  void CVideoInfoScanner::PrefetchSubFolders(const CFileItemList &items)
+  {
+    for (int i = 0; i < items.Size(); ++i)
+    {
+      const CFileItemPtr pItem = items[i];
+      if (!pItem->m_bIsFolder || pItem->IsParentFolder() || pItem->IsPlayList())
+        continue;
+
+      std::string dbHash;
+      if (!g_advancedSettings.m_bVideoLibraryUseFastHash || !m_database.GetPathHash(pItem->GetPath(), dbHash))
+        m_prefetcher->Prefetch(pItem->GetPath());
+    }
+  }
+
   std::string CVideoInfoScanner::GetFastHash(const std::string &directory,
       const std::vector<std::string> &excludes) const
   {
@@ -1852,40 +1886,103 @@ namespace VIDEO
   }
 
   std::string CVideoInfoScanner::GetRecursiveFastHash(const std::string &directory,
-      const std::vector<std::string> &excludes) const
+      const std::vector<std::string> &excludes)
   {
-    CFileItemList items;
-    items.Add(CFileItemPtr(new CFileItem(directory, true)));
-    CUtil::GetRecursiveDirsListing(directory, items, DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_NO_FILE_INFO);
+    std::string fingerprint;
+    if (!GetDirectoryFingerprint(directory, fingerprint))
+      return "";
 
     XBMC::XBMC_MD5 md5state;
 
     if (excludes.size())
       md5state.append(StringUtils::Join(excludes, "|"));
 
-    int64_t time = 0;
-    for (int i=0; i < items.Size(); ++i)
+    md5state.append(fingerprint);
+    return md5state.getDigest();
+  }
+
+  bool CVideoInfoScanner::GetDirectoryFingerprint(const std::string &directory, std::string &fingerprint)
+  {
+    struct __stat64 buffer;
+    if (XFILE::CFile::Stat(directory, &buffer) != 0)
+      return false;
+
+    int64_t time = buffer.st_mtime ? buffer.st_mtime : buffer.st_ctime;
+    if (!time)
+      return false;
+
+    return GetDirectoryFingerprint(directory, time, fingerprint);
+  }
+
+  bool CVideoInfoScanner::GetDirectoryFingerprint(const std::string &directory, int64_t time, std::string &fingerprint)
+  {
+    // The modification time of a folder changes whenever entries are added, removed or renamed.
+    // A folder without subfolders whose time didn't change is covered by its stored fingerprint,
+    // so nothing below it has to be looked at.
+    int64_t dbTime = 0;
+    std::vector<std::string> subPaths;
+    std::string dbFingerprint;
+    bool stored = m_database.GetPathFingerprint(directory, dbTime, subPaths, dbFingerprint);
+    if (stored && dbTime == time && subPaths.empty())
+    {
+      fingerprint = dbFingerprint;
+      return true;
+    }
+
+    // Folders with subfolders are listed to get the times of the subfolders. Most filesystems
+    // return them with the listing, which saves a stat() for each subfolder.
+    CFileItemList items;
+    if (!CDirectory::GetDirectory(directory, items, "/", DIR_FLAG_NO_FILE_DIRS))
+      return false;
+
+    std::vector<std::pair<std::string, int64_t>> newSubPaths;
+    for (int i = 0; i < items.Size(); ++i)
     {
-      int64_t stat_time = 0;
+      if (!items[i]->m_bIsFolder || items[i]->IsPath(".."))
+        continue;
+
+      time_t subTime = 0;
+      if (items[i]->m_dateTime.IsValid())
+        items[i]->m_dateTime.GetAsUTCDateTime().GetAsTime(subTime);
+
       struct __stat64 buffer;
-      if (XFILE::CFile::Stat(items[i]->GetPath(), &buffer) == 0)
-      {
-        //! @todo some filesystems may return the mtime/ctime inline, in which case this is
-        //! unnecessarily expensive. Consider supporting Stat() in our directory cache?
-        stat_time = buffer.st_mtime ? buffer.st_mtime : buffer.st_ctime;
-        time += stat_time;
-      }
+      if (subTime <= 0 && XFILE::CFile::Stat(items[i]->GetPath(), &buffer) == 0)
+        subTime = buffer.st_mtime ? buffer.st_mtime : buffer.st_ctime;
+      if (subTime <= 0)
+        return false;
 
-      if (!stat_time)
-        return "";
+      newSubPaths.push_back(std::make_pair(items[i]->GetPath(), static_cast<int64_t>(subTime)));
     }
 
-    if (time)
+    // forget about the subfolders that are gone
+    for (const auto &subPath : subPaths)
     {
-      md5state.append((unsigned char *)&time, sizeof(time));
-      return md5state.getDigest();
+      auto it = std::find_if(newSubPaths.begin(), newSubPaths.end(),
+                             [&subPath](const std::pair<std::string, int64_t> &newSubPath) { return newSubPath.first == subPath; });
+      if (it == newSubPaths.end())
+        m_database.RemovePathFingerprints(subPath);
     }
-    return "";
+    subPaths.clear();
+
+    // the fingerprint covers the folder and the fingerprints of all its subfolders
+    XBMC::XBMC_MD5 md5state;
+    md5state.append((unsigned char *)&time, sizeof(time));
+    for (const auto &subPath : newSubPaths)
+    {
+      std::string subFingerprint;
+      if (!GetDirectoryFingerprint(subPath.first, subPath.second, subFingerprint))
+        return false;
+
+      md5state.append(subPath.first);
+      md5state.append(subFingerprint);
+      subPaths.push_back(subPath.first);
+    }
+    fingerprint = md5state.getDigest();
+
+    if (!stored || dbTime != time || fingerprint != dbFingerprint)
+      m_database.SetPathFingerprint(directory, time, subPaths, fingerprint);
+
+    return true;
   }
 
   void CVideoInfoScanner::GetSeasonThumbs(const CVideoInfoTag &show,
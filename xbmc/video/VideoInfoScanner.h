@@ -19,6 +19,7 @@
  *
  */
 
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -27,6 +28,7 @@
 #include "NfoFile.h"
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
+#include "filesystem/DirectoryPrefetcher.h"
 
 class CRegExp;
 class CFileItem;
@@ -208,8 +210,20 @@ namespace VIDEO
      \param directory folder to hash (recursively)
      \param excludes string array of exclude expressions
      \return the md5 hash of the folder
+     \sa GetDirectoryFingerprint
      */
-    std::string GetRecursiveFastHash(const std::string &directory, const std::vector<std::string> &excludes) const;
+    std::string GetRecursiveFastHash(const std::string &directory, const std::vector<std::string> &excludes);
+
+    /*! \brief Fingerprint a directory tree from the modified times of its folders
+     The fingerprint of each folder is stored in the database together with its modified
+     time and subfolders. Folders without subfolders whose modified time didn't change
+     are skipped, their stored fingerprint is used.
+     \param directory folder to fingerprint (recursively)
+     \param fingerprint [out] the hash over the modified times of all folders in the tree
+     \return true if the fingerprint could be computed, false otherwise
+     */
+    bool GetDirectoryFingerprint(const std::string &directory, std::string &fingerprint);
+    bool GetDirectoryFingerprint(const std::string &directory, int64_t time, std::string &fingerprint);
 
     /*! \brief Decide whether a folder listing could use the "fast" hash
      Fast hashing can be done whenever the folder contains no scannable subfolders, as the
@@ -221,6 +235,13 @@ namespace VIDEO
      */
     bool CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes) const;
 
+    /*! \brief Start listing the subfolders of a folder that DoScan() will need a listing of
+     Without fast hashing every folder is listed. Otherwise only new folders are, the others
+     are usually skipped based on their fast hash.
+     \param items the listing of the folder
+     */
+    void PrefetchSubFolders(const CFileItemList &items);
+
     /*! \brief Process a series folder, filling in episode details and adding them to the database.
      @todo Ideally we would return INFO_HAVE_ALREADY if we don't have to update any episodes
      and we should return INFO_NOT_FOUND only if no information is found for any of
@@ -253,6 +274,7 @@ namespace VIDEO
     std::set<std::string> m_pathsToScan;
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
+    std::unique_ptr<XFILE::CDirectoryPrefetcher> m_prefetcher; //!< lists the folders to scan ahead of time
     CNfoFile m_nfoReader;
   };
 }
@@ -0,0 +1,505 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this Program; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "dbwrappers/dataset.h"
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "video/VideoDatabase.h"
+#include "video/VideoInfoTag.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <utility>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+class CTestVideoDatabase : public CVideoDatabase
+{
+public:
+  bool Create(const std::string &host)
+  {
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = host;
+    settings.name = "TestVideoDatabase";
+    return Connect(settings.name, settings, true);
+  }
+
+  static std::string GetPath()
+  {
+    return URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "TestVideoDatabase.db");
+  }
+
+  dbiplus::Dataset *GetDataset() { return m_pDS.get(); }
+
+  using CVideoDatabase::AddToTable;
+};
+
+// counts of one navigation node, as listed in the navsummary table
+struct NavCounts
+{
+  int movies = 0;
+  int moviesWatched = 0;
+  int tvshows = 0;
+  int musicvideos = 0;
+  int musicvideosWatched = 0;
+
+  bool operator==(const NavCounts &other) const
+  {
+    return movies == other.movies && moviesWatched == other.moviesWatched && tvshows == other.tvshows &&
+           musicvideos == other.musicvideos && musicvideosWatched == other.musicvideosWatched;
+  }
+};
+
+::std::ostream& operator<<(::std::ostream &os, const NavCounts &counts)
+{
+  return os << counts.movies << "/" << counts.moviesWatched << " movies, " << counts.tvshows << " tvshows, "
+            << counts.musicvideos << "/" << counts.musicvideosWatched << " musicvideos";
+}
+
+std::map<int, NavCounts> ReadCounts(dbiplus::Dataset *ds, const std::string &sql)
+{
+  std::map<int, NavCounts> counts;
+  ds->query(sql);
+  while (!ds->eof())
+  {
+    NavCounts &node = counts[ds->fv(0).get_asInt()];
+    node.movies = ds->fv(1).get_asInt();
+    node.moviesWatched = ds->fv(2).get_asInt();
+    node.tvshows = ds->fv(3).get_asInt();
+    node.musicvideos = ds->fv(4).get_asInt();
+    node.musicvideosWatched = ds->fv(5).get_asInt();
+    ds->next();
+  }
+  ds->close();
+  return counts;
+}
+
+bool HasFullTextSearch(CTestVideoDatabase &db)
+{
+  return db.GetSingleValue("SELECT sqlite_compileoption_used('ENABLE_FTS5') OR sqlite_compileoption_used('ENABLE_FTS4') "
+                           "OR sqlite_compileoption_used('ENABLE_FTS3')") == "1";
+}
+
+std::vector<std::string> Labels(const CFileItemList &items)
+{
+  std::vector<std::string> labels;
+  for (int i = 0; i < items.Size(); i++)
+    labels.push_back(items[i]->GetLabel());
+  std::sort(labels.begin(), labels.end());
+  return labels;
+}
+}
+
+class TestVideoDatabase : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    XFILE::CFile::Delete(m_db.GetPath());
+    ASSERT_TRUE(m_db.Create(CSpecialProtocol::TranslatePath("special://temp/")));
+  }
+
+  void TearDown() override
+  {
+    m_db.Close();
+    dbiplus::SqliteDatabase::closeIdleConnections(m_db.GetPath());
+    XFILE::CFile::Delete(m_db.GetPath());
+  }
+
+  int AddMovie(const std::string &title, const std::vector<std::string> &genres, const std::vector<std::string> &tags)
+  {
+    CVideoInfoTag details;
+    details.m_strTitle = title;
+    details.m_genre = genres;
+    details.m_country = { "Country" };
+    details.m_studio = { "Studio " + title };
+    details.m_tags = tags;
+    return m_db.SetDetailsForMovie(MoviePath(title), details, std::map<std::string, std::string>());
+  }
+
+  int AddMusicVideo(const std::string &title, const std::vector<std::string> &genres)
+  {
+    CVideoInfoTag details;
+    details.m_strTitle = title;
+    details.m_genre = genres;
+    details.m_studio = { "Studio " + title };
+    return m_db.SetDetailsForMusicVideo(MoviePath(title), details, std::map<std::string, std::string>());
+  }
+
+  int AddTvShow(const std::string &title, const std::vector<std::string> &genres)
+  {
+    CVideoInfoTag details;
+    details.m_strTitle = title;
+    details.m_genre = genres;
+    std::string path = "/videos/" + title + "/";
+    return m_db.SetDetailsForTvShow({ { path, "/videos/" } }, details, std::map<std::string, std::string>(),
+                                    std::map<int, std::map<std::string, std::string> >());
+  }
+
+  static std::string MoviePath(const std::string &title)
+  {
+    return "/videos/" + title + ".mkv";
+  }
+
+  void SetWatched(const std::string &title, bool watched)
+  {
+    CFileItem item(MoviePath(title), false);
+    m_db.SetPlayCount(item, watched ? 1 : 0);
+  }
+
+  /*! \brief Compare the navsummary counts of every node with a live count of its links */
+  void CheckNavSummary()
+  {
+    for (const std::string link : { "genre", "country", "studio", "tag" })
+    {
+      SCOPED_TRACE(link);
+      std::string sql = StringUtils::Format("SELECT n.%s_id,", link.c_str());
+      for (const auto &media : { std::make_pair("movie", "idMovie"), std::make_pair("tvshow", "idShow"),
+                                 std::make_pair("musicvideo", "idMVideo") })
+      {
+        sql += StringUtils::Format(" COUNT(CASE WHEN l.media_type='%s' THEN 1 END),", media.first);
+        if (std::string(media.first) != "tvshow")
+          sql += StringUtils::Format(" COUNT(CASE WHEN l.media_type='%s' AND EXISTS (SELECT 1 FROM %s JOIN files ON files.idFile=%s.idFile "
+                                     "WHERE %s.%s=l.media_id AND files.playCount > 0) THEN 1 END),",
+                                     media.first, media.first, media.first, media.first, media.second);
+      }
+      sql.pop_back();
+      sql += StringUtils::Format(" FROM %s n LEFT JOIN %s_link l ON l.%s_id=n.%s_id GROUP BY n.%s_id",
+                                 link.c_str(), link.c_str(), link.c_str(), link.c_str(), link.c_str());
+      std::map<int, NavCounts> live = ReadCounts(m_db.GetDataset(), sql);
+
+      std::map<int, NavCounts> summary = ReadCounts(m_db.GetDataset(), StringUtils::Format(
+          "SELECT link_id, movies, movies_watched, tvshows, musicvideos, musicvideos_watched "
+          "FROM navsummary WHERE link_type='%s'", link.c_str()));
+
+      EXPECT_EQ(live.size(), summary.size());
+      for (const auto &node : live)
+        EXPECT_EQ(node.second, summary[node.first]) << "node " << node.first;
+    }
+  }
+
+  CTestVideoDatabase m_db;
+};
+
+TEST_F(TestVideoDatabase, NavSummaryAfterInserts)
+{
+  ASSERT_GT(AddMovie("Alpha", { "Action", "Drama" }, { "Favourite" }), 0);
+  ASSERT_GT(AddMovie("Beta", { "Action" }, { "Favourite", "Rewatch" }), 0);
+  ASSERT_GT(AddMusicVideo("Gamma", { "Action", "Pop" }), 0);
+  ASSERT_GT(AddTvShow("Delta", { "Drama" }), 0);
+  CheckNavSummary();
+}
+
+TEST_F(TestVideoDatabase, NavSummaryAfterWatchedChanges)
+{
+  AddMovie("Alpha", { "Action", "Drama" }, { "Favourite" });
+  AddMovie("Beta", { "Action" }, { "Favourite" });
+  AddMusicVideo("Gamma", { "Action" });
+
+  SetWatched("Alpha", true);
+  SetWatched("Gamma", true);
+  CheckNavSummary();
+
+  // watching again doesn't count twice
+  SetWatched("Alpha", true);
+  SetWatched("Beta", true);
+  CheckNavSummary();
+
+  SetWatched("Alpha", false);
+  SetWatched("Gamma", false);
+  CheckNavSummary();
+}
+
+TEST_F(TestVideoDatabase, NavSummaryAfterDeletes)
+{
+  int alpha = AddMovie("Alpha", { "Action", "Drama" }, { "Favourite" });
+  int beta = AddMovie("Beta", { "Action" }, { "Favourite", "Rewatch" });
+  int gamma = AddMusicVideo("Gamma", { "Action" });
+  int delta = AddTvShow("Delta", { "Drama" });
+  SetWatched("Alpha", true);
+  SetWatched("Gamma", true);
+
+  // a watched movie takes its watched counts with it
+  m_db.DeleteMovie(alpha);
+  CheckNavSummary();
+
+  m_db.RemoveTagFromItem(beta, m_db.AddTag("Rewatch"), "movie");
+  CheckNavSummary();
+
+  m_db.DeleteMusicVideo(gamma);
+  m_db.DeleteTvShow(delta);
+  CheckNavSummary();
+
+  m_db.DeleteMovie(beta);
+  CheckNavSummary();
+}
+
+TEST_F(TestVideoDatabase, ExecuteInsertRows)
+{
+  ASSERT_TRUE(m_db.ExecuteQuery("CREATE TABLE rows (id integer, name text)"));
+  EXPECT_TRUE(m_db.ExecuteInsertRows("INSERT INTO rows (id, name)", std::vector<std::string>()));
+
+  // more rows than fit into a single statement
+  std::vector<std::string> rows;
+  for (int i = 0; i < 1234; i++)
+    rows.push_back(m_db.PrepareSQL("%i, 'name %i'", i, i));
+  EXPECT_TRUE(m_db.ExecuteInsertRows("INSERT INTO rows (id, name)", rows));
+
+  EXPECT_EQ("1234", m_db.GetSingleValue("SELECT count(*) FROM rows"));
+  EXPECT_EQ("1234", m_db.GetSingleValue("SELECT count(DISTINCT id) FROM rows"));
+  EXPECT_EQ("name 567", m_db.GetSingleValue("SELECT name FROM rows WHERE id=567"));
+
+  // a failing chunk is reported
+  rows[700] = "'too', 'many', 'values'";
+  EXPECT_FALSE(m_db.ExecuteInsertRows("INSERT INTO rows (id, name)", rows));
+}
+
+TEST_F(TestVideoDatabase, AddToTable)
+{
+  // enough names for several lookup queries and insert statements
+  std::vector<std::string> names;
+  for (int i = 0; i < 1100; i++)
+    names.push_back(StringUtils::Format("Genre %i", i));
+  names.push_back("");
+  names.push_back("Genre 5");
+  names.push_back("GENRE 6");
+
+  std::vector<int> ids = m_db.AddToTable("genre", names);
+  ASSERT_EQ(names.size(), ids.size());
+  EXPECT_EQ("1100", m_db.GetSingleValue("SELECT count(*) FROM genre"));
+
+  // empty names are skipped, names only differing in case share a row
+  EXPECT_EQ(-1, ids[1100]);
+  EXPECT_EQ(ids[5], ids[1101]);
+  EXPECT_EQ(ids[6], ids[1102]);
+  for (int i = 0; i < 1100; i++)
+  {
+    ASSERT_GT(ids[i], 0);
+    EXPECT_EQ(names[i], m_db.GetSingleValue(m_db.PrepareSQL("SELECT name FROM genre WHERE genre_id=%i", ids[i])));
+  }
+
+  // existing names are looked up rather than added again
+  names.push_back("Genre new");
+  std::vector<int> again = m_db.AddToTable("genre", names);
+  EXPECT_TRUE(std::equal(ids.begin(), ids.end(), again.begin()));
+  EXPECT_GT(again.back(), 0);
+  EXPECT_EQ("1101", m_db.GetSingleValue("SELECT count(*) FROM genre"));
+}
+
+TEST_F(TestVideoDatabase, CreatesSearchIndices)
+{
+  if (!HasFullTextSearch(m_db))
+    return;
+
+  for (const std::string table : { "movie", "tvshow", "episode", "musicvideo", "actor" })
+  {
+    SCOPED_TRACE(table);
+    EXPECT_EQ("1", m_db.GetSingleValue(m_db.PrepareSQL("SELECT count(*) FROM sqlite_master WHERE type='table' AND name='%s_search'", table.c_str())));
+    EXPECT_EQ("3", m_db.GetSingleValue(m_db.PrepareSQL("SELECT count(*) FROM sqlite_master WHERE type='trigger' AND name LIKE '%s_search_%%'", table.c_str())));
+  }
+}
+
+TEST_F(TestVideoDatabase, SearchConditions)
+{
+  const std::string fallback = "fallback";
+  std::vector<std::string> columns = { "c00" };
+
+  // nothing to search for
+  EXPECT_EQ(fallback, m_db.GetSearchCondition("movie", "movie.idMovie", "", columns, fallback));
+  EXPECT_EQ(fallback, m_db.GetSearchCondition("movie", "movie.idMovie", " - ", columns, fallback));
+
+  AddMovie("The Dark Knight", { "Action" }, {});
+  AddMovie("Amélie", { "Comedy" }, {});
+  if (!HasFullTextSearch(m_db))
+  {
+    EXPECT_EQ(fallback, m_db.GetSearchCondition("movie", "movie.idMovie", "Dark", columns, fallback));
+    return;
+  }
+
+  // every word is matched as the prefix of a word, case insensitively
+  EXPECT_EQ("movie.idMovie IN (SELECT rowid FROM movie_search WHERE movie_search MATCH 'c00:dark* c00:kni*')",
+            m_db.GetSearchCondition("movie", "movie.idMovie", "Dark, KNI", columns, fallback));
+  EXPECT_EQ("movie.idMovie IN (SELECT rowid FROM movie_search WHERE movie_search MATCH 'c00:dark* OR c01:dark*')",
+            m_db.GetSearchCondition("movie", "movie.idMovie", "dark", { "c00", "c01" }, fallback));
+
+  // non-ASCII characters are passed on to the tokenizer untouched
+  EXPECT_EQ("movie.idMovie IN (SELECT rowid FROM movie_search WHERE movie_search MATCH 'c00:amélie*')",
+            m_db.GetSearchCondition("movie", "movie.idMovie", "Amélie", columns, fallback));
+
+  // nothing starts with these, so the substring fallback is used
+  EXPECT_EQ(fallback, m_db.GetSearchCondition("movie", "movie.idMovie", "ark", columns, fallback));
+  EXPECT_EQ(fallback, m_db.GetSearchCondition("movie", "movie.idMovie", "dark nothing", columns, fallback));
+
+  // quotes can't break out of the match expression
+  EXPECT_EQ(fallback, m_db.GetSearchCondition("movie", "movie.idMovie", "o'dark", columns, fallback));
+}
+
+TEST_F(TestVideoDatabase, SearchMovies)
+{
+  AddMovie("The Dark Knight", { "Action" }, {});
+  AddMovie("Knightfall", { "Action" }, {});
+  AddMovie("Amélie", { "Comedy" }, {});
+
+  CFileItemList items;
+  m_db.GetMoviesByName("knig", items);
+  EXPECT_EQ(std::vector<std::string>({ "Knightfall", "The Dark Knight" }), Labels(items));
+
+  items.Clear();
+  m_db.GetMoviesByName("dark kni", items);
+  EXPECT_EQ(std::vector<std::string>({ "The Dark Knight" }), Labels(items));
+
+  // substrings are still found through the fallback
+  items.Clear();
+  m_db.GetMoviesByName("ark", items);
+  EXPECT_EQ(std::vector<std::string>({ "The Dark Knight" }), Labels(items));
+
+  items.Clear();
+  m_db.GetMoviesByName("amél", items);
+  EXPECT_EQ(std::vector<std::string>({ "Amélie" }), Labels(items));
+
+  if (HasFullTextSearch(m_db))
+  {
+    // unicode61 folds the case of non-ASCII letters, LIKE doesn't
+    items.Clear();
+    m_db.GetMoviesByName("AMÉLIE", items);
+    EXPECT_EQ(std::vector<std::string>({ "Amélie" }), Labels(items));
+  }
+
+  items.Clear();
+  m_db.GetMoviesByName("nothing", items);
+  EXPECT_TRUE(items.IsEmpty());
+}
+
+TEST_F(TestVideoDatabase, SearchFollowsChanges)
+{
+  int id = AddMovie("Alpha", { "Action" }, {});
+  m_db.UpdateMovieTitle(id, "Omega");
+
+  CFileItemList items;
+  m_db.GetMoviesByName("alp", items);
+  EXPECT_TRUE(items.IsEmpty());
+  m_db.GetMoviesByName("ome", items);
+  EXPECT_EQ(std::vector<std::string>({ "Omega" }), Labels(items));
+
+  m_db.DeleteMovie(id);
+  items.Clear();
+  m_db.GetMoviesByName("ome", items);
+  EXPECT_TRUE(items.IsEmpty());
+}
+
+TEST_F(TestVideoDatabase, SearchCastAndDirectors)
+{
+  // directors are kept in the actor table, so they share its index
+  CVideoInfoTag details;
+  details.m_strTitle = "The Dark Knight";
+  details.m_director = { "Christopher Nolan" };
+  SActorInfo actor;
+  actor.strName = "Heath Ledger";
+  details.m_cast.push_back(actor);
+  ASSERT_GT(m_db.SetDetailsForMovie(MoviePath(details.m_strTitle), details, std::map<std::string, std::string>()), 0);
+
+  CFileItemList items;
+  m_db.GetMovieDirectorsByName("nol", items);
+  EXPECT_EQ(std::vector<std::string>({ "Christopher Nolan" }), Labels(items));
+
+  items.Clear();
+  m_db.GetMovieDirectorsByName("olan", items);
+  EXPECT_EQ(std::vector<std::string>({ "Christopher Nolan" }), Labels(items));
+
+  items.Clear();
+  m_db.GetMovieActorsByName("heath led", items);
+  EXPECT_EQ(std::vector<std::string>({ "Heath Ledger" }), Labels(items));
+
+  // the director isn't in the cast
+  items.Clear();
+  m_db.GetMovieActorsByName("nol", items);
+  EXPECT_TRUE(items.IsEmpty());
+}
+
+TEST_F(TestVideoDatabase, PathFingerprint)
+{
+  int64_t time = 0;
+  std::vector<std::string> subPaths;
+  std::string hash;
+  EXPECT_FALSE(m_db.GetPathFingerprint("/videos/Show/", time, subPaths, hash));
+
+  ASSERT_TRUE(m_db.SetPathFingerprint("/videos/Show/", 1496347200, { "/videos/Show/Season 1/", "/videos/Show/Season 2/" }, "abc"));
+  ASSERT_TRUE(m_db.GetPathFingerprint("/videos/Show/", time, subPaths, hash));
+  EXPECT_EQ(1496347200, time);
+  EXPECT_EQ(std::vector<std::string>({ "/videos/Show/Season 1/", "/videos/Show/Season 2/" }), subPaths);
+  EXPECT_EQ("abc", hash);
+
+  // an update replaces the stored fingerprint
+  ASSERT_TRUE(m_db.SetPathFingerprint("/videos/Show/", 1496350800, {}, "def"));
+  ASSERT_TRUE(m_db.GetPathFingerprint("/videos/Show/", time, subPaths, hash));
+  EXPECT_EQ(1496350800, time);
+  EXPECT_TRUE(subPaths.empty());
+  EXPECT_EQ("def", hash);
+  EXPECT_EQ("1", m_db.GetSingleValue("SELECT COUNT(*) FROM pathfingerprint"));
+}
+
+TEST_F(TestVideoDatabase, RemovePathFingerprints)
+{
+  for (const std::string path : { "/videos/Show/", "/videos/Show/Season 1/", "/videos/Show/Season 1/Extras/",
+                                  "/videos/Show/Season 10/" })
+    ASSERT_TRUE(m_db.SetPathFingerprint(path, 1496347200, {}, "abc"));
+
+  // removes the folder with its subfolders, but not folders that merely start with the same name
+  ASSERT_TRUE(m_db.RemovePathFingerprints("/videos/Show/Season 1/"));
+
+  int64_t time = 0;
+  std::vector<std::string> subPaths;
+  std::string hash;
+  EXPECT_TRUE(m_db.GetPathFingerprint("/videos/Show/", time, subPaths, hash));
+  EXPECT_FALSE(m_db.GetPathFingerprint("/videos/Show/Season 1/", time, subPaths, hash));
+  EXPECT_FALSE(m_db.GetPathFingerprint("/videos/Show/Season 1/Extras/", time, subPaths, hash));
+  EXPECT_TRUE(m_db.GetPathFingerprint("/videos/Show/Season 10/", time, subPaths, hash));
+}
+
+TEST_F(TestVideoDatabase, CleanDatabaseRemovesOrphanedFingerprints)
+{
+  ASSERT_GT(AddTvShow("Show", { "Drama" }), 0);
+  // cleaning stops early without any files in the library
+  ASSERT_GT(AddMovie("Alpha", { "Action" }, {}), 0);
+
+  for (const std::string path : { "/videos/Show/", "/videos/Show/Season 1/", "/videos/Gone/", "/videos/Gone/Season 1/" })
+    ASSERT_TRUE(m_db.SetPathFingerprint(path, 1496347200, {}, "abc"));
+
+  m_db.CleanDatabase(nullptr, std::set<int>(), false);
+
+  int64_t time = 0;
+  std::vector<std::string> subPaths;
+  std::string hash;
+  EXPECT_TRUE(m_db.GetPathFingerprint("/videos/Show/", time, subPaths, hash));
+  EXPECT_TRUE(m_db.GetPathFingerprint("/videos/Show/Season 1/", time, subPaths, hash));
+  EXPECT_FALSE(m_db.GetPathFingerprint("/videos/Gone/", time, subPaths, hash));
+  EXPECT_FALSE(m_db.GetPathFingerprint("/videos/Gone/Season 1/", time, subPaths, hash));
+}
@@ -34,6 +34,7 @@
 #include "GUIInfoManager.h"
 #include "utils/Variant.h"
 #include "utils/StringUtils.h"
+#include "windowing/WindowingFactory.h"
 
 #ifdef TARGET_POSIX
 #include "linux/XMemUtils.h"
@@ -121,6 +122,9 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
                                 CSpecialProtocol::TranslatePath("special://logpath").c_str(), lcAppName.c_str(),
                                 stat.ullAvailPhys/1024, stat.ullTotalPhys/1024, g_infoManager.GetFPS(),
                                 strCores.c_str(), ucAppName.c_str(), dCPU, profiling.c_str());
+#endif
+#if defined(HAS_GL) || defined(HAS_GLES)
+    info += StringUtils::Format("\nDRAW: %u calls per frame", g_Windowing.GetDrawCalls());
 #endif
   }
 